@@ -19,7 +19,7 @@
 
 
 # = Gems
-require 'k_means'
+require 'k_means'    # Centroid objects handed to the rest of the pipeline
 
 # = Local
 $:.push('.')
@@ -36,12 +36,14 @@ class Clustering # {{{
     @options      = options
     @mathematics  = Mathematics.new
 
-    @algorithms   = %w[kmeans]
+    @algorithms   = %w[kmeans minibatch]
   end # of def initialize }}}
 
 
   # @fn       def kmeans data, centroids = 8, centroids_information = nil # {{{
   # @brief    Kmeans function takes input data and desired amount of centroids and calculates k-means
+  #           (native, see cluster). The result is turned into the frame => cluster Hash and
+  #           Centroid objects the rest of the pipeline expects.
   #
   # @param    [Array]     data                     Array filled with subarrays of the form [ [x,y,z], [x,y,z]...]
   # @param    [Integer]   centroids                Number of clusters (k-means model) to fit
@@ -50,86 +52,293 @@ class Clustering # {{{
 
     raise ArgumentError, "Data should be of shape [ [x,y,z],...]" if( (data.length == 3) and not (data.first.length == 3 ) )
 
-    if( centroids_information.nil? )
-      km_tmp      = KMeans.new(data, :centroids => centroids)
-    else
-      cen         = []
-
-      # Either keep centroid objects or turn the input centroid arrays into centroid objects
-      centroids_information.each do |c|
-        if( c.is_a?( Centroid ) )
-          cen << c
-        else
-          cen << Centroid.new( c )
-        end
-      end
+    # Either take the positions of centroid objects or the centroid arrays as they are
+    initial               = centroids_information.collect { |c| ( c.is_a?( Centroid ) ) ? ( c.position ) : ( c ) } unless( centroids_information.nil? )
+
+    labels, positions     = cluster( data, centroids, initial )
+
+    return [ labels_to_clusters( labels ), positions.collect { |p| Centroid.new( p ) } ]
+  end # }}}
+
+
+  # @fn       def kmeans_native data, k, initial = nil, iterations = 300, seed = 0 # {{{
+  # @brief    Lloyd k-means over a dense n x d buffer (c/utils/c_kmeans.c), using triangle inequality
+  #           bounds to skip most of the point to centroid distances.
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...] (or n x d)
+  # @param    [Integer]   k             Number of clusters (k-means model) to fit
+  # @param    [Array]     initial       Array, containing the k start positions [x,y,z], k-means++ if nil
+  # @param    [Integer]   iterations    Maximum number of Lloyd iterations
+  # @param    [Integer]   seed          Seed of the k-means++ start (same as restart 0 of kmeans_restarts)
+  #
+  # @returns  [Array]                   [ labels, centroids, distances ] - cluster index of every point,
+  #                                     centroid positions [ [x,y,z], ... ] and distance of every point to its centroid
+  def kmeans_native data, k, initial = nil, iterations = 300, seed = 0
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "K should be an Integer between 1 and #{data.length.to_s}, but is (#{k.to_s})" unless( k.is_a?( Integer ) and k >= 1 and k <= data.length )
+    raise ArgumentError, "Initial centroids should be an Array of #{k.to_s} positions" unless( initial.nil? or ( initial.is_a?( Array ) and initial.length == k ) )
+    # }}}
+
+    n, d        = data.length, data.first.length
+
+    points      = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+    positions   = ( initial.nil? ) ? ( "\0" * ( 8 * k * d ) ) : ( initial.flatten.collect { |v| v.to_f }.pack( "d*" ) )
+    labels      = "\0" * ( 8 * n )
+    distances   = "\0" * ( 8 * n )
 
-      puts "before kmeans"
-      km_tmp      = KMeans.new(data, :centroids => centroids, :custom_centroids => cen )
-      puts "after kmeans"
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
+    raise ArgumentError, "Initial centroids should hold #{k.to_s} x #{d.to_s} values" unless( positions.bytesize == 8 * k * d )
+
+    if( initial.nil? )
+      seeded    = C_mathematics.c_kmeans_seed( points, n, d, k, seed.to_i, 0, positions )
+      raise ArgumentError, "K-Means++ seeding failed (#{seeded.to_s})" unless( seeded == k * d )
     end
 
-    centroids   = km_tmp.centroids
-    km          = eval( km_tmp.inspect.to_s )
+    result      = C_mathematics.c_kmeans( points, n, d, k, iterations, positions, labels, distances )
+    raise ArgumentError, "K-Means could not be calculated (#{result.to_s})" if( result < 0 )
 
-    clusters    = Hash.new
+    [ labels.unpack( "d*" ).collect { |l| l.to_i }, positions.unpack( "d*" ).each_slice( d ).to_a, distances.unpack( "d*" ) ]
+  end # of def kmeans_native }}}
 
-    km.each_with_index do |cluster_array, cluster_index|
-      cluster_array.each do |frame|
-        clusters[ frame ] = cluster_index
-      end
+
+  # @fn       def labels_to_clusters labels # {{{
+  # @brief    Turns dense labels into the frame => cluster Hash used by get_dot_graph, the plots and
+  #           PoseVisualizer
+  #
+  # @param    [Array]     labels        Cluster index of every frame
+  #
+  # @returns  [Hash]                    Key frame, value cluster index
+  def labels_to_clusters labels
+
+    clusters  = Hash.new
+    labels.each_with_index { |cluster_index, frame| clusters[ frame ] = cluster_index }
+
+    clusters
+  end # of def labels_to_clusters }}}
+
+
+  # @fn       def kmeans_restarts data, k, restarts, threads = 4, seed = 0, iterations = 300 # {{{
+  # @brief    Runs many k-means with k-means++ seeding in parallel (c/utils/c_kmeans_restarts.c) and
+  #           returns the centroids of the run with the lowest distortion (sum of squared distances).
+  #           Runs which are not expected to beat the best one are abandoned early (a heuristic, an
+  #           abandoned run could still have won). Every restart is seeded from
+  #           ( seed, restart index ), the result does not depend on the number of threads.
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...] (or n x d)
+  # @param    [Integer]   k             Number of clusters (k-means model) to fit
+  # @param    [Integer]   restarts      Number of restarts
+  # @param    [Integer]   threads       Number of worker threads
+  # @param    [Integer]   seed          Seed of the whole run
+  # @param    [Integer]   iterations    Maximum number of Lloyd iterations per restart
+  #
+  # @returns  [Array]                   [ centroids, distortions, best ] - centroid positions [ [x,y,z], ... ] of the
+  #                                     best restart, distortion of every restart (Infinity if abandoned), index of the best
+  def kmeans_restarts data, k, restarts, threads = 4, seed = 0, iterations = 300
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "K should be an Integer between 1 and #{data.length.to_s}, but is (#{k.to_s})" unless( k.is_a?( Integer ) and k >= 1 and k <= data.length )
+    raise ArgumentError, "Restarts should be a positive Integer, but is (#{restarts.to_s})" unless( restarts.is_a?( Integer ) and restarts >= 1 )
+    # }}}
+
+    n, d          = data.length, data.first.length
+    points        = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+    centroids     = "\0" * ( 8 * k * d )
+    distortions   = "\0" * ( 8 * restarts )
+
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
+
+    best          = C_mathematics.c_kmeans_restarts( points, n, d, k, restarts, iterations, threads.to_i, seed.to_i, centroids, distortions )
+    raise ArgumentError, "K-Means restarts could not be calculated (#{best.to_s})" if( best < 0 )
+
+    [ centroids.unpack( "d*" ).each_slice( d ).to_a, distortions.unpack( "d*" ), best ]
+  end # of def kmeans_restarts }}}
+
+
+  # @fn       def kmeans_seeded points, n, d, k, restart, seed = 0, iterations = 300 # {{{
+  # @brief    One k-means++ seeded k-means run on an already packed corpus (used by the worker pool,
+  #           the corpus is packed once and shared). The start is seeded from ( seed, restart ), the
+  #           same as restart of kmeans_restarts.
+  #
+  # @param    [String]    points        Packed ( "d*" ) n x d points
+  # @param    [Integer]   n             Number of points
+  # @param    [Integer]   d             Dimensions of every point
+  # @param    [Integer]   k             Number of clusters (k-means model) to fit
+  # @param    [Integer]   restart       Restart index
+  # @param    [Integer]   seed          Seed of the whole run
+  # @param    [Integer]   iterations    Maximum number of Lloyd iterations
+  #
+  # @returns  [Array]                   [ labels, centroids, distortion ] - labels packed as int32 ( "l*" ), centroids
+  #                                     packed as doubles ( "d*", k x d ), distortion is the sum of the squared
+  #                                     distances (the same measure as kmeans_restarts)
+  def kmeans_seeded points, n, d, k, restart, seed = 0, iterations = 300
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Points should be a packed String of #{n.to_s} x #{d.to_s} doubles" unless( points.is_a?( String ) and points.bytesize == 8 * n * d )
+    raise ArgumentError, "K should be an Integer between 1 and #{n.to_s}, but is (#{k.to_s})" unless( k.is_a?( Integer ) and k >= 1 and k <= n )
+    # }}}
+
+    centroids   = "\0" * ( 8 * k * d )
+    labels      = "\0" * ( 8 * n )
+    distances   = "\0" * ( 8 * n )
+    distortion  = "\0" * 8
+
+    result      = C_mathematics.c_kmeans_seed( points, n, d, k, seed.to_i, restart.to_i, centroids )
+    raise ArgumentError, "K-Means++ seeding failed (#{result.to_s})" unless( result == k * d )
+
+    # never abandoned ( -1.0 ), distortion is the sum of squared distances as in kmeans_restarts
+    result      = C_mathematics.c_kmeans_bounded( points, n, d, k, iterations, -1.0, centroids, labels, distances, distortion )
+    raise ArgumentError, "K-Means could not be calculated (#{result.to_s})" if( result < 0 )
+
+    [ labels.unpack( "d*" ).collect { |l| l.to_i }.pack( "l*" ), centroids, distortion.unpack( "d" ).first ]
+  end # of def kmeans_seeded }}}
+
+
+  # @fn       def kmeans_minibatch data, k, batch = 1024, tolerance = 0.001, seed = 0, iterations = 1000, initial = nil # {{{
+  # @brief    Mini-batch k-means (c/utils/c_kmeans_minibatch.c) for corpus sized data, e.g. all
+  #           speeds and cycles of a domain. Every iteration only looks at a random batch of points
+  #           and moves the centroids with per centroid learning rates. Start centroids are
+  #           k-means++ seeded on a sample of the data.
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...] (or n x d)
+  # @param    [Integer]   k             Number of clusters (k-means model) to fit
+  # @param    [Integer]   batch         Points per mini-batch
+  # @param    [Float]     tolerance     Largest centroid movement per iteration which counts as converged
+  # @param    [Integer]   seed          Seed of the initialization and the batch sampling
+  # @param    [Integer]   iterations    Maximum number of mini-batches
+  # @param    [Array]     initial       Array, containing the k start positions [x,y,z], k-means++ if nil
+  #
+  # @returns  [Array]                   [ labels, centroids, distances ] (see kmeans_native)
+  def kmeans_minibatch data, k, batch = 1024, tolerance = 0.001, seed = 0, iterations = 1000, initial = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "K should be an Integer between 1 and #{data.length.to_s}, but is (#{k.to_s})" unless( k.is_a?( Integer ) and k >= 1 and k <= data.length )
+    raise ArgumentError, "Batch size should be a positive Integer, but is (#{batch.to_s})" unless( batch.is_a?( Integer ) and batch >= 1 )
+    raise ArgumentError, "Initial centroids should be an Array of #{k.to_s} positions" unless( initial.nil? or ( initial.is_a?( Array ) and initial.length == k ) )
+    # }}}
+
+    n, d          = data.length, data.first.length
+    points        = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
+
+    if( initial.nil? )
+      random      = Random.new( seed )
+      sample      = Array.new( [ n, [ batch, 10 * k ].max ].min ) { data[ random.rand( n ) ] }
+      sample     += data.first( k - sample.length ) if( sample.length < k )
+      rows        = sample.length
+      sample      = sample.flatten.collect { |v| v.to_f }.pack( "d*" )
+      positions   = "\0" * ( 8 * k * d )
+      raise ArgumentError, "Sample should hold #{rows.to_s} x #{d.to_s} values" unless( sample.bytesize == 8 * rows * d )
+      seeded      = C_mathematics.c_kmeans_seed( sample, rows, d, k, seed.to_i, 0, positions )
+      raise ArgumentError, "K-Means++ seeding failed (#{seeded.to_s})" unless( seeded == k * d )
+    else
+      positions   = initial.flatten.collect { |v| v.to_f }.pack( "d*" )
+      raise ArgumentError, "Initial centroids should hold #{k.to_s} x #{d.to_s} values" unless( positions.bytesize == 8 * k * d )
     end
 
-    return [ clusters, centroids ]
-  end # }}}
+    labels        = "\0" * ( 8 * n )
+    distances     = "\0" * ( 8 * n )
+
+    result        = C_mathematics.c_kmeans_minibatch( points, n, d, k, batch, iterations, tolerance.to_f, seed.to_i, positions, labels, distances )
+    raise ArgumentError, "Mini-batch K-Means could not be calculated (#{result.to_s})" if( result < 0 )
+
+    [ labels.unpack( "d*" ).collect { |l| l.to_i }, positions.unpack( "d*" ).each_slice( d ).to_a, distances.unpack( "d*" ) ]
+  end # of def kmeans_minibatch }}}
 
 
-  # @fn       def cluster_distances data = nil, kmeans = nil, centroids = nil # {{{
-  # @brief    Calculates the cluster distances from all clusters to each other.
+  # @fn       def cluster data, k, initial = nil # {{{
+  # @brief    Runs the clustering algorithm chosen via -g ( @options.clustering_algorithm ) once
   #
-  # @param    []    data          
-  # @param    []    kmeans        
-  # @param    []    centroids     
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...]
+  # @param    [Integer]   k             Number of clusters (k-means model) to fit
+  # @param    [Array]     initial       Array, containing the k start positions [x,y,z] or nil
   #
-  def cluster_distances data = nil, kmeans = nil, centroids = nil 
+  # @returns  [Array]                   [ labels, centroids, distances ] (see kmeans_native)
+  def cluster data, k, initial = nil
 
-    # turn the kmeans result from frames => cluster to cluster => frames
-    table = Hash.new
-    kmeans.each_pair do |f,c| 
-      table[ c.to_s ] = [] if( table[ c.to_s ].nil? )
-      table[ c.to_s ] << f
+    if( not @options.nil? and @options.clustering_algorithm == "minibatch" )
+      kmeans_minibatch( data, k, @options.minibatch_size.to_i, @options.minibatch_tolerance.to_f, @options.clustering_seed.to_i, 1000, initial )
+    else
+      kmeans_native( data, k, initial, 300, ( @options.nil? ) ? ( 0 ) : ( @options.clustering_seed.to_i ) )
     end
+  end # of def cluster }}}
 
-    puts "Calculating cluster distances"
 
-    distances = Hash.new # key == cluster id  value == array with each index being the distance of all cluster points to all other cluster points. Index of array is other clusters
-    table.each_pair do |cluster, frames|
+  # @fn       def kmeans_search data, from, to, threads = 4, seed = 0, iterations = 300 # {{{
+  # @brief    Elbow curve of k-means for every k in [ from, to ] (c/utils/c_kmeans_search.c). The range
+  #           runs in parallel chains, within a chain k + 1 is warm started from the centroids of k
+  #           by splitting the worst cluster. Distortion, squared error distortion and TCSS come out of
+  #           the same pass as the assignment (same definitions as distortions,
+  #           squared_error_distortion and total_within_cluster_sum_of_squares).
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...] (or n x d)
+  # @param    [Integer]   from          Smallest k
+  # @param    [Integer]   to            Largest k
+  # @param    [Integer]   threads       Number of worker threads
+  # @param    [Integer]   seed          Seed of the k-means++ start of every chain
+  # @param    [Integer]   iterations    Maximum number of Lloyd iterations per k
+  #
+  # @returns  [Array]                   [ ks, distortions, squared_error_distortions, tcss, labels ] - tcss holds
+  #                                     one Array (index == cluster id) per k, labels are the cluster index of every point for k = to
+  def kmeans_search data, from, to, threads = 4, seed = 0, iterations = 300
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "K range should be 1 <= from <= to <= #{data.length.to_s}, but is (#{from.to_s}, #{to.to_s})" unless( from.is_a?( Integer ) and to.is_a?( Integer ) and from >= 1 and from <= to and to <= data.length )
+    # }}}
+
+    n, d          = data.length, data.first.length
+    ks            = ( from..to ).to_a
+    curve         = "\0" * ( 8 * 2 * ks.length )
+    tcss          = "\0" * ( 8 * ks.inject( 0 ) { |sum, k| sum + k } )
+    labels        = "\0" * ( 8 * n )
+    points        = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
 
-      values = []
-      # Iterate for each clusters over all other clusters, skip if self to caluclate the distances array
-      table.each_pair do |c, f|
-        if( cluster == c ) # skip if outer cluster id == inner cluster id
-          values[ c.to_i ] = 0.0
-          next
-        end
+    result        = C_mathematics.c_kmeans_search( points, n, d, from, to, iterations, threads.to_i, seed.to_i, curve, tcss, labels )
+    raise ArgumentError, "K-Means search could not be calculated (#{result.to_s})" unless( result == ks.length )
 
-        values[ c.to_i ] = 0
+    distortions, squared  = curve.unpack( "d*" ).each_slice( 2 ).to_a.transpose
+    within                = tcss.unpack( "d*" )
+    within                = ks.collect { |k| within.shift( k ) }
 
-        # Calculate the distances of all points in frames (cluster) to all points in f (c)
-        # for each of the outer frames go over each of the inner frames
-        # store calcuated distances in values array
+    [ ks, distortions, squared, within, labels.unpack( "d*" ).collect { |l| l.to_i } ]
+  end # of def kmeans_search }}}
 
-        frames.each do |i| 
-          f.each do |j|
-            values[ c.to_i ] += @mathematics.eucledian_distance( data[ i ], data[ j ] )
-          end
-        end
 
-      end # of table.each_pair
+  # @fn       def cluster_distances data = nil, kmeans = nil, centroids = nil, squared = false # {{{
+  # @brief    Calculates the cluster distances from all clusters to each other (summed distances of
+  #           all points of one cluster to all points of the other, see inter_cluster_distances).
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...]
+  # @param    [Hash]      kmeans        Key frame, value cluster index (see kmeans)
+  # @param    [Array]     centroids     Centroid objects or positions, only their number is used
+  # @param    [Boolean]   squared       Sum squared distances instead (exact, from cluster moments)
+  #
+  # @returns  [Hash]                    Key cluster id (String), value Array with the summed distance to every cluster (index == cluster id)
+  def cluster_distances data = nil, kmeans = nil, centroids = nil, squared = false
 
-      distances[ cluster ] = values 
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"     if( data.nil? )
+    raise ArgumentError, "Kmeans cannot be nil"   if( kmeans.nil? )
+    # }}}
 
-    end # of table.each_pair 
+    puts "Calculating cluster distances"
+
+    labels          = Array.new( data.length, 0 )
+    kmeans.each_pair { |f, c| labels[ f ] = c }
+
+    k               = [ ( centroids.nil? ) ? ( 0 ) : ( centroids.length ), labels.max + 1 ].max
+    sums, means     = inter_cluster_distances( data, labels, k, squared, ( @options.nil? ) ? ( 4 ) : ( @options.cpus.to_i ) )
+
+    # key == cluster id  value == array with each index being the distance of all cluster points to all other cluster points. Index of array is other clusters
+    distances       = Hash.new
+    kmeans.values.uniq.sort.each { |cluster| distances[ cluster.to_s ] = sums[ cluster ] }
 
     puts "Finished cluster distances"
 
@@ -137,10 +346,45 @@ class Clustering # {{{
   end # of def cluster_distances # }}}
 
 
+  # @fn       def inter_cluster_distances data, labels, k, squared = false, threads = 4 # {{{
+  # @brief    k x k matrices of the summed and mean distances between all point pairs of two clusters
+  #           (c/utils/c_cluster_distances.c). The Euclidean mode is a cache blocked pairwise sweep
+  #           on a thread pool, the squared mode is exact from per cluster means and scatters in O(n).
+  #
+  # @param    [Array]     data          Array filled with subarrays of the form [ [x,y,z], [x,y,z]...] (or n x d)
+  # @param    [Array]     labels        Cluster index of every point
+  # @param    [Integer]   k             Number of clusters
+  # @param    [Boolean]   squared       Squared Euclidean distances instead of Euclidean distances
+  # @param    [Integer]   threads       Number of worker threads (Euclidean mode only)
+  #
+  # @returns  [Array]                   [ sums, means ] - each k subarrays of k values, the diagonal is zero
+  def inter_cluster_distances data, labels, k, squared = false, threads = 4
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "Labels should be an Array with one cluster index per point" unless( labels.is_a?( Array ) and labels.length == data.length )
+    raise ArgumentError, "K should be an Integer larger than every label, but is (#{k.to_s})" unless( k.is_a?( Integer ) and k >= 1 and labels.max < k )
+    # }}}
+
+    n, d          = data.length, data.first.length
+    points        = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+    packed        = labels.collect { |l| l.to_f }.pack( "d*" )
+    sums          = "\0" * ( 8 * k * k )
+    means         = "\0" * ( 8 * k * k )
+
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
+
+    result        = ( squared ) ? ( C_mathematics.c_cluster_distances_squared( points, n, d, packed, k, sums, means ) ) : ( C_mathematics.c_cluster_distances( points, n, d, packed, k, threads.to_i, sums, means ) )
+    raise ArgumentError, "Inter cluster distances could not be calculated (#{result.to_s})" unless( result == k )
+
+    [ sums.unpack( "d*" ).each_slice( k ).to_a, means.unpack( "d*" ).each_slice( k ).to_a ]
+  end # of def inter_cluster_distances }}}
+
+
   # @fn       def distances data, centroids # {{{
   # @brief    Euclidean distance from each point to each cluster centroid
   # @param    [Arrau]       data        Array, containing subarrays of the shape [x,y,z] t-data points.
-  # @param    [Array]       centroids   Array, containing subarrays of centroid [x,y,z] data
+  # @param    [Array]       centroids   Array, containing Centroid objects or subarrays of centroid [x,y,z] data
   #
   # @returns  [Hash]        Each Key being the data index and value containing an array which is [ centroid id , eucledian distance ]
   def distances data = nil, centroids = nil
@@ -152,22 +396,62 @@ class Clustering # {{{
 
     dists                 = Hash.new
 
-    centroids.each_with_index do |c, cindex|
-      # cx, cy, cz = c.position # cluster centroid postion
+    # distance matrix of all data points to all centroid postions in one batch
+    matrix                = @mathematics.eucledian_distances_to_centroids( data, centroids.collect { |c| ( c.is_a?( Centroid ) ) ? ( c.position ) : ( c ) } )
 
-      data.each_with_index do |d, dindex|
-        ed                = @mathematics.eucledian_distance( c.position, d )  # distance of centroid and data point
-
-        #           centroid_id, data index, eucleadian distance
-        dists[ dindex ]   = [] if( dists[ dindex ].nil? )
-        dists[ dindex ]  << [ cindex, ed ]
-      end # of data.each
-    end # of centroids.each_
+    matrix.each_with_index do |row, dindex|
+      #           centroid_id, data index, eucleadian distance
+      dists[ dindex ]     = []
+      row.each_with_index { |ed, cindex| dists[ dindex ] << [ cindex, ed ] }
+    end # of matrix.each_with_index
 
     return dists
   end # of def distances data, centroids # }}}
 
 
+  # @fn       def score data, centroids # {{{
+  # @brief    Assigns every point to its closest centroid and scores the model in one native sweep
+  #           (c/utils/c_kmeans_score.c), instead of building the distances Hash and walking it again
+  #           for closest_centroids, distortions, squared_error_distortion and
+  #           total_within_cluster_sum_of_squares.
+  #
+  # @param    [Array]       data        Array, containing subarrays of the shape [x,y,z] t-data points.
+  # @param    [Array]       centroids   Array, containing Centroid objects or subarrays of centroid [x,y,z] data
+  #
+  # @returns  [Array]       [ labels, distances, tcss, closest_frames, closest_distances, distortion, squared_error_distortion ]
+  #                         labels and distances per point (closest_centroids is labels.zip( distances )), tcss per
+  #                         cluster, closest_frames / closest_distances give the frame closest to each centroid
+  def score data = nil, centroids = nil
+
+    # Input verification {{{
+    raise ArgumentError, "Data should be a non empty Array of the form [ [x,y,z],...]" unless( data.is_a?( Array ) and not data.empty? and data.first.is_a?( Array ) )
+    raise ArgumentError, "Centroids should be a non empty Array" unless( centroids.is_a?( Array ) and not centroids.empty? )
+    # }}}
+
+    positions             = centroids.collect { |c| ( c.is_a?( Centroid ) ) ? ( c.position ) : ( c ) }
+    n, d, k               = data.length, data.first.length, positions.length
+
+    labels                = "\0" * ( 8 * n )
+    distances             = "\0" * ( 8 * n )
+    tcss                  = "\0" * ( 8 * k )
+    closest_frames        = "\0" * ( 8 * k )
+    closest_distances     = "\0" * ( 8 * k )
+    totals                = "\0" * ( 8 * 2 )
+    points                = data.flatten.collect { |v| v.to_f }.pack( "d*" )
+    packed                = positions.flatten.collect { |v| v.to_f }.pack( "d*" )
+
+    raise ArgumentError, "Data should hold #{n.to_s} x #{d.to_s} values, some rows have not #{d.to_s} values" unless( points.bytesize == 8 * n * d )
+    raise ArgumentError, "Centroids should hold #{k.to_s} x #{d.to_s} values" unless( packed.bytesize == 8 * k * d )
+
+    result                = C_mathematics.c_kmeans_score( points, n, d, packed, k, labels, distances, tcss, closest_frames, closest_distances, totals )
+    raise ArgumentError, "K-Means score could not be calculated (#{result.to_s})" unless( result == k )
+
+    distortion, squared   = totals.unpack( "d*" )
+
+    [ labels.unpack( "d*" ).collect { |l| l.to_i }, distances.unpack( "d*" ), tcss.unpack( "d*" ), closest_frames.unpack( "d*" ).collect { |f| f.to_i }, closest_distances.unpack( "d*" ), distortion, squared ]
+  end # of def score }}}
+
+
   # @fn       def centroids_to_frames( closest_centroids ) # {{{
   # @brief    The function takes the output from the closest_centroids function and calculates,
   #           which frames are the closest frames to each individual centroids. This allows us to
@@ -191,9 +475,9 @@ class Clustering # {{{
 
 
   # @fn       def closest_centroids dists, centroids, data # {{{
-  # @brief    Find closest centroid to each point, and the corresponding distance
+  # @brief    Find closest centroid to each point, and the corresponding distance (see score)
   #
-  # @param    [Hash]        dists       Each Key being the data index and value containing an array which is [ centroid id , eucledian distance ]
+  # @param    [Hash]        dists       Not needed anymore (the assignment is fused into score), kept for the callers
   # @param    [Array]       centroids   Array, containing subarrays of centroid [x,y,z] data
   # @param    [Arrau]       data        Array, containing subarrays of the shape [x,y,z] t-data points.
   #
@@ -201,38 +485,13 @@ class Clustering # {{{
   def closest_centroids dists = nil, centroids = nil, data = nil
 
     # Input verification {{{
-    raise ArgumentError, "Dists cannot be nil"        if( dists.nil? )
     raise ArgumentError, "Centroids cannoid be nil"   if( centroids.nil? )
     raise ArgumentError, "Data cannot be nil"         if( data.nil? )
     # }}}
 
-    # dists -> subarray of [ centroid id, data index, eucledian distance ]
-    closest = []    # index here is the same as for data
-
-    # go through entire data set and find closest centroid and distance
-    0.upto(data.length - 1).each do |i|
-      tmp_i, tmp_cindex, tmp_ed = nil, nil, nil
-
-      dists[ i ].each do |cindex, ed| # centroid id, eucledian distance
-
-        # Make sure that tmp vars have some initial value
-        tmp_i       = i       if( tmp_i.nil? )
-        tmp_cindex  = cindex  if( tmp_cindex.nil? )
-        tmp_ed      = ed      if( tmp_ed.nil? )
-
-        # Make sure we update if value is smaller than prev
-        if( ed < tmp_ed )
-          tmp_i       = i
-          tmp_cindex  = cindex
-          tmp_ed      = ed
-        end # of if( ed <= ..
-
-      end # of dists[i].each..
-
-      closest << [ tmp_cindex, tmp_ed ]
-    end # of 0.upto(data.length..
+    labels, distances = score( data, centroids )
 
-    return closest
+    return labels.zip( distances )
   end # of def closest_centroids }}}
 
 
@@ -136,18 +136,16 @@ class Compare
       remaining_keys.each do |remaining_cycle|
         second_centroids = centroids[ remaining_cycle ]
 
-        # compare the first_centroids to the remaining centroids
-        first_centroids.each_with_index do |f_centroid, f_index|
-          # iterate for each of first centroids over all of second centroids
-           tmp_distances = []
-          second_centroids.each_with_index do |s_centroid, s_index|
-            value = @mathematics.eucledian_distance( f_centroid, s_centroid )
-            puts "First Centroid (index: #{f_index.to_s}) (coord: #{f_centroid.join(", ").to_s}) - Second Centroid (index: #{s_index.to_s}) (coord: #{s_centroid.join(", ").to_s}) - Eucledian distance: #{value.to_s}"
-            tmp_distances[ s_index.to_i ] = value
-          end # of second_centroids.each_with_index
+        # compare the first_centroids to the remaining centroids, closest second centroid of all
+        # first centroids in one batched KD-tree query
+        tree                       = @mathematics.kdtree( second_centroids )
+        nearest, nearest_distances = @mathematics.kdtree_nearest( tree, first_centroids, 1 )
 
+        first_centroids.each_with_index do |f_centroid, f_index|
           f_cluster_index = f_index
-          s_cluster_index = tmp_distances.index( tmp_distances.min )
+          s_cluster_index = nearest[ f_index ].first
+
+          puts "First Centroid (index: #{f_index.to_s}) (coord: #{f_centroid.join(", ").to_s}) - Closest Second Centroid (index: #{s_cluster_index.to_s}) (coord: #{second_centroids[ s_cluster_index ].join(", ").to_s}) - Eucledian distance: #{nearest_distances[ f_index ].first.to_s}"
 
           hash_key_name   = "#{cycle.to_s + "_->_" + remaining_cycle.to_s}"
           mapping[ hash_key_name ] = [] if( mapping[ hash_key_name ].nil? )
@@ -160,32 +158,15 @@ class Compare
       break
     end # of centroids.each_pair
 
-    # Distance of centroids to each other
-    distances = []
-    centroids.each_pair do |cycle, first_centroids|
-      first_centroids.each_with_index do |f_centroid, index|
-
-        distances[ index ] = [] if( distances[ index ].nil? )
-
-        first_centroids.each_with_index do |s_centroid, s_index| 
-          value = @mathematics.eucledian_distance( f_centroid, s_centroid )
-          distances[ index ][ s_index ] = value
-        end
-
-      end
-    end
+    # Order of the centroids (of the last cycle) by distance to each other, all neighbours of every
+    # centroid from one KD-tree query
+    last_centroids  = centroids.values.last
+    ordered         = @mathematics.kdtree_nearest( @mathematics.kdtree( last_centroids ), last_centroids, last_centroids.length ).first
 
     scores      = []
 
-    distances.each_with_index do |dists, index|
-      # sort lowest to largest
-
-      indexes   = []
-      sorted    = dists.dup.sort
-      sorted.each_with_index do |v, i|
-        old_index = dists.index( v )
-        indexes[ i ] = old_index
-      end
+    ordered.each_with_index do |indexes, index|
+      # sorted lowest to largest
 
       indexes.each_with_index do |cluster_id, iter_idx|
         scores[ cluster_id.to_i ] = 0 if( scores[ cluster_id.to_i ].nil? )
@@ -336,20 +317,9 @@ class Compare
 #      components = ( ( components_r.concat( components_l ) ).concat( components_e ) ).concat( components_h )
 
 
-    start_frame_distances = []
-    0.upto( f_start_frame_data.length - 1 ) do |i|
-      start_frame_distances << @mathematics.eucledian_distance( f_start_frame_data[i], s_start_frame_data[i] )
-    end
-
-    middle_frame_distances = []
-    0.upto( f_middle_frame_data.length - 1 ) do |i|
-      middle_frame_distances << @mathematics.eucledian_distance( f_middle_frame_data[i], s_middle_frame_data[i] )
-    end
-
-    end_frame_distances = []
-    0.upto( f_end_frame_data.length - 1 ) do |i|
-      end_frame_distances << @mathematics.eucledian_distance( f_end_frame_data[i], s_end_frame_data[i] )
-    end
+    start_frame_distances   = @mathematics.eucledian_distances_pairwise( f_start_frame_data, s_start_frame_data )
+    middle_frame_distances  = @mathematics.eucledian_distances_pairwise( f_middle_frame_data, s_middle_frame_data )
+    end_frame_distances     = @mathematics.eucledian_distances_pairwise( f_end_frame_data, s_end_frame_data )
 
 
     #res << start_frame_distances.sum
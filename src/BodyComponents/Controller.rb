@@ -57,12 +57,16 @@ require_relative 'Plotter.rb'
 require_relative 'PoseVisualizer.rb'
 require_relative 'Logger.rb'
 require_relative 'Compare.rb' 
+require_relative 'VPM_Cache.rb'
 
-# ZMQ
+# K-Means worker pool
 require_relative 'KMeans_Controller.rb'
 require_relative 'KMeans_Worker.rb'
 require_relative 'KMeans_Sink.rb'
 
+# Per configuration pipeline pool (--all)
+require_relative 'Pipeline_Pool.rb'
+
 
 # Change Namespace
 include GSL
@@ -137,6 +141,7 @@ class Controller
 
     @configurations               = Dir[ "#{@config.config_dir}/*.yaml" ].collect { |d| d.gsub( "#{@config.config_dir}/", "" ).gsub( ".yaml", "" ) }
     @sides                        = %w[left right both]
+    @filter_modes                 = %w[polynomial savitzky_golay]
     @body_parts                   = %w[hands fore_arms upper_arms thighs shanks feet]
 
     @clustering                   = Clustering.new( @options )
@@ -200,93 +205,21 @@ class Controller
           turning_data  = []
           @adts         = []
 
-          process.each do |configurations_dir, domain, name, pattern, speed, cycle, filename|
-
-            yaml_var = @fname_table[ filename ]
-            @log.message :success, "Using domain '#{domain}' with process '#{name}' with pattern '#{pattern}', speed '#{speed}' and cycle '#{cycle}' (YAML: '#{yaml_var}')"
-            motion_config             = eval( "@motions.#{domain}.#{name}.#{pattern}.speed_#{speed}.cycle_#{cycle}.yaml_#{yaml_var}" )
-
-            raise ArgumentError, "The configuration and/or the data you requested doesn't exist!" if( motion_config.nil? )
-
-            motion_config_filename    = motion_config.path + "/" + motion_config.filename
-
-            @log.message :debug, "Loading Motion Capture config file (#{motion_config_filename})"
-
-            @motion_config            = read_motion_config( motion_config_filename )
-
-            @file                     = @motion_config.filename
-            @from                     = @motion_config.from
-            @to                       = @motion_config.to
-            @name                     = @motion_config.name
-            @dmps                     = @motion_config.dmp
-
-            @dance_master_poses       = []
-            @dance_master_poses_range = []
-            @dmps.each { |dmp_array| @dance_master_poses << dmp_array.first; @dance_master_poses_range << dmp_array.last }
-
-            @log.message :success, "Loading the Motion Capture data (#{@file}) via the MotionX VPM Plugin"
-            @adt                      = ADT.new( @file )
+          # The configurations are independent until the clustering, with --jobs > 1 they run on a
+          # pool of worker processes (see Pipeline_Pool.rb), the merge below keeps the order of process.
+          # Every configuration writes the same graphs/ plots, so those are only defined for --jobs 1.
+          if( @options.jobs.to_i > 1 and process.length > 1 )
+            results     = Pipeline_Pool.new( @log, @options.jobs.to_i ).map( process ) { |config| process_configuration( *config ) }
+          else
+            results     = process.collect { |config| process_configuration( *config ) }
+          end
 
-            if( @options.filter_motion_capture_data )
-              @log.message :info, "Filter Motion Capture data to smooth out outliers"
-              @filter                 = Filter.new( @options, @from, @to )
-              @adt                    = @filter.filter_motion_capture_data( @adt )
+          process.zip( results ).each do |config, entries|
+            entries.each do |data, adt, meta|
+              turning_data << [ config, data ]
+              @adts << [ adt, turning_data.dup, meta ]
             end
-
-            if( @options.turning_pose_extraction )
-
-              if( @options.each_limb_individually )
-                # This option will cause e.g. --part fore_arms --part upper_arms -> to be processed
-                # separaely to yield separate t-data and will then get added together into one large
-                # array for e.g. clustering. This allows the mixing of all part t-data's.
-                @log.message :info, "All given limbs (--part) will be treated separately for T-Data extraction and summed up."
-
-
-                @given_body_parts = @options.body_parts.dup    # store for later reuse
-                @given_body_parts.each do |part|               # iterate over each limb, reset @options.body_parts to only one limb and calculate
-
-                  @log.message :info, "Calculating T-Data for #{part.to_s}"
-                  @options.body_parts = [ part ]
-
-                  @log.message :info, "Performing CPA-PCA Turning pose extraction"
-                  @turning                = Turning.new( @options, @adt, @dance_master_poses, @dance_master_poses_range, @from, @to )
-                  data                    = @turning.get_data
-
-                  turning_data << [ [ configurations_dir, domain, name, pattern, speed, cycle, filename ], data ]
-
-                  meta = Hash.new
-                  meta[ "total_frames" ]  = @adt.relb.getCoordinates!.length
-                  meta[ "from" ]          = @from
-                  meta[ "to" ]            = @to
-                  meta[ "motion_config" ] = @motion_config
-
-                  @log.message :info, "Summing up T-Data for #{part.to_s}"
-                  @adts << [ @adt, turning_data.dup, meta.dup ]
-
-                end # of given_body_parts.each do |part|
-
-              else # of if( @options.each_limb_individually )
-                @log.message :info, "All given limbs (--part) will get unified together"
-                @log.message :info, "Performing CPA-PCA Turning pose extraction"
-                @turning                = Turning.new( @options, @adt, @dance_master_poses, @dance_master_poses_range, @from, @to )
-                data                    = @turning.get_data
-
-                turning_data << [ [ configurations_dir, domain, name, pattern, speed, cycle, filename ], data ]
-
-                meta = Hash.new
-                meta[ "total_frames" ]  = @adt.relb.getCoordinates!.length
-                meta[ "from" ]          = @from
-                meta[ "to" ]            = @to
-                meta[ "motion_config" ] = @motion_config
-
-                @adts << [ @adt, turning_data.dup, meta.dup ]
-
-              end # of if( @options.each_limb_individually )
-            end # of if( @options.turning_pose_extraction )
-
-            @log.message :success, "Finished processing of #{motion_config_filename.to_s}"
-
-        end # of process.each do |configurations_dir, domain, name, pattern, speed, cycle, filename| 
+          end
 
         final           = []
         turning_data.collect!{ |description, data| data }.each { |array| final.concat( array ) }
@@ -301,22 +234,12 @@ class Controller
         @log.message :info, "We have #{final.length.to_s} data points, rule of thumb says we should use #{Clustering.new.rule_of_thumb_k_estimation(final.length.to_i)} (large overestimation)"
 
         if( @options.clustering_k_search )
-          ( @options.clustering_k_from ).upto( @options.clustering_k_to ) do |k|  # iterate over k's
-
-            @log.message :info, "Performing K-Means for k = #{k.to_s}"
-
-            clustering                  = Clustering.new( @options )
-            kmeans, centroids           = clustering.kmeans( final, k ) # , centroids )
-            kms                        << kmeans
-            distances                   = clustering.distances( final, centroids ) # Hash with   hash[ data index ] =  [ [ centroid_id, eucleadian distance ], ... ] 
-            closest_centroids           = clustering.closest_centroids( distances, centroids, final ) # array with subarrays of each [ centroid_id, distance ]
-            distortions                 = clustering.distortions( closest_centroids )
-            squared_error_distortions   = clustering.squared_error_distortion( closest_centroids )
-            dists << squared_error_distortions
-            ks << k
-            tcss                        << clustering.total_within_cluster_sum_of_squares( closest_centroids )
+          @log.message :info, "Performing K-Means for k = #{@options.clustering_k_from.to_s} .. #{@options.clustering_k_to.to_s}"
 
-          end # of ( @options.clustering_k_from ).upto( @options.clustering_k_to ) do |k|
+          # all k natively in parallel chains, k + 1 warm started from k
+          clustering                          = Clustering.new( @options )
+          ks, distortions, dists, tcss, labels = clustering.kmeans_search( final, @options.clustering_k_from.to_i, @options.clustering_k_to.to_i, @options.cpus.to_i, @options.clustering_seed.to_i )
+          kms                                << clustering.labels_to_clusters( labels )
         else
 
           unless( @options.clustering_k_parameter.nil? )
@@ -324,67 +247,42 @@ class Controller
 
             @log.message :info, "Performing K-Means for k = #{k.to_s}"
 
-            tmp_distortions   = []
-            tmp_centroids     = []
-
-            if( @options.zmq )
-              cpus            = @options.cpus.to_i
-              pids            = []
-
-              @log.message :info, "Spawning workers"
-
-              # Spawn workers
-              (cpus.to_i).times do |i|
-                pids << worker = fork do
-                  KMeans_Worker.new( @options, @log, i, ( @options.clustering_iterations.to_i / cpus.to_i ), @options.clustering_k_parameter.to_i, final )
-                end
-              end
-
-              sleep 1
-
-              # Compute and get results
-              sink = KMeans_Sink.new( @log, cpus.to_i )
-
-              sleep 1
-
-              # Get values we want from sink
-              kms               = sink.kms
-              tmp_distortions   = sink.tmp_distortions
-              tmp_centroids     = sink.tmp_centroids
-
-              # Get rid of the spawned processes
-              pids.each do |worker|
-                 @log.message :info, "Killing worker #pid #{worker.to_s}"
-                 Process.kill( "KILL", worker )
-              end
+            init_centroids    = nil
 
+            if( @options.clustering_algorithm == "minibatch" )
+              # corpus sized data, one mini-batch run over all points instead of restarts
+              @log.message :info, "Mini-batch K-Means (batch size #{@options.minibatch_size.to_s}) - no restarts"
             else
-              # Iterate over kmeans clustering with random initialization to find a better result for
-              # our clustering to avoid local optima
-              (@options.clustering_iterations.to_i).times do |i|
+              tmp_distortions   = []
+              tmp_centroids     = []
 
-                clustering                  = Clustering.new( @options )
-                kmeans, centroids           = clustering.kmeans( final, k ) # , centroids )
-                kms                        << kmeans
-                distances                   = clustering.distances( final, centroids ) # Hash with   hash[ data index ] =  [ [ centroid_id, eucleadian distance ], ... ] 
+              if( @options.worker_pool )
+                # restarts on forked worker processes sharing the packed corpus, binary results
+                pool              = KMeans_Controller.new( @options, @log, final, k, @options.clustering_iterations.to_i, @options.cpus.to_i )
 
-                closest_centroids           = clustering.closest_centroids( distances, centroids, final ) # array with subarrays of each [ centroid_id, distance ]
-                distortions                 = clustering.distortions( closest_centroids )
-                tcss                        = clustering.total_within_cluster_sum_of_squares( closest_centroids )
+                kms               = pool.kms
+                tmp_distortions   = pool.tmp_distortions
+                tmp_centroids     = pool.tmp_centroids
 
-                tmp_distortions << distortions
-                tmp_centroids << centroids
-
-                puts "K-Means iteration #{i.to_s} of #{@options.clustering_iterations.to_s} - Distortion: #{distortions.to_s}"
+              else
+                # Run kmeans clustering many times with k-means++ initialization to find a better result
+                # for our clustering to avoid local optima (native, on all cpus, only the best run's
+                # centroids come back)
+                clustering                          = Clustering.new( @options )
+                centroids, tmp_distortions, best    = clustering.kmeans_restarts( final, k, @options.clustering_iterations.to_i, @options.cpus.to_i, @options.clustering_seed.to_i )
+                tmp_centroids[ best ]               = centroids
+
+                @log.message :info, "K-Means restarts: #{tmp_distortions.count { |d| d.finite? }.to_s} of #{@options.clustering_iterations.to_s} ran to convergence, the others could not beat the best distortion"
               end
-            end
 
 
-            tmp_cent_min = tmp_distortions.min 
-            tmp_cent_min_index  = tmp_distortions.index( tmp_cent_min )
-            init_centroids      = tmp_centroids[ tmp_cent_min_index ]
-            puts "Smallest distortions are #{tmp_cent_min.to_s} at index #{tmp_cent_min_index.to_s}"
-            puts "Initializing with these centroids..."
+              tmp_cent_min = tmp_distortions.min 
+              tmp_cent_min_index  = tmp_distortions.index( tmp_cent_min )
+              init_centroids      = tmp_centroids[ tmp_cent_min_index ]
+              puts "Smallest distortions are #{tmp_cent_min.to_s} at index #{tmp_cent_min_index.to_s}"
+              puts "Initializing with these centroids..."
+            end # of if( @options.clustering_algorithm == "minibatch" )
+
             kms.clear
 
             clustering                  = Clustering.new( @options )
@@ -392,8 +290,10 @@ class Controller
             @centroids                  = centroids
 
             kms                        << kmeans
-            distances                   = clustering.distances( final, centroids ) # Hash with   hash[ data index ] =  [ [ centroid_id, eucleadian distance ], ... ] 
-            
+
+            # labels, distances, per cluster sum of squares and the frame closest to every centroid in one pass
+            labels, _, within, @closest_frame, @closest_distance, distortions, squared_error_distortions = clustering.score( final, centroids )
+
             cluster_distances           = clustering.cluster_distances( final, kmeans, centroids )
 
             puts ""
@@ -403,58 +303,28 @@ class Controller
             puts ""
 
 
-            # Determines the closest frame for each cluster center
-            # Array index == cluster id
-            @closest_distance = []
-            @closest_frame    = []
-            distances.each_pair do |frame, array|
-
-              # Each entry is one frame upto all frames.
-              # Each entry contains an array with k-elements, where for this particular frame
-              # we can see the exact distance to each cluster center.
-              # Using this we can caluclate the shortest cluster id for this frame
-              array.each do |cluster_id, distance|
-
-                # Executes only the first time a entry is nil and sets it to a value so
-                # that we have something
-                if( @closest_distance[ cluster_id ].nil? )
-                  @closest_distance[ cluster_id ] = distance 
-                  @closest_frame[ cluster_id ] = frame
-                end
-
-                # The distance we have now is shorter than the one stored
-                # Exchange and store the current as the shortest distance for the c_id
-                if( @closest_distance[ cluster_id ] > distance )
-                  @closest_distance[ cluster_id ] = distance 
-                  @closest_frame[ cluster_id ] = frame 
-                end
-              end
-            end
-
-
             @frame_distance_cluster     = @closest_frame.zip( @closest_distance )
 
-            closest_centroids           = clustering.closest_centroids( distances, centroids, final ) # array with subarrays of each [ centroid_id, distance ]
-
-            distortions                 = clustering.distortions( closest_centroids )
-            squared_error_distortions   = clustering.squared_error_distortion( closest_centroids )
             dists << squared_error_distortions
             ks << k
-            tcss                        << clustering.total_within_cluster_sum_of_squares( closest_centroids )
+            tcss                        << within
           end # unless( @options.clustering_k_parameter.nil? ) 
 
         end # of if( @options.clustering_k_search )
 
-        # FIXME: This is needed for --seach-k-parameters-from-to
-        # css.collect! { |array| array.inject(:+) / array.length } 
-        # ks_within     = ks.zip( tcss )
-        # ks_dists      = ks.zip( dists )
-
         @plot         = Plotter.new( 0, 0 )
-        # @plot.easy_gnuplot( ks_dists,  "%e %e\n", [ "Clusters", "Total distortions" ], "Total distortions Plot", "graphs/total_distortion.gp", "graphs/total_distortion.gpdata" )
-        # @plot.easy_gnuplot( ks_within, "%e %e\n", [ "Clusters", "Total within cluster sum of squares" ], "Total within cluster sum of squares Plot", "graphs/total_within_sum_of_squares.gp", "graphs/total_within_sum_of_squares.gpdata" )
 
-        @turning.get_dot_graph( kms.last )
+        # Elbow curves of --clustering-k-search-from-to
+        if( @options.clustering_k_search )
+          tcss.collect! { |array| array.inject(:+) / array.length } 
+          ks_within     = ks.zip( tcss )
+          ks_dists      = ks.zip( dists )
+
+          @plot.easy_gnuplot( ks_dists,  "%e %e\n", [ "Clusters", "Total distortions" ], "Total distortions Plot", "graphs/total_distortion.gp", "graphs/total_distortion.gpdata" )
+          @plot.easy_gnuplot( ks_within, "%e %e\n", [ "Clusters", "Total within cluster sum of squares" ], "Total within cluster sum of squares Plot", "graphs/total_within_sum_of_squares.gp", "graphs/total_within_sum_of_squares.gpdata" )
+        end
+
+        Turning.get_dot_graph( kms.last )
         @plot.interactive_gnuplot( final, "%e %e %e\n", %w[X Y Z],  "graphs/all_domain_plot.gp", nil, nil, kms.last )
 
         # Determine lookup table for all frames to which file
@@ -472,19 +342,22 @@ class Controller
           adt_cnt        += 1
         end
 
-        # Associate the cluster id frames with the corresponding file
+        # Associate the cluster id frames with the corresponding file, the dance master poses are
+        # those of that file (its motion config travels in meta, also from Pipeline_Pool workers)
         cnt               = 0
         final_cluster_dmp = []
+        final_dmps        = []
         @frame_distance_cluster.each do |frame, distance|
           number  = @lookup_table[ frame ]
           adt, turning_data, meta    = @adts[ number ]
           config          = turning_data[0][0]
           configurations_dir, domain, name, pattern, speed, cycle, filename = config
+          dmps            = meta[ "motion_config" ].dmp
 
           adjust          = meta[ "to" ].to_i * number
           closest_pose    = []
 
-          @dmps.each_with_index do |dmp, index|
+          dmps.each_with_index do |dmp, index|
             pose, pose_range = dmp
             closest_pose     << ( ( frame.to_i - adjust ) - pose ).abs
             # puts "index: #{index.to_s} pose frame: #{pose.to_s}"
@@ -495,15 +368,16 @@ class Controller
           puts "Index of closest dance master illustration (starting from 1): " + (p_indx + 1).to_s
 
           final_cluster_dmp[ p_indx ] = [] if( final_cluster_dmp[p_indx].nil? )
+          final_dmps[ p_indx ]        = dmps[ p_indx ] if( final_dmps[ p_indx ].nil? )
           final_cluster_dmp[ p_indx ] << "Cluster ID ( #{cnt.to_s} ) Frame: #{(frame.to_i - adjust).to_s}"
           cnt += 1
         end
 
-        p @dmps
+        p final_dmps
 
         final_cluster_dmp.each_with_index do |array, index|
           if( not array.nil? )
-           puts "DMP Pose ##{ (index + 1).to_s} (Frame: #{@dmps[index].first.to_s} (#{@dmps[index].last.join(" , ")})) -> #{array.join( " | " )}"
+           puts "DMP Pose ##{ (index + 1).to_s} (Frame: #{final_dmps[index].first.to_s} (#{final_dmps[index].last.join(" , ")})) -> #{array.join( " | " )}"
           end
         end
 
@@ -539,7 +413,7 @@ class Controller
           @dmps.each { |dmp_array| @dance_master_poses << dmp_array.first; @dance_master_poses_range << dmp_array.last }
 
           @log.message :info, "Loading the Motion Capture data (#{@file}) via the MotionX VPM Plugin"
-          @adt                      = ADT.new( @file )
+          @adt                      = VPM_Cache.new( @options, @config.cache_dir ).load( @file )
 
           if( @options.filter_motion_capture_data )
             @log.message :info, "Filter Motion Capture data to smooth out outliers"
@@ -596,15 +470,20 @@ class Controller
     options.colorize                        = false
     options.process                         = ""
     options.turning_pose_extraction         = false
-    options.zmq                             = false
+    options.worker_pool                     = false
     options.cpus                            = 4
+    options.jobs                            = 1
     options.filter_motion_capture_data      = false
     options.boxcar_filter                   = nil
     options.boxcar_filter_default           = 15
+    options.local_pca_window                = nil
+    options.capture_interval                = 0.08333
+    options.cache                           = true
     options.body_parts                      = []
     options.use_raw_data                    = false
     options.filter_point_window_size        = 20
     options.filter_polyomial_order          = 5
+    options.filter_mode                     = "polynomial"
     options.profiling                       = false
     options.model                           = 12
     options.side                            = "both"
@@ -622,6 +501,9 @@ class Controller
     options.pose_visualizer                 = false
     options.each_limb_individually          = false
     options.clustering_iterations           = 1000
+    options.clustering_seed                 = 0
+    options.minibatch_size                  = 1024
+    options.minibatch_tolerance             = 0.001
     options.compare_clusters                = []
 
     pristine_options                        = options.dup
@@ -645,10 +527,27 @@ class Controller
         options.filter_polyomial_order, options.filter_point_window_size = *data
       end
 
+      opts.on( "--filter-mode OPT", @filter_modes, "Choose how -f smooths the data (OPT: #{@filter_modes.sort.join(", ")}) - Default: #{options.filter_mode.to_s}" ) do |m|
+        options.filter_mode = m
+      end
+
       opts.on( "-b", "--box-car-filter OPT", "Filter curvature result through a Finite Impulse Response (FIR) Boxcar filter of order N (#{options.boxcar_filter_default.to_s})" ) do |b|
         options.boxcar_filter = b
       end
 
+      opts.on( "--[no-]cache", "Keep parsed VPM files as binary columns in the cache directory and load them from there (#{options.cache.to_s})" ) do |c|
+        options.cache = c
+      end
+
+      opts.on( "--capture-interval OPT", "Capture interval of the motion capture equipment in seconds, used for velocity, acceleration, power and energy (#{options.capture_interval.to_s})" ) do |c|
+        options.capture_interval = c.to_f
+      end
+
+      opts.on( "--local-pca OPT", "Use the local intrinsic dimensionality of a sliding window PCA with OPT frames before and after each frame as additional turning pose cue (e.g. 15)" ) do |l|
+        raise ArgumentError, "The sliding window PCA needs a positive integer number of frames, but got (#{l.to_s})" unless( l =~ %r{\A\d+\z} and l.to_i >= 1 )
+        options.local_pca_window = l.to_i
+      end
+
       opts.on("-p", "--parts OPT", @body_parts, "Proces one or more body parts during the computation (OPT: #{@body_parts.sort.join(", ")})" ) do |p|
         options.body_parts << p
       end
@@ -685,8 +584,16 @@ class Controller
         options.use_all_of_domain  = a
       end
 
-      opts.on("-0", "--zmq", "Use ZMQ to speed up and scale on all CPU's") do |z|
-        options.zmq  = z
+      opts.on("-0", "--worker-pool", "--zmq", "Run the K-Means restarts on a pool of worker processes (see --cpus)") do |z|
+        options.worker_pool  = z
+      end
+
+      opts.on( "--cpus OPT", "Threads / worker processes of the native clustering and the K-Means worker pool - Current default: '#{options.cpus.to_s}'" ) do |c|
+        options.cpus = c.to_i
+      end
+
+      opts.on( "--jobs OPT", "Configurations of --all processed in parallel worker processes (1 = one after the other, > 1 leaves the per configuration graphs/ plots undefined) - Current default: '#{options.jobs.to_s}'" ) do |j|
+        options.jobs = j.to_i
       end
 
       opts.on("--compare-clusters OPT", "Compare two given clustering results for similarity") do |c|
@@ -710,6 +617,18 @@ class Controller
         options.clustering_iterations = i
       end
 
+      opts.on( "--clustering-seed OPT", "Seed of the random k-means++ initialization of the clustering iterations (same seed, same result) - Current default: '#{options.clustering_seed.to_s}'" ) do |s|
+        options.clustering_seed = s.to_i
+      end
+
+      opts.on( "--minibatch-size OPT", "Points per mini-batch for -g minibatch - Current default: '#{options.minibatch_size.to_s}'" ) do |b|
+        options.minibatch_size = b.to_i
+      end
+
+      opts.on( "--minibatch-tolerance OPT", "Largest centroid movement per mini-batch which counts as converged for -g minibatch - Current default: '#{options.minibatch_tolerance.to_s}'" ) do |t|
+        options.minibatch_tolerance = t.to_f
+      end
+
       opts.on( "--visualize", "Pose Visualizer" ) do |p|
         options.pose_visualizer = p
       end
@@ -781,6 +700,111 @@ class Controller
   end # of parse_cmd_arguments }}}
 
 
+  # @fn       def process_configuration configurations_dir, domain, name, pattern, speed, cycle, filename # {{{
+  # @brief    Per configuration pipeline of --all: loads the VPM (cache), filters it and extracts the T-Data.
+  #           Runs in the Controller or in a Pipeline_Pool worker process, so it only returns its results.
+  #
+  # @param    [String]      configurations_dir  Path components of the YAML configuration as in @yamls
+  # @param    [String]      domain              ..
+  # @param    [String]      name                ..
+  # @param    [String]      pattern             ..
+  # @param    [String]      speed               ..
+  # @param    [String]      cycle               ..
+  # @param    [String]      filename            YAML file name
+  #
+  # @returns  [Array]                           Array of [ T-Data, ADT, meta Hash ], one per T-Data extraction (limb)
+  def process_configuration configurations_dir, domain, name, pattern, speed, cycle, filename
+
+    entries                   = []
+
+    yaml_var = @fname_table[ filename ]
+    @log.message :success, "Using domain '#{domain}' with process '#{name}' with pattern '#{pattern}', speed '#{speed}' and cycle '#{cycle}' (YAML: '#{yaml_var}')"
+    motion_config             = eval( "@motions.#{domain}.#{name}.#{pattern}.speed_#{speed}.cycle_#{cycle}.yaml_#{yaml_var}" )
+
+    raise ArgumentError, "The configuration and/or the data you requested doesn't exist!" if( motion_config.nil? )
+
+    motion_config_filename    = motion_config.path + "/" + motion_config.filename
+
+    @log.message :debug, "Loading Motion Capture config file (#{motion_config_filename})"
+
+    @motion_config            = read_motion_config( motion_config_filename )
+
+    @file                     = @motion_config.filename
+    @from                     = @motion_config.from
+    @to                       = @motion_config.to
+    @name                     = @motion_config.name
+    @dmps                     = @motion_config.dmp
+
+    @dance_master_poses       = []
+    @dance_master_poses_range = []
+    @dmps.each { |dmp_array| @dance_master_poses << dmp_array.first; @dance_master_poses_range << dmp_array.last }
+
+    @log.message :success, "Loading the Motion Capture data (#{@file}) via the MotionX VPM Plugin"
+    @adt                      = VPM_Cache.new( @options, @config.cache_dir ).load( @file )
+
+    if( @options.filter_motion_capture_data )
+      @log.message :info, "Filter Motion Capture data to smooth out outliers"
+      @filter                 = Filter.new( @options, @from, @to )
+      @adt                    = @filter.filter_motion_capture_data( @adt )
+    end
+
+    if( @options.turning_pose_extraction )
+
+      if( @options.each_limb_individually )
+        # This option will cause e.g. --part fore_arms --part upper_arms -> to be processed
+        # separaely to yield separate t-data and will then get added together into one large
+        # array for e.g. clustering. This allows the mixing of all part t-data's.
+        @log.message :info, "All given limbs (--part) will be treated separately for T-Data extraction and summed up."
+
+
+        @given_body_parts = @options.body_parts.dup    # store for later reuse
+        @given_body_parts.each do |part|               # iterate over each limb, reset @options.body_parts to only one limb and calculate
+
+          @log.message :info, "Calculating T-Data for #{part.to_s}"
+          @options.body_parts = [ part ]
+
+          @log.message :info, "Performing CPA-PCA Turning pose extraction"
+          @turning                = Turning.new( @options, @adt, @dance_master_poses, @dance_master_poses_range, @from, @to )
+          data                    = @turning.get_data
+
+          meta = Hash.new
+          meta[ "total_frames" ]  = @adt.relb.getCoordinates!.length
+          meta[ "from" ]          = @from
+          meta[ "to" ]            = @to
+          meta[ "motion_config" ] = @motion_config
+
+          @log.message :info, "Summing up T-Data for #{part.to_s}"
+          entries << [ data, @adt, meta.dup ]
+
+        end # of given_body_parts.each do |part|
+
+        # Restore all limbs, the next configuration (serial --all) has to start from the same parts
+        # as a freshly forked Pipeline_Pool worker
+        @options.body_parts = @given_body_parts
+
+      else # of if( @options.each_limb_individually )
+        @log.message :info, "All given limbs (--part) will get unified together"
+        @log.message :info, "Performing CPA-PCA Turning pose extraction"
+        @turning                = Turning.new( @options, @adt, @dance_master_poses, @dance_master_poses_range, @from, @to )
+        data                    = @turning.get_data
+
+        meta = Hash.new
+        meta[ "total_frames" ]  = @adt.relb.getCoordinates!.length
+        meta[ "from" ]          = @from
+        meta[ "to" ]            = @to
+        meta[ "motion_config" ] = @motion_config
+
+        entries << [ data, @adt, meta.dup ]
+
+      end # of if( @options.each_limb_individually )
+    end # of if( @options.turning_pose_extraction )
+
+    @log.message :success, "Finished processing of #{motion_config_filename.to_s}"
+
+    entries
+  end # of def process_configuration }}}
+
+
   # @fn       def read_motion_config filename # {{{
   # @brief    Reads a yaml config describing the motion file
   #
@@ -29,6 +29,7 @@ require 'Logger.rb'
 require 'PCA.rb'
 require 'Plotter.rb'
 require 'Mathematics.rb'
+require 'FrameMatrix.rb'
 
 # Change Namespace
 include GSL
@@ -72,6 +73,8 @@ class Filter
   # @returns  [ADT]                     ADT Class Object containing the new smoothed version of the input
   def filter_motion_capture_data input, point_window = @options.filter_point_window_size, polynom_order = @options.filter_polyomial_order
 
+    return savitzky_golay_filter( input, point_window, polynom_order ) if( @options.filter_mode == "savitzky_golay" )
+
     @log.message :success, "Smoothing raw data with Polynomial of the order #{polynom_order.to_s} with a point window of #{point_window.to_s}"
 
     # Pre-condition check {{{
@@ -84,164 +87,106 @@ class Filter
 
     @log.message :info, "Starting filtering of all relevant motion segments"
 
-    # lets determine which segments we have in adt
-    segments        = input.segments + %w[pt24 pt25 pt26 pt27 pt28 pt29 pt30 pt31]
-    body            = input.body
-
-    pca             = PCA.new
-    # result          = input.dup # we cant deepclone it - why?
+    # lets determine which segments we have in adt, their coordinates are read once into a frame matrix
+    matrix          = FrameMatrix.new( input )
+    segments        = matrix.names
 
     # Why not on all segments? How long?
     # FXIME: This should be provided by MotionX VPM
     # %w[pt27 relb pt26 lelb pt30 rfin lfin rsho lsho rkne pt29 lkne pt28 rank lank rhee lhee rtoe ltoe].each do |
     segments.each do |s|
 
-      # we store our calculated chunks here
-      temp_container = []
-      errors         = []
-
-      # only process if it exists
-      if( segments.include?( s.to_s ) )
-        @log.message :info, "Filtering #{s.to_s} segment"
-
-        segment     = eval( "input.#{s.to_s}" )
-        coordinates = segment.getCoordinates!
-
-        coordinate_chunks = coordinates % ( point_window / 2 )
-
-        #coordinate_chunks.each_with_index do |cluster, cluster_index|
-
-        while( not coordinate_chunks.empty? )
-
-          # cluster = c1 + c2 since we have point_window / 2
-          c1 = coordinate_chunks.shift
-          c1_length = c1.length
-
-          c2 = coordinate_chunks.shift
-          c2_length = ( c2.nil? ) ? ( 0 ) : ( c2.length )
-
-          cluster = ( c2.nil? ) ? ( c1 ) : ( c1.dup.concat( c2 ) )
+      @log.message :info, "Filtering #{s.to_s} segment"
 
-          unless( cluster.empty? )
-            # determine the piecewise linear from p0 to p1 (eucleadian distance)
-            arc_lengths  = []
-            cluster.each_index { |index| arc_lengths << @mathematics.eucledian_distance( cluster[index], cluster[index+1] ) unless( (cluster[ index + 1 ]).nil? ) }
+      frames      = matrix.count( s )
 
-            cluster_l           = pca.reshape_data( cluster.dup, true, false )
-            x, y, z             = cluster_l.shift, cluster_l.shift, cluster_l.shift
+      next if( frames == 0 )
 
-            t_s         = []
-            arc_lengths.each_index do |i|
-              # t[0] is 0
-              if( i == 0 )
-                t_s << 0
-                next
-              end
+      # Polynomials x(t), y(t), z(t) over the cumulative arc length t of overlapping windows (point_window / 2), blended
+      # at the window boundaries - see c/utils/c_arc_smooth.c
+      smooth      = "\0" * ( 24 * frames )
+      points      = matrix.interleaved( s )
+      raise ArgumentError, "Frame matrix returned #{( points.bytesize / 24 ).to_s} instead of #{frames.to_s} frames of #{s.to_s}" unless( points.bytesize == 24 * frames )
 
-              # from 2..n
-              t_s << t_s[ i - 1 ] + arc_lengths[ i ]
-            end
+      result      = C_mathematics.c_arc_length_smooth( points, frames, point_window, polynom_order, smooth )
+      raise ArgumentError, "Arc length smoothing of #{s.to_s} failed (#{result.to_s})" unless( result == frames )
 
-            result_splines = []
+      @log.message :info, "Over-writing new filtered data to output ADT object"
 
-            # get independent splines through s1 = [ t(i), x(i) ], s2 =[ t(i), y(i) ], s3 = [ t(i), z(i) ]
-            # Should use bsline actually, maybe to wavevy?
-            [ [ t_s, x ], [ t_s, y ], [ t_s, z ] ].each do |array|
+      xtran, ytran, ztran = *( smooth.unpack( "d*" ).each_slice( 3 ).to_a.transpose )
 
-              t, axis = *array
+      eval( "input.#{s.to_s}.xtran = xtran" )
+      eval( "input.#{s.to_s}.ytran = ytran" )
+      eval( "input.#{s.to_s}.ztran = ztran" )
 
-              # original
-              # can we not throw away the last point?
-              # if( t.length != axis.length )
-              #  t_l, a_l = t.length, axis.length
-              #  if( t_l < a_l )
-              #    axis.pop
-              #  end
-              # end
+    end # of segments.each
 
-              if( t.length != axis.length )
-                t_l, a_l = t.length, axis.length
-                if( t_l < a_l )
-                  # t << axis.last
-                  t << t.last # best guess?
-                end
-              end
 
-              if( t.include?( nil ) or axis.include?( nil ) )
-                puts "--- Something bad happend just now in the filter class"
-                next
-              end
-
-              gsl_t, gsl_axis           = GSL::Vector.alloc( t ), GSL::Vector.alloc( axis )
-              coef, err, chisq, status  = GSL::MultiFit::polyfit( gsl_t, gsl_axis, polynom_order )
-
-              # result_splines << [ coef, err, chisq, status ]
-              result_splines << coef
-
-              # Standard error estimate
-              #err_sum = err.to_na.to_a.inject(0) { |r,e| r + e }
-              #err_final = Math.sqrt( err_sum / ( ( err.to_na.to_a.length - 1 ) - 2 ) )
-              
-              # FIXME: This was not uncommented before (23/02/2012)
-              #errors += err.to_na.to_a
-              # printf( "Error: %-20s\n", err_final.to_s )
-            end
-
-            cluster_smooth  = []
-            s1_coef, s2_coef, s3_coef = *result_splines
-
-            t_s.each_index do |i|
-        
-              if( t_s[i].nil? )
-                puts "--- Somthing bad happend just now in the filter class (lower)"
-                next
-              end
+    input
+  end # of def motion_capture_data_smoothing }}}
 
-              s1_t, s2_t, s3_t = s1_coef.eval( t_s[i] ), s2_coef.eval( t_s[i] ), s3_coef.eval( t_s[i] )
 
-              cluster_smooth << [ s1_t, s2_t, s3_t ]
-            end
+  # @fn       def savitzky_golay_filter input, point_window = @options.filter_point_window_size, polynom_order = @options.filter_polyomial_order # {{{
+  # @brief    The function takes a MotionX ADT Class as input and smooths all segments with a Savitzky-Golay filter (uniform time,
+  #           least squares polynomial over a sliding point window). The convolution coefficients are calculated only once and all
+  #           segments are filtered together as one FIR pass (see c/utils/c_savitzky_golay.c).
+  #
+  # @param    [ADT]     input           ADT Class Object of the MotionX package VPM plugin
+  # @param    [Integer] point_window    Integer representing the window size, the filter uses point_window/2 points before and after each frame
+  # @param    [Integer] polynom_order   Integer representing the order of the fitting polynomial
+  #
+  # @returns  [ADT]                     ADT Class Object containing the new smoothed version of the input
+  def savitzky_golay_filter input, point_window = @options.filter_point_window_size, polynom_order = @options.filter_polyomial_order
 
-            x1 = cluster_smooth.shift( c1_length )
-            x2 = cluster_smooth.shift( c2_length )
+    window          = ( 2 * ( point_window / 2 ) ) + 1
 
-            # temp_container += cluster_smooth
-            temp_container += x1
-            coordinate_chunks.insert(0, x2 ) 
-          else
-            # cluster is empty
-          end
+    # Pre-condition check {{{
+    raise ArgumentError, "Input argument should be of type ADT, but is of type (#{input.class.to_s})" unless( input.is_a?(ADT) )
+    raise ArgumentError, "Point window argument should be of type Integer, but is of (#{point_window.class.to_s})" unless( point_window.is_a?( Integer ) )
+    raise ArgumentError, "Polynom order argument should be of type Integer, but is of (#{polynom_order.class.to_s})" unless( polynom_order.is_a?( Integer ) )
+    raise ArgumentError, "Polynom order (#{polynom_order.to_s}) needs to be smaller than the window of #{window.to_s} points" unless( polynom_order >= 0 and polynom_order < window )
+    # }}}
 
-        end # while
-        # end # of coordinate_chunks.each do |cluster|
+    @log.message :success, "Smoothing raw data with Savitzky-Golay filter of the order #{polynom_order.to_s} with a point window of #{window.to_s}"
 
+    coefficients    = "\0" * ( 8 * window * window )
+    result          = C_mathematics.c_savitzky_golay_coefficients( window, polynom_order, coefficients )
+    raise ArgumentError, "Savitzky-Golay coefficients could not be calculated (#{result.to_s})" unless( result == window * window )
 
+    # lets determine which segments we have in adt, their coordinates are read once into a frame matrix
+    matrix          = FrameMatrix.new( input )
 
+    # all segments of the same length are filtered side by side, columns [ x1, y1, z1, x2, y2, z2, ... ]
+    matrix.names.group_by { |s| matrix.count( s ) }.each_pair do |frames, group|
 
-        #err_sum = errors.inject(0) { |r,e| r + e }
-        #err_final = Math.sqrt( err_sum / ( ( errors.length - 1 ) - 2 ) )
-        #puts "standard error of the estimate: #{ (err_final * 100 ).to_s} %"
+      if( frames < window )
+        @log.message :warning, "Not filtering #{group.join( ", " )}, only #{frames.to_s} frames for a point window of #{window.to_s}"
+        next
+      end
 
+      columns       = 3 * group.length
+      signal        = matrix.side_by_side( group )
+      smooth        = "\0" * ( 8 * frames * columns )
+      raise ArgumentError, "Frame matrix returned #{signal.bytesize.to_s} bytes instead of #{frames.to_s} x #{columns.to_s} values" unless( signal.bytesize == 8 * frames * columns )
 
-        @log.message :info, "Over-writing new filtered data to output ADT object"
+      result        = C_mathematics.c_savitzky_golay_filter( coefficients, window, signal, frames, columns, smooth )
+      raise ArgumentError, "Savitzky-Golay filter failed (#{result.to_s})" unless( result == frames )
 
-        t_container = pca.reshape_data( temp_container, true, false )
+      @log.message :info, "Over-writing new filtered data of #{group.length.to_s} segments to output ADT object"
 
-        xtran, ytran, ztran = t_container.shift, t_container.shift, t_container.shift
+      channels      = smooth.unpack( "d*" ).each_slice( columns ).to_a.transpose
 
-        # @log.message :warning, "Size changed (bug in filter) - size of frames is now #{xtran.length.to_s} should be #{input.frames.to_s}"
-        # @log.message :warning, "Size changed (bug in filter) - size of frames is now #{xtran.length.to_s} "
+      group.each_with_index do |s, index|
+        xtran, ytran, ztran = channels[ 3 * index ], channels[ ( 3 * index ) + 1 ], channels[ ( 3 * index ) + 2 ]
 
         eval( "input.#{s.to_s}.xtran = xtran" )
         eval( "input.#{s.to_s}.ytran = ytran" )
         eval( "input.#{s.to_s}.ztran = ztran" )
-
-      end # of if( segments.include?( 
-    end # of %w[pt27...
-
+      end
+    end
 
     input
-  end # of def motion_capture_data_smoothing }}}
+  end # of def savitzky_golay_filter }}}
 
 
   # @fn       def box_car_filter input, order = 5 # {{{
@@ -269,31 +214,12 @@ class Filter
     #  - y[n] is the output signal,
     #  - bi are the filter coefficients, also known as tap weights, that make up the impulse response,
     #  - N is the filter order; an Nth-order filter has (N + 1) terms on the right-hand side.
-
-    y = []
+    #
+    # y[n] is the average of x[n..n+order-1] (fewer samples at the end), computed natively with a
+    # running sum (see fir_filter)
 
     # split time and energy
-    x = input.collect { |a,b| b }
-
-    cnt = 0
-
-    while( not x.empty? )
-      
-      # take adjacent samples
-      old_chunk = x.shift( order )
-      chunk     = old_chunk.dup
-
-      # compute average
-      average = ( chunk.inject(0) { |b,i| b+i } ) / ( chunk.length )
-  
-      # push result to array
-      y[ cnt ] = average
-      cnt += 1
-  
-      # throw away one sample and repeat
-      old_chunk.shift
-      x = old_chunk.concat( x )
-    end # of while
+    y = fir_filter( input.collect { |a,b| b }, nil, order )
 
     # recombine time and FIR result into array of subarrays
     result = ( input.collect { |a,b| a } ).zip( y )
@@ -321,6 +247,113 @@ class Filter
   end # of def box_car_filter }}}
 
 
+  # @fn       def fir_filter values, taps = nil, order = 5 # {{{
+  # @brief    Filters a plain signal (e.g. kappa, energy or velocity) through a FIR filter,
+  #           y[n] = \sum_{i} b_i x[n + i]. Without taps a boxcar (moving average) of the given order
+  #           is used, which runs in O(1) per sample. The result has the same length as the input,
+  #           windows running over the end only use the remaining samples (see box_car_filter).
+  #
+  # @param    [Array]   values    Signal, [ x0, x1, ... ]
+  # @param    [Array]   taps      Tap weights [ b0, b1, ... ] or nil for a boxcar
+  # @param    [Integer] order     Number of boxcar taps (only used if taps is nil)
+  #
+  # @returns  [Array]             Filtered signal, [ y0, y1, ... ]
+  def fir_filter values = nil, taps = nil, order = 5
+
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument values should be of type Array, but it is of (#{values.class.to_s})" unless( values.is_a?( Array ) )
+    # }}}
+
+    state   = fir_stream( taps, order )
+    result  = fir_push( state, values ) + fir_flush( state )
+
+    # Post-condition check {{{
+    raise ArgumentError, "Filtered signal should have #{values.length.to_s} values but has #{result.length.to_s}" unless( result.length == values.length )
+    # }}}
+
+    result
+  end # of def fir_filter }}}
+
+
+  # @fn       def fir_stream taps = nil, order = 5 # {{{
+  # @brief    Creates the state of a streaming FIR filter. Feed it with fir_push (in chunks of any
+  #           size, e.g. frame by frame) and get the tail with fir_flush.
+  #
+  # @param    [Array]   taps      Tap weights [ b0, b1, ... ] or nil for a boxcar
+  # @param    [Integer] order     Number of boxcar taps (only used if taps is nil)
+  #
+  # @returns  [String]            Packed filter state (see c/utils/c_fir.h)
+  def fir_stream taps = nil, order = 5
+
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument taps should be of type Array, but it is of (#{taps.class.to_s})" unless( taps.nil? or taps.is_a?( Array ) )
+    raise ArgumentError, "Taps cannot be empty" if( not taps.nil? and taps.empty? )
+    raise ArgumentError, "The argument order should be a positive Integer, but it is (#{order.to_s})" unless( not taps.nil? or ( order.is_a?( Integer ) and order > 0 ) )
+    # }}}
+
+    n       = ( taps.nil? ) ? ( order ) : ( taps.length )
+    packed  = ( taps.nil? ) ? ( "\0" * 8 ) : ( taps.collect { |b| b.to_f }.pack( "d*" ) )
+    state   = "\0" * ( 8 * C_mathematics.c_fir_state_size( n ) )
+
+    written = C_mathematics.c_fir_init( packed, n, ( taps.nil? ) ? ( 1 ) : ( 0 ), state )
+    raise ArgumentError, "Could not initialize the FIR filter" unless( written == ( state.bytesize / 8 ) )
+
+    state
+  end # of def fir_stream }}}
+
+
+  # @fn       def fir_push state, values # {{{
+  # @brief    Pushes new samples through a streaming FIR filter. The outputs lag the input by
+  #           (taps - 1) samples.
+  #
+  # @param    [String]  state     Filter state of fir_stream, updated in place
+  # @param    [Array]   values    New samples [ x0, x1, ... ]
+  #
+  # @returns  [Array]             All outputs that became available
+  def fir_push state, values
+
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument state should be of type String, but it is of (#{state.class.to_s})" unless( state.is_a?( String ) )
+    raise ArgumentError, "The argument values should be of type Array, but it is of (#{values.class.to_s})" unless( values.is_a?( Array ) )
+    # the state starts with its number of taps, 2 x taps values follow
+    taps    = state.unpack( "d" ).first.to_f
+    raise ArgumentError, "The argument state is not a FIR filter state" unless( taps >= 1 and taps <= state.bytesize / 16 and state.bytesize == 8 * C_mathematics.c_fir_state_size( taps.to_i ) )
+    # }}}
+
+    return [] if( values.empty? )
+
+    out     = "\0" * ( 8 * values.length )
+    written = C_mathematics.c_fir_push( state, values.collect { |x| x.to_f }.pack( "d*" ), values.length, out )
+    raise ArgumentError, "FIR filter failed" if( written < 0 )
+
+    out.unpack( "d*" ).first( written )
+  end # of def fir_push }}}
+
+
+  # @fn       def fir_flush state # {{{
+  # @brief    Returns the last outputs of a streaming FIR filter, whose windows run over the end of
+  #           the signal.
+  #
+  # @param    [String]  state     Filter state of fir_stream
+  #
+  # @returns  [Array]             Remaining outputs (at most taps - 1)
+  def fir_flush state
+
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument state should be of type String, but it is of (#{state.class.to_s})" unless( state.is_a?( String ) )
+    # the state starts with its number of taps, 2 x taps values follow
+    taps    = state.unpack( "d" ).first.to_f
+    raise ArgumentError, "The argument state is not a FIR filter state" unless( taps >= 1 and taps <= state.bytesize / 16 and state.bytesize == 8 * C_mathematics.c_fir_state_size( taps.to_i ) )
+    # }}}
+
+    out     = "\0" * ( 8 * [ state.unpack( "d" ).first.to_i, 1 ].max )
+    written = C_mathematics.c_fir_flush( state, out )
+    raise ArgumentError, "FIR filter failed" if( written < 0 )
+
+    out.unpack( "d*" ).first( written )
+  end # of def fir_flush }}}
+
+
 end # of class Filter }}}
 
 
@@ -0,0 +1,251 @@
+#!/usr/bin/ruby
+#
+
+###
+#
+# File: FrameMatrix.rb
+#
+######
+
+
+###
+#
+# (c) 2009-2011, Copyright, Bjoern Rennhak, The University of Tokyo
+#
+# @file       FrameMatrix.rb
+# @author     Bjoern Rennhak
+#
+# @brief      Structure of arrays representation of the marker coordinates of an ADT.
+#
+#             The coordinates are copied out of the segments once, one contiguous float64 buffer
+#             per axis ( markers x frames, marker after marker ). Markers are addressed by integer
+#             ids resolved once from their names, frame ranges and center relative coordinates are
+#             gathered natively (see c/utils/c_frame_matrix.c) instead of through Segment
+#             arithmetic and getCoordinates!.
+#
+#######
+
+
+# Local includes
+$:.push('.')
+require 'Mathematics.rb'
+
+
+# @class      class FrameMatrix # {{{
+# @brief      Marker coordinates of all frames of an ADT as one matrix per axis
+class FrameMatrix
+
+  # @fn       def initialize adt = nil, names = nil # {{{
+  # @brief    Custom constructor for the FrameMatrix class
+  #
+  # @param    [ADT]         adt         ADT Class Object of the MotionX package VPM plugin
+  # @param    [Array]       names       Segment names to take over, all segments with coordinates if nil
+  def initialize adt = nil, names = nil
+
+    # Input verification {{{
+    raise ArgumentError, "ADT cannot be nil" if( adt.nil? )
+    # }}}
+
+    @names      = ( names.nil? ) ? FrameMatrix.markers( adt ) : names.collect { |s| s.to_s }
+    @ids        = Hash.new
+    @names.each_with_index { |s, i| @ids[ s ] = i }
+
+    columns     = @names.collect { |s| segment = eval( "adt.#{s}" ); [ segment.xtran, segment.ytran, segment.ztran ] }
+
+    raise ArgumentError, "Segments have axes of different lengths" unless( columns.all? { |x, y, z| x.length == y.length and y.length == z.length } )
+
+    # shorter markers are padded, their own length is kept in counts
+    @counts     = columns.collect { |x, y, z| x.length }
+    @frames     = @counts.max.to_i
+    @axes       = ( 0...3 ).collect do |axis|
+      buffer    = String.new( "", encoding: Encoding::BINARY )
+      columns.each_with_index { |axes, i| buffer << axes[ axis ].pack( "d*" ) << ( "\0" * ( 8 * ( @frames - @counts[ i ] ) ) ).b }
+      buffer
+    end
+  end # of def initialize }}}
+
+
+  # @fn       def self.markers adt # {{{
+  # @brief    Segments of an ADT which carry coordinates: adt.segments plus the pt24 - pt31 markers,
+  #           without duplicates and only those the ADT has. The one marker list of the frame matrix
+  #           users (Filter, Turning, PoseVisualizer) and of the VPM cache.
+  #
+  # @param    [ADT]         adt         ADT Class Object of the MotionX package VPM plugin
+  #
+  # @returns  [Array]                   Segment names
+  def self.markers adt
+    ( adt.segments + %w[pt24 pt25 pt26 pt27 pt28 pt29 pt30 pt31] ).collect { |s| s.to_s }.uniq.select { |s| adt.respond_to?( s ) }
+  end # of def self.markers }}}
+
+
+  # @fn       def id name # {{{
+  # @brief    Integer id of a marker, resolve it once and use the id in loops
+  #
+  # @param    [String]      name        Segment name, e.g. "pt30" (an Integer id is passed through)
+  #
+  # @returns  [Integer]                 Marker id (row of the matrix)
+  def id name
+    return name if( name.is_a?( Integer ) and name >= 0 and name < @names.length )
+
+    result      = @ids[ name.to_s ]
+    raise ArgumentError, "Unknown marker (#{name.to_s}), the frame matrix holds #{@names.join( ", " )}" if( result.nil? )
+
+    result
+  end # of def id }}}
+
+
+  # @fn       def count marker # {{{
+  # @brief    Number of frames of a marker
+  #
+  # @param    [Integer]     marker      Marker id or name
+  #
+  # @returns  [Integer]                 Frames of the marker
+  def count marker
+    @counts[ id( marker ) ]
+  end # of def count }}}
+
+
+  # @fn       def range marker, center = nil, from = nil, to = nil # {{{
+  # @brief    Clamps [ from, to ] (inclusive, like Array#[] with a Range) to the frames of a marker and its center
+  #
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the marker if nil
+  #
+  # @returns  [Array]                   [ first frame, number of frames ]
+  def range marker, center = nil, from = nil, to = nil
+
+    frames      = count( marker )
+    frames      = [ frames, count( center ) ].min unless( center.nil? )
+    from        = 0 if( from.nil? )
+    to          = frames - 1 if( to.nil? or to > frames - 1 )
+
+    # Pre-condition check {{{
+    raise ArgumentError, "From (#{from.to_s}) needs to be within the #{frames.to_s} frames" unless( from >= 0 and from <= frames )
+    # }}}
+
+    [ from, [ to - from + 1, 0 ].max ]
+  end # of def range }}}
+
+
+  # @fn       def gather marker, center, from, to, buffer, stride, offset # {{{
+  # @brief    Writes the frames [ from, to ] of a marker into a packed buffer, x, y, z at offset, offset + 1, offset + 2
+  #           and stride values apart from one frame to the next
+  #
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the marker if nil
+  # @param    [String]      buffer      Packed ( "d*" ) output buffer
+  # @param    [Integer]     stride      Values between two frames in the buffer
+  # @param    [Integer]     offset      Position of x of the first frame in the buffer
+  #
+  # @returns  [Integer]                 Number of frames written
+  def gather marker, center, from, to, buffer, stride, offset
+
+    marker      = id( marker )
+    center      = ( center.nil? ) ? -1 : id( center )
+    first, n    = range( marker, ( center < 0 ) ? nil : center, from, to )
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Buffer is too small for #{n.to_s} frames" unless( n == 0 or buffer.bytesize >= 8 * ( offset + 2 + ( n - 1 ) * stride + 1 ) )
+    # }}}
+
+    @axes.each_with_index do |axis, index|
+      result    = C_mathematics.c_frame_matrix_gather( axis, @frames, marker, center, first, n, stride, offset + index, buffer )
+      raise ArgumentError, "Frame matrix gather failed (#{result.to_s})" unless( result == n )
+    end
+
+    n
+  end # of def gather }}}
+
+
+  # @fn       def interleaved marker, center = nil, from = nil, to = nil # {{{
+  # @brief    Packed [ x0, y0, z0, x1, ... ] rows of a marker, the layout of the native kernels (e.g. c_cpa.c)
+  #
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the marker if nil
+  #
+  # @returns  [String]                  Packed ( "d*" ) String of 3 * frames values
+  def interleaved marker, center = nil, from = nil, to = nil
+    first, n    = range( marker, center, from, to )
+    buffer      = "\0" * ( 24 * n )
+
+    gather( marker, center, first, first + n - 1, buffer, 3, 0 ) if( n > 0 )
+
+    buffer
+  end # of def interleaved }}}
+
+
+  # @fn       def side_by_side markers, center = nil, from = nil, to = nil # {{{
+  # @brief    Packed rows [ x1, y1, z1, x2, y2, z2, ... ] of many markers per frame, the channel layout of
+  #           c_savitzky_golay_filter
+  #
+  # @param    [Array]       markers     Marker ids or names
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the shortest marker if nil
+  #
+  # @returns  [String]                  Packed ( "d*" ) String of frames x ( 3 * markers.length ) values
+  def side_by_side markers, center = nil, from = nil, to = nil
+    first, n    = markers.collect { |m| range( m, center, from, to ) }.min_by { |f, c| c }
+    columns     = 3 * markers.length
+    buffer      = "\0" * ( 8 * columns * n.to_i )
+
+    markers.each_with_index { |m, i| gather( m, center, first, first + n - 1, buffer, columns, 3 * i ) } if( n.to_i > 0 )
+
+    buffer
+  end # of def side_by_side }}}
+
+
+  # @fn       def columns marker, center = nil, from = nil, to = nil # {{{
+  # @brief    Long form [ [ x0, x1, ... ], [ y0, ... ], [ z0, ... ] ] of a marker, the shape PCA works on
+  #           (same as PCA#reshape_data( coordinates, true, false ) without the detour)
+  #
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the marker if nil
+  #
+  # @returns  [Array]                   Three Arrays of floats
+  def columns marker, center = nil, from = nil, to = nil
+    marker      = id( marker )
+    first, n    = range( marker, center, from, to )
+
+    return [ [], [], [] ] if( n == 0 )
+
+    @axes.collect do |axis|
+      buffer    = "\0" * ( 8 * n )
+      result    = C_mathematics.c_frame_matrix_gather( axis, @frames, marker, ( center.nil? ) ? -1 : id( center ), first, n, 1, 0, buffer )
+      raise ArgumentError, "Frame matrix gather failed (#{result.to_s})" unless( result == n )
+      buffer.unpack( "d*" )
+    end
+  end # of def columns }}}
+
+
+  # @fn       def coordinates marker, center = nil, from = nil, to = nil # {{{
+  # @brief    Short form [ [ x, y, z ], ... ] of a marker, a drop in for ( segment - center ).getCoordinates![ from..to ]
+  #
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame, last frame of the marker if nil
+  #
+  # @returns  [Array]                   Array of arrays, [ [x,y,z],[..]...]
+  def coordinates marker, center = nil, from = nil, to = nil
+    interleaved( marker, center, from, to ).unpack( "d*" ).each_slice( 3 ).to_a
+  end # of def coordinates }}}
+
+
+  attr :names, :counts, :frames, :axes
+end # of class FrameMatrix # }}}
+
+
+# Direct Invocation (local testing) # {{{
+if __FILE__ == $0
+end # of if __FILE__ == $0 }}}
+
+# vim:ts=2:tw=100:wm=100
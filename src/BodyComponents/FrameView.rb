@@ -0,0 +1,152 @@
+#!/usr/bin/ruby
+#
+
+###
+#
+# File: FrameView.rb
+#
+######
+
+
+###
+#
+# (c) 2009-2011, Copyright, Bjoern Rennhak, The University of Tokyo
+#
+# @file       FrameView.rb
+# @author     Bjoern Rennhak
+#
+# @brief      A [ from, to ] window of one marker (optionally relative to a center marker) over the
+#             buffers of a FrameMatrix. Creating a view copies nothing, frames are read straight out
+#             of the matrix and only the window is gathered when a whole shape is asked for.
+#
+#######
+
+
+# Local includes
+$:.push('.')
+require 'FrameMatrix.rb'
+
+
+# @class      class FrameView # {{{
+# @brief      Frame range view of one marker of a FrameMatrix, behaves like the sliced [ [x,y,z], ... ] Array
+class FrameView
+
+  include Enumerable
+
+  # @fn       def initialize matrix = nil, marker = nil, center = nil, from = nil, to = nil # {{{
+  # @brief    Custom constructor for the FrameView class
+  #
+  # @param    [FrameMatrix] matrix      Frame matrix the view reads from
+  # @param    [Integer]     marker      Marker id or name
+  # @param    [Integer]     center      Marker id or name of the coordinate center, nil for absolute coordinates
+  # @param    [Integer]     from        First frame, 0 if nil
+  # @param    [Integer]     to          Last frame (inclusive), last frame of the marker if nil
+  def initialize matrix = nil, marker = nil, center = nil, from = nil, to = nil
+
+    # Input verification {{{
+    raise ArgumentError, "Matrix should be of type FrameMatrix, but is (#{matrix.class.to_s})" unless( matrix.is_a?( FrameMatrix ) )
+    raise ArgumentError, "Marker cannot be nil" if( marker.nil? )
+    # }}}
+
+    @matrix           = matrix
+    @marker           = @matrix.id( marker )
+    @center           = ( center.nil? ) ? nil : @matrix.id( center )
+    @from, @length    = @matrix.range( @marker, @center, from, to )
+  end # of def initialize }}}
+
+
+  # @fn       def to # {{{
+  # @brief    Last frame (inclusive) of the view
+  #
+  # @returns  [Integer]                 Frame number in the recording
+  def to
+    @from + @length - 1
+  end # of def to }}}
+
+
+  # @fn       def [] index # {{{
+  # @brief    One frame of the view, read from the axis buffers without gathering the window
+  #
+  # @param    [Integer]     index       Frame in the view (0 is the frame from), negative counts from the end
+  #
+  # @returns  [Array]                   [ x, y, z ] or nil outside of the view
+  def [] index
+    index            += @length if( index < 0 )
+    return nil unless( index >= 0 and index < @length )
+
+    frame             = @from + index
+    point             = @matrix.axes.collect { |axis| axis.byteslice( 8 * ( @marker * @matrix.frames + frame ), 8 ).unpack( "d" ).first }
+
+    unless( @center.nil? )
+      origin          = @matrix.axes.collect { |axis| axis.byteslice( 8 * ( @center * @matrix.frames + frame ), 8 ).unpack( "d" ).first }
+      point           = point.zip( origin ).collect { |p, o| p - o }
+    end
+
+    point
+  end # of def [] }}}
+
+
+  # @fn       def each # {{{
+  # @brief    Yields the frames of the view one by one as [ x, y, z ]
+  def each
+    return enum_for( :each ) unless( block_given? )
+
+    @length.times { |index| yield self[ index ] }
+
+    self
+  end # of def each }}}
+
+
+  # @fn       def view from = nil, to = nil # {{{
+  # @brief    Narrower view, frame numbers are those of the recording and are clamped to this view
+  #
+  # @param    [Integer]     from        First frame, first frame of this view if nil
+  # @param    [Integer]     to          Last frame (inclusive), last frame of this view if nil
+  #
+  # @returns  [FrameView]               View over the same buffers
+  def view from = nil, to = nil
+    from              = ( from.nil? ) ? @from : [ from, @from ].max
+    to                = ( to.nil? ) ? self.to : [ to, self.to ].min
+
+    FrameView.new( @matrix, @marker, @center, from, to )
+  end # of def view }}}
+
+
+  # @fn       def columns # {{{
+  # @brief    Long form [ [ x0, x1, ... ], [ y0, ... ], [ z0, ... ] ] of the window
+  #
+  # @returns  [Array]                   Three Arrays of floats
+  def columns
+    @matrix.columns( @marker, @center, @from, to )
+  end # of def columns }}}
+
+
+  # @fn       def interleaved # {{{
+  # @brief    Packed [ x0, y0, z0, x1, ... ] rows of the window, the layout of the native kernels
+  #
+  # @returns  [String]                  Packed ( "d*" ) String of 3 * length values
+  def interleaved
+    @matrix.interleaved( @marker, @center, @from, to )
+  end # of def interleaved }}}
+
+
+  # @fn       def coordinates # {{{
+  # @brief    Short form [ [ x, y, z ], ... ] of the window
+  #
+  # @returns  [Array]                   Array of arrays, [ [x,y,z],[..]...]
+  def coordinates
+    @matrix.coordinates( @marker, @center, @from, to )
+  end # of def coordinates }}}
+
+  alias :to_a :coordinates
+
+
+  attr :matrix, :marker, :center, :from, :length
+end # of class FrameView # }}}
+
+
+# Direct Invocation (local testing) # {{{
+if __FILE__ == $0
+end # of if __FILE__ == $0 }}}
+
+# vim:ts=2:tw=100:wm=100
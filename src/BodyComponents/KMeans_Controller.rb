@@ -15,55 +15,106 @@
 # @file       KMeans_Controller.rb
 # @author     Bjoern Rennhak
 #
-# @brief      This class is a simple worker to scale over all CPU's for K-Means analysis.
+# @brief      This class runs K-Means restarts on a pool of forked worker processes to scale over
+#             all CPU's. The corpus is packed once before forking and shared read-only
+#             (copy-on-write) with all workers, results come back over one pipe per worker as
+#             binary records (see KMeans_Worker, KMeans_Sink).
 #
 #######
 
 
-require 'rubygems'
-require 'ffi-rzmq'
-# require 'zmq'
-
-
 # @class      class KMeans_Controller # {{{
-# @brief      Encapsulates K-Means computation
+# @brief      Forks the workers, hands out the restarts and collects the results
 class KMeans_Controller
 
-  # {{{
-  def initialize logger = nil
-
+  # @fn       def initialize options, logger, final, k, restarts, workers # {{{
+  # @brief    Runs all restarts and waits for every worker (no sleeps, no kills, no ports). Restart r
+  #           is seeded from ( clustering_seed, r ) and goes to worker r % workers, so the results
+  #           do not depend on the number of workers.
+  #
+  # @param    [OpenStruct]  options     Options OpenStruct processed by the parse_cmd_arguments function
+  # @param    [Logger]      logger      Logger instance
+  # @param    [Array]       final       Array filled with subarrays of the form [ [x,y,z], [x,y,z]...]
+  # @param    [Integer]     k           Number of clusters
+  # @param    [Integer]     restarts    Number of K-Means restarts
+  # @param    [Integer]     workers     Number of worker processes
+  def initialize options, logger, final, k, restarts, workers
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Final should be a non empty Array of the form [ [x,y,z],...]" unless( final.is_a?( Array ) and not final.empty? and final.first.is_a?( Array ) )
+    raise ArgumentError, "Restarts should be a positive Integer, but is (#{restarts.to_s})" unless( restarts.is_a?( Integer ) and restarts >= 1 )
+    # }}}
+
+    @options    = options
     @logger     = logger
+    @workers    = [ [ workers.to_i, 1 ].max, restarts ].min
+
+    @logger.message :info, "Starting K-Means worker pool (workers: #{@workers.to_s}) (restarts: #{restarts.to_s})"
 
-    @logger.message :info, "Starting ZMQ K-Means controller"
+    # packed once, the forked workers read the same pages
+    n, d        = final.length, final.first.length
+    corpus      = final.flatten.collect { |v| v.to_f }.pack( "d*" )
 
-    context = ZMQ::Context.new(1)
+    pids        = []
+    channels    = []
 
-    # Socket to send messages on
-    sender = context.socket(ZMQ::PUSH)
-    sender.bind("tcp://*:5557")
+    @workers.times do |id|
+      reader, writer    = IO.pipe
+      reader.binmode
+      writer.binmode
 
-    # puts "Press enter when the workers are ready"
-    # $stdin.read(1)
-    # puts "Sending tasks to workers"
+      pids << fork do
+        # only keep our own end of our own pipe
+        reader.close
+        channels.each { |channel| channel.close }
 
-    # The first message is "0" and signals start of batch
-    sender.send_string('0')
+        status  = 0
 
-    # Send 100 tasks
-    total_msec = 0 # Total expected cost in msecs
-    100.times do
-      @logger.message :info, "Sending time to workers"
-      workload = rand(100) + 1
-      total_msec += workload
-      $stdout << "#{workload}."
-      sender.send_string(workload.to_s)
+        begin
+          KMeans_Worker.new( @options, @logger, id, ( id...restarts ).step( @workers ).to_a, k, corpus, n, d, writer )
+        rescue Exception => e
+          @logger.message :error, "KMeans_Worker (id: #{id.to_s}) failed (#{e.message})"
+          status = 1
+        end
+
+        writer.close unless( writer.closed? )
+        exit!( status )
+      end
+
+      writer.close
+      channels << reader
     end
 
-    @logger.message :info, "Total expected cost: #{total_msec.to_s} msec"
-    Kernel.sleep(1) # Give 0MQ time to deliver
+    # reading until every worker closed its pipe, then reaping them
+    @sink       = KMeans_Sink.new( @logger, channels )
+
+    failed      = pids.select { |pid| not Process.wait2( pid ).last.success? }
+    raise ArgumentError, "#{failed.length.to_s} K-Means worker(s) failed" unless( failed.empty? )
+    raise ArgumentError, "Expected #{restarts.to_s} K-Means results, but got #{@sink.restarts.length.to_s}" unless( @sink.restarts == ( 0...restarts ).to_a )
 
   end # def initialize }}}
 
+
+  # @fn       def kms # {{{
+  # @brief    Labels of every restart (restart order)
+  def kms
+    @sink.kms
+  end # of def kms }}}
+
+
+  # @fn       def tmp_distortions # {{{
+  # @brief    Distortion (sum of squared distances) of every restart (restart order)
+  def tmp_distortions
+    @sink.tmp_distortions
+  end # of def tmp_distortions }}}
+
+
+  # @fn       def tmp_centroids # {{{
+  # @brief    Centroid positions [ [x,y,z], ... ] of every restart (restart order)
+  def tmp_centroids
+    @sink.tmp_centroids
+  end # of def tmp_centroids }}}
+
 end # of class KMeans_Controller # }}}
 
 # vim:ts=2:tw=100:wm=100
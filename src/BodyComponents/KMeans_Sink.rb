@@ -15,65 +15,93 @@
 # @file       KMeans_Sink.rb
 # @author     Bjoern Rennhak
 #
-# @brief      This class is a simple worker to scale over all CPU's for K-Means analysis.
+# @brief      This class collects the binary K-Means results of all workers (see KMeans_Worker).
 #
 #######
 
 
-require 'rubygems'
-require 'ffi-rzmq'
-require 'json'
-
-
 # @class      class KMeans_Sink # {{{
-# @brief      Encapsulates K-Means computation
+# @brief      Decodes the records of every worker pipe, in restart order
 class KMeans_Sink
 
-  # {{{
-  def initialize logger = nil, workers
+  # @fn       def initialize logger, channels # {{{
+  # @brief    Reads all channels at the same time (IO.select, see Pipeline_Pool#map) until every
+  #           worker closed its pipe, so no worker waits on a full pipe for the others.
+  #
+  # @param    [Logger]    logger      Logger instance
+  # @param    [Array]     channels    Read ends of the worker pipes
+  def initialize logger = nil, channels
 
     @logger     = logger
-    @workers    = workers
 
-    @logger.message :info, "Starting ZMQ K-Means Sink to collect results from #{workers.to_s} workers"
+    @logger.message :info, "Starting K-Means Sink to collect results from #{channels.length.to_s} workers"
 
-    # Prepare our context and socket
-    context = ZMQ::Context.new(1)
-    receiver = context.socket(ZMQ::PULL)
-    receiver.bind("tcp://*:5558")
+    tstart      = Time.now
+    results     = []
 
-    tstart = Time.now
+    buffers     = Hash.new        # channel => buffer
+    channels.each { |channel| buffers[ channel ] = String.new( "", encoding: Encoding::BINARY ) }
 
-    @tmp_centroids = []
-    @tmp_distortions  = []
-    @kms  = []
+    until( buffers.empty? )
+      IO.select( buffers.keys ).first.each do |channel|
+        begin
+          buffers[ channel ] << channel.read_nonblock( 1 << 16 )
+          next
+        rescue IO::WaitReadable
+          next
+        rescue EOFError
+          # worker closed its pipe, it is done (or dead)
+        end
 
-    # Process 100 confirmations
-    ( workers.to_i - 1 ).times do |task_nbr|
-      message = ""
-      receiver.recv_string( message )
-      kms, dist, cent = *( JSON.parse( message ) )
-
-      cent.collect! do |c|
-          c.collect! do |inner|
-            Centroid.new( inner )
-          end
+        results.concat( decode( buffers.delete( channel ) ) )
+        channel.close
       end
-
-      @kms.concat( kms )
-      @tmp_distortions.concat( dist )
-      @tmp_centroids.concat( cent )
     end
 
+    results.sort_by! { |restart, distortion, labels, centroids| restart }
+
+    @restarts         = results.collect { |restart, distortion, labels, centroids| restart }
+    @tmp_distortions  = results.collect { |restart, distortion, labels, centroids| distortion }
+    @kms              = results.collect { |restart, distortion, labels, centroids| labels }
+    @tmp_centroids    = results.collect { |restart, distortion, labels, centroids| centroids }
+
     # Calculate and report duration of batch
-    tend = Time.now
-    total_msec = (tend-tstart) * 1000
+    tend        = Time.now
+    total_msec  = ( tend - tstart ) * 1000
     @logger.message :info, "Total elapsed time: #{total_msec} msec"
 
   end # def initialize }}}
 
-  attr        :kms, :tmp_distortions, :tmp_centroids
-  attr_reader :done
+
+  # @fn       def decode buffer # {{{
+  # @brief    Splits the bytes of one worker into its records
+  #
+  # @param    [String]    buffer      Everything a worker wrote
+  #
+  # @returns  [Array]                 Subarrays [ restart, distortion, labels, centroids [ [x,y,z], ... ] ]
+  def decode buffer
+
+    records     = []
+    offset      = 0
+
+    while( offset < buffer.bytesize )
+      raise ArgumentError, "Truncated K-Means result header" if( ( buffer.bytesize - offset ) < 24 )
+
+      restart, n, k, d  = buffer.byteslice( offset, 16 ).unpack( "l4" )
+      distortion        = buffer.byteslice( offset + 16, 8 ).unpack( "d" ).first
+      labels            = buffer.byteslice( offset + 24, 4 * n ).unpack( "l*" )
+      centroids         = buffer.byteslice( offset + 24 + 4 * n, 8 * k * d ).unpack( "d*" ).each_slice( d ).to_a
+
+      raise ArgumentError, "Truncated K-Means result of restart #{restart.to_s}" unless( labels.length == n and centroids.length == k )
+
+      records          << [ restart, distortion, labels, centroids ]
+      offset           += 24 + 4 * n + 8 * k * d
+    end
+
+    records
+  end # of def decode }}}
+
+  attr_reader :kms, :tmp_distortions, :tmp_centroids, :restarts
 end # of class KMeans_Sink # }}}
 
 # vim:ts=2:tw=100:wm=100
@@ -20,67 +20,49 @@
 #######
 
 
-require 'rubygems'
-require 'ffi-rzmq'
-require 'json'
-
-
 # @class      class KMeans_Worker # {{{
-# @brief      Encapsulates K-Means computation
+# @brief      Encapsulates K-Means computation, runs in a process forked by KMeans_Controller
 class KMeans_Worker
 
-  # {{{
-  def initialize options, logger, id, iterations, k, final
+  # @fn       def initialize options, logger, id, restarts, k, corpus, n, d, writer # {{{
+  # @brief    Runs the given restarts on the shared corpus and writes one binary record per restart
+  #
+  #             [ restart, n, k, d ] ( int32 ), distortion ( double ), labels ( n x int32 ), centroids ( k x d doubles )
+  #
+  # @param    [OpenStruct]  options     Options OpenStruct processed by the parse_cmd_arguments function
+  # @param    [Logger]      logger      Logger instance
+  # @param    [Integer]     id          Worker id
+  # @param    [Array]       restarts    Restart indices of this worker
+  # @param    [Integer]     k           Number of clusters
+  # @param    [String]      corpus      Packed ( "d*" ) n x d points
+  # @param    [Integer]     n           Number of points
+  # @param    [Integer]     d           Dimensions of every point
+  # @param    [IO]          writer      Write end of this worker's pipe, closed when done
+  def initialize options, logger, id, restarts, k, corpus, n, d, writer
 
     @options  = options
     @logger   = logger
     @id       = id
 
-    @logger.message :info, "Starting ZMQ K-Means Worker (id: #{@id.to_s}) (iterations: #{iterations.to_s})"
-
-    context     = ZMQ::Context.new(1)
-
-    # # Socket to receive messages on
-    # receiver    = context.socket(ZMQ::PULL)
-    # receiver.connect("tcp://*:5557")
-
-    # Socket to send messages to
-    sender      = context.socket(ZMQ::PUSH)
-    sender.connect("tcp://*:5558")
-
-    kms                 = []
-    tmp_distortions     = []
-    tmp_centroids       = []
-
-    iterations.to_i.times do |i|
+    @logger.message :info, "Starting K-Means Worker (id: #{@id.to_s}) (restarts: #{restarts.length.to_s})"
 
-      clustering                  = Clustering.new( @options )
-      kmeans, centroids           = clustering.kmeans( final, k ) # , centroids )
-      kms                        << kmeans
-      distances                   = clustering.distances( final, centroids ) # Hash with   hash[ data index ] =  [ [ centroid_id, eucleadian distance ], ... ] 
+    clustering    = Clustering.new( @options )
 
-      closest_centroids           = clustering.closest_centroids( distances, centroids, final ) # array with subarrays of each [ centroid_id, distance ]
-      distortions                 = clustering.distortions( closest_centroids )
-      tcss                        = clustering.total_within_cluster_sum_of_squares( closest_centroids )
+    restarts.each do |restart|
+      labels, centroids, distortion   = clustering.kmeans_seeded( corpus, n, d, k, restart, @options.clustering_seed.to_i )
 
-      # Serialize the centroid class instances 
-      cents = []
-      centroids.each { |c| cents << c.position }
-
-
-      tmp_distortions << distortions
-      tmp_centroids << cents
-
-      puts "[ID: #{@id.to_s}] K-Means iteration #{i.to_s} of #{iterations.to_s} - Distortion: #{distortions.to_s}"
+      # pipe is binary, the parts are written as they are (no String concatenation across encodings)
+      writer.write( [ restart, n, k, d ].pack( "l4" ) )
+      writer.write( [ distortion ].pack( "d" ) )
+      writer.write( labels )
+      writer.write( centroids )
 
+      @logger.message :debug, "KMeans_Worker (id: #{@id.to_s}) restart #{restart.to_s} - Distortion: #{distortion.to_s}"
     end
 
-    payload = [ kms, tmp_distortions, tmp_centroids ].to_json
-
-    sender.send_string( payload )
+    writer.close
 
     @logger.message :info, "KMeans_Worker (id :#{@id.to_s}) finished"
-
   end # def initialize }}}
 
 end # of class KMeans_Worker # }}}
@@ -92,4 +74,3 @@ if __FILE__ == $0
 end
 
 # vim:ts=2:tw=100:wm=100
-
@@ -26,8 +26,8 @@ require 'gsl'
 # Warning: Including this line will cause everything to break.
 # include GSL
 
-# FIXME: Reimplement this with bindings to C libs instead
-# require 'c/c_mathematics'
+# Native kernels (SWIG), build with "rake compile" - see c/README
+require_relative 'c/c_mathematics'
 
 # @class    class Mathematics # {{{
 # @brief    The class Mathematics provides helpful functions to calculate various things needed throughout this project
@@ -74,6 +74,10 @@ class Mathematics
   #
   # @returns  [Segment]               Segment dP which is the new closest point for all frames f
   #
+  # @note     Earlier versions stored a*c - b*b in d, overwriting d = u.w, and then used the
+  #           overwritten d in both branches. sc and tc were therefore wrong for every frame, not
+  #           only for almost parallel lines. All CPA results (and the T-Data built on them) differ
+  #           from the ones computed before this fix.
   # @note     http://softsurfer.com/Archive/algorithm_0106/algorithm_0106.htm
   def distance_of_line_to_line line1_pt0 = nil, line1_pt1 = nil, line2_pt0 = nil, line2_pt1 = nil
 
@@ -99,20 +103,20 @@ class Mathematics
     d = u.dot_product( w )
     e = v.dot_product( w )
 
-    d = []
+    denominator = []
 
-    0.upto( a.length - 1 ) { |index| d[index] = ( (a[index] * c[index]) - (b[index] * b[index]) ) } # always >=0
+    0.upto( a.length - 1 ) { |index| denominator[index] = ( (a[index] * c[index]) - (b[index] * b[index]) ) } # always >=0
     sc, tc    = [], []  # array of floats
 
     0.upto( a.length - 1 ) do |index|
       # compute the line parameters of the two closest points
-      if( d[index] < 0.00000001 )   # lines almost parallel
+      if( denominator[index] < 0.00000001 )   # lines almost parallel
         sc[index] = 0.0
         tc[index] = ( b[index] > c[index] ) ? ( d[index] / b[index] ) : ( e[index] / c[index] )  # use largest denominator
       else
-        sc[index] = ( ( b[index] * e[index] ) - ( c[index] * d[index] ) ) / d[index]
-        tc[index] = ( ( a[index] * e[index] ) - ( b[index] * d[index] ) ) / d[index]
-      end # of if( d[index] < 0.00000001 )
+        sc[index] = ( ( b[index] * e[index] ) - ( c[index] * d[index] ) ) / denominator[index]
+        tc[index] = ( ( a[index] * e[index] ) - ( b[index] * d[index] ) ) / denominator[index]
+      end # of if( denominator[index] < 0.00000001 )
     end # of 0.upto
 
     # get the difference of the two closest points for all frames
@@ -125,6 +129,50 @@ class Mathematics
   end # of def distance_3D_line_to_line }}}
 
 
+  # @fn       def closest_point_of_approach line1_pt0, line1_pt1, line2_pt0, line2_pt1, center = nil # {{{
+  # @brief    Same as distance_of_line_to_line, but on plain coordinates of all frames in one native call
+  #           (see c/utils/c_cpa.c) instead of Segment arithmetic.
+  #
+  # @param    [Array]     line1_pt0   Array of arrays, [ [x,y,z],[..]...] for line 1 point 0
+  # @param    [Array]     line1_pt1   Array of arrays, [ [x,y,z],[..]...] for line 1 point 1
+  # @param    [Array]     line2_pt0   Array of arrays, [ [x,y,z],[..]...] for line 2 point 0
+  # @param    [Array]     line2_pt1   Array of arrays, [ [x,y,z],[..]...] for line 2 point 1
+  # @param    [Array]     center      Array of arrays, [ [x,y,z],[..]...] the points are made relative to (optional)
+  #
+  # @returns  [Array]                 Array of arrays, [ [x,y,z],[..]...] the difference of the two closest points for all frames f
+  #
+  # @note     All points may also be given as packed ( "d*" ) Strings [ x0, y0, z0, x1, ... ], e.g. FrameMatrix#interleaved
+  # @note     http://softsurfer.com/Archive/algorithm_0106/algorithm_0106.htm
+  def closest_point_of_approach line1_pt0 = nil, line1_pt1 = nil, line2_pt0 = nil, line2_pt1 = nil, center = nil
+
+    lines   = [ line1_pt0, line1_pt1, line2_pt0, line2_pt1 ]
+    packed  = line1_pt0.is_a?( String )
+    length  = lambda { |line| ( line.is_a?( String ) ) ? line.bytesize / 24 : line.length }
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Line points can't be nil." if( lines.any? { |line| line.nil? } )
+    raise ArgumentError, "Line points need to be all packed Strings or all Arrays" unless( ( lines + [ center ] ).compact.all? { |line| line.is_a?( String ) == packed } )
+    raise ArgumentError, "Packed line points need to hold [ x, y, z ] rows" if( packed and not ( lines + [ center ] ).compact.all? { |line| line.bytesize % 24 == 0 } )
+    raise ArgumentError, "All line points and the center need to have the same number of frames" unless( ( lines + [ center ] ).compact.all? { |line| length.call( line ) == length.call( line1_pt0 ) } )
+    raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" unless( packed or line1_pt0.all? { |point| point.length == 3 } )
+    # }}}
+
+    frames  = length.call( line1_pt0 )
+    cpa     = "\0" * ( 24 * frames )
+    center  = "\0" * ( 24 * frames ) if( center.nil? )
+    buffers = ( lines + [ center ] ).collect { |line| ( line.is_a?( String ) ) ? line : line.flatten.pack( "d*" ) }
+
+    raise ArgumentError, "Line points need to hold #{frames.to_s} [ x, y, z ] rows" unless( buffers.all? { |buffer| buffer.bytesize == 24 * frames } )
+
+    result  = C_mathematics.c_closest_point_of_approach( *buffers, frames, cpa )
+
+    # Post-condition check
+    raise ArgumentError, "Closest point of approach could not be calculated (#{result.to_s})" unless( result == frames )
+
+    cpa.unpack( "d*" ).each_slice( 3 ).to_a
+  end # of def closest_point_of_approach }}}
+
+
   # @fn       def eucledian_distance point1, point2 # {{{
   # @brief    The eucledian_distance function takes two points in R^3 (x,y,z) and calculates the distance between them.
   #           You can easily derive this function via Pythagoras formula. P1,P2 \elem R^3
@@ -180,26 +228,281 @@ class Mathematics
   end # of def eucledian_distance point1, point2 }}}
 
 
-  # @fn       def eucledian_distance_window data = nil, points = nil # {{{
+  # @fn       def soa data = nil # {{{
+  # @brief    The function soa packs a given dataset (x1,y1,z1;..) as structure of arrays, one
+  #           contiguous float64 buffer per axis, for the batched distance kernels in
+  #           c/utils/c_mathematics.c
+  #
+  # @param    [Array]   data    Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns  [Array]           Array, containing the three packed ( "d*" ) Strings [ x, y, z ]
+  def soa data = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"     if( data.nil? )
+    raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" unless( data.all? { |point| point.length == 3 } )
+    # }}}
+
+    return [ "", "", "" ] if( data.empty? )
+
+    data.transpose.collect { |axis| axis.pack( "d*" ) }
+  end # of def soa data }}}
+
+
+  # @fn       def eucledian_distances data = nil # {{{
+  # @brief    The function eucledian_distances calculates the distances between all consecutive
+  #           points of a given dataset (x1,y1,z1;..) in one native call.
+  #
+  # @param    [Array]   data    Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns  [Array]           Array, containing data.length - 1 floats, index i is the distance of point i and i+1
+  def eucledian_distances data = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"     if( data.nil? )
+    # }}}
+
+    return [] if( data.length < 2 )
+
+    x, y, z   = *soa( data )
+    distances = "\0" * ( 8 * ( data.length - 1 ) )
+    result    = C_mathematics.c_eucledian_distances_consecutive( x, y, z, data.length, distances )
+
+    # Post-condition check
+    raise ArgumentError, "Consecutive distances could not be calculated (#{result.to_s})" unless( result == data.length - 1 )
+
+    distances.unpack( "d*" )
+  end # of def eucledian_distances data }}}
+
+
+  # @fn       def eucledian_distances_pairwise data1 = nil, data2 = nil # {{{
+  # @brief    The function eucledian_distances_pairwise calculates the point to point distances
+  #           between two datasets of the same length in one native call.
+  #
+  # @param    [Array]   data1   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  # @param    [Array]   data2   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns  [Array]           Array, containing floats, index i is the distance of data1[i] and data2[i]
+  def eucledian_distances_pairwise data1 = nil, data2 = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"     if( data1.nil? or data2.nil? )
+    raise ArgumentError, "Both datasets need to have the same length (#{data1.length.to_s} vs. #{data2.length.to_s})" unless( data1.length == data2.length )
+    # }}}
+
+    return [] if( data1.empty? )
+
+    x1, y1, z1  = *soa( data1 )
+    x2, y2, z2  = *soa( data2 )
+    distances   = "\0" * ( 8 * data1.length )
+    result      = C_mathematics.c_eucledian_distances_pairwise( x1, y1, z1, x2, y2, z2, data1.length, distances )
+
+    # Post-condition check
+    raise ArgumentError, "Pairwise distances could not be calculated (#{result.to_s})" unless( result == data1.length )
+
+    distances.unpack( "d*" )
+  end # of def eucledian_distances_pairwise data1, data2 }}}
+
+
+  # @fn       def eucledian_distances_to_centroids data = nil, centroids = nil # {{{
+  # @brief    The function eucledian_distances_to_centroids calculates the distance matrix of all
+  #           points of a given dataset to all given centroids in one native call.
+  #
+  # @param    [Array]   data        Array of arrays, in the form of [ [x,y,z],[..]...] .
+  # @param    [Array]   centroids   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns  [Array]               Array, containing one subarray per data point with the distances to each centroid
+  def eucledian_distances_to_centroids data = nil, centroids = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"       if( data.nil? )
+    raise ArgumentError, "Centroids cannot be nil"  if( centroids.nil? )
+    # }}}
+
+    return Array.new( data.length ) { [] } if( data.empty? or centroids.empty? )
+
+    x, y, z     = *soa( data )
+    cx, cy, cz  = *soa( centroids )
+    distances   = "\0" * ( 8 * data.length * centroids.length )
+    result      = C_mathematics.c_eucledian_distances_to_centroids( x, y, z, data.length, cx, cy, cz, centroids.length, distances )
+
+    # Post-condition check
+    raise ArgumentError, "Centroid distances could not be calculated (#{result.to_s})" unless( result == data.length * centroids.length )
+
+    # native matrix is centroid major
+    distances.unpack( "d*" ).each_slice( data.length ).to_a.transpose
+  end # of def eucledian_distances_to_centroids data, centroids }}}
+
+
+  # @fn       def eucledian_distances_sum data1 = nil, data2 = nil # {{{
+  # @brief    The function eucledian_distances_sum sums up the distances of all points of data1 to all
+  #           points of data2 without building the full distance matrix.
+  #
+  # @param    [Array]   data1   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  # @param    [Array]   data2   Array of arrays, in the form of [ [x,y,z],[..]...] or the output of soa( data2 ) if it has been packed already
+  #
+  # @returns  [Float]           Float, the summed distances
+  def eucledian_distances_sum data1 = nil, data2 = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil"     if( data1.nil? or data2.nil? )
+    # }}}
+
+    x1, y1, z1  = *soa( data1 )
+    x2, y2, z2  = *( ( data2.first.is_a?( String ) ) ? ( data2 ) : ( soa( data2 ) ) )
+    length2     = x2.bytesize / 8
+
+    raise ArgumentError, "Packed data2 needs three axes of #{length2.to_s} doubles" unless( [ x2, y2, z2 ].all? { |axis| axis.is_a?( String ) and axis.bytesize == 8 * length2 } and x2.bytesize % 8 == 0 )
+
+    result      = C_mathematics.c_eucledian_distances_sum( x1, y1, z1, data1.length, x2, y2, z2, length2, "\0" * ( 8 * length2 ) )
+
+    # Post-condition check
+    raise ArgumentError, "Summed distances could not be calculated (#{result.to_s})" if( result < 0 )
+
+    result
+  end # of def eucledian_distances_sum data1, data2 }}}
+
+
+  # @fn       def kdtree data = nil # {{{
+  # @brief    The function kdtree builds a KD-tree over a given dataset (x1,y1,z1;.. or any n x d) once
+  #           (c/utils/c_kdtree.c). The tree is one packed ( "d*" ) String, it can be kept around (or
+  #           marshalled) and queried with kdtree_nearest and kdtree_radius.
+  #
+  # @param    [Array]   data    Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns  [String]          Packed tree buffer
+  def kdtree data = nil
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data cannot be nil or empty"  if( data.nil? or data.empty? )
+    raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" unless( data.all? { |point| point.length == data.first.length } )
+    # }}}
+
+    tree      = "\0" * ( 8 * C_mathematics.c_kdtree_size( data.length, data.first.length ) )
+    result    = C_mathematics.c_kdtree_build( data.flatten.collect { |v| v.to_f }.pack( "d*" ), data.length, data.first.length, tree )
+
+    # Post-condition check
+    raise ArgumentError, "KD-tree could not be built (#{result.to_s})" unless( result == data.length )
+
+    tree
+  end # of def kdtree data }}}
+
+
+  # @fn       def kdtree_nearest tree = nil, queries = nil, k = 1 # {{{
+  # @brief    The function kdtree_nearest finds the k nearest points of the tree for many queries in
+  #           one native call, closest first (equal distances by index).
+  #
+  # @param    [String]  tree      Output of kdtree
+  # @param    [Array]   queries   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  # @param    [Integer] k         Neighbours per query
+  #
+  # @returns  [Array]             [ indices, distances ] - one subarray of ( at most ) k values per query
+  def kdtree_nearest tree = nil, queries = nil, k = 1
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Tree cannot be nil"     if( tree.nil? )
+    raise ArgumentError, "Queries cannot be nil"  if( queries.nil? )
+
+    dimensions = kdtree_dimensions( tree )
+    raise ArgumentError, "Queries have not the dimension of the tree (#{dimensions.to_s})" unless( queries.all? { |query| query.length == dimensions } )
+    raise ArgumentError, "K must be a positive integer"  unless( k.is_a?( Integer ) and k >= 1 )
+    # }}}
+
+    return [ [], [] ] if( queries.empty? )
+
+    indices   = "\0" * ( 8 * queries.length * k )
+    distances = "\0" * ( 8 * queries.length * k )
+    result    = C_mathematics.c_kdtree_nearest( tree, queries.flatten.collect { |v| v.to_f }.pack( "d*" ), queries.length, k, indices, distances )
+
+    # Post-condition check
+    raise ArgumentError, "Nearest neighbours could not be calculated (#{result.to_s})" unless( result == queries.length )
+
+    # unused slots ( k > n ) are -1
+    [ indices.unpack( "d*" ).each_slice( k ).collect { |row| row.reject { |i| i < 0 }.collect { |i| i.to_i } }, distances.unpack( "d*" ).each_slice( k ).collect { |row| row.reject { |d| d < 0 } } ]
+  end # of def kdtree_nearest tree, queries, k }}}
+
+
+  # @fn       def kdtree_radius tree = nil, queries = nil, radius = nil, max = 64 # {{{
+  # @brief    The function kdtree_radius finds the points of the tree within radius of many queries
+  #           in one native call, closest first. At most max points are returned per query (the
+  #           closest ones), a result of exactly max points may have been cut.
+  #
+  # @param    [String]  tree      Output of kdtree
+  # @param    [Array]   queries   Array of arrays, in the form of [ [x,y,z],[..]...] .
+  # @param    [Float]   radius    Search radius (inclusive)
+  # @param    [Integer] max       Maximum number of points per query
+  #
+  # @returns  [Array]             [ indices, distances ] - one subarray per query
+  def kdtree_radius tree = nil, queries = nil, radius = nil, max = 64
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Tree cannot be nil"     if( tree.nil? )
+    raise ArgumentError, "Queries cannot be nil"  if( queries.nil? )
+
+    dimensions = kdtree_dimensions( tree )
+    raise ArgumentError, "Queries have not the dimension of the tree (#{dimensions.to_s})" unless( queries.all? { |query| query.length == dimensions } )
+    raise ArgumentError, "Radius must be a non negative number"  unless( radius.is_a?( Numeric ) and radius >= 0 )
+    raise ArgumentError, "Max must be a positive integer"  unless( max.is_a?( Integer ) and max >= 1 )
+    # }}}
+
+    return [ [], [] ] if( queries.empty? )
+
+    counts    = "\0" * ( 8 * queries.length )
+    indices   = "\0" * ( 8 * queries.length * max )
+    distances = "\0" * ( 8 * queries.length * max )
+    result    = C_mathematics.c_kdtree_radius( tree, queries.flatten.collect { |v| v.to_f }.pack( "d*" ), queries.length, radius.to_f, max, counts, indices, distances )
+
+    # Post-condition check
+    raise ArgumentError, "Radius query could not be calculated (#{result.to_s})" unless( result == queries.length )
+
+    counts    = counts.unpack( "d*" ).collect { |c| c.to_i }
+
+    [ indices.unpack( "d*" ).each_slice( max ).each_with_index.collect { |row, q| row.first( counts[ q ] ).collect { |i| i.to_i } }, distances.unpack( "d*" ).each_slice( max ).each_with_index.collect { |row, q| row.first( counts[ q ] ) } ]
+  end # of def kdtree_radius tree, queries, radius, max }}}
+
+
+  # @fn       def path_length_index data = nil # {{{
+  # @brief    The function path_length_index builds the cumulative arc length of a given dataset
+  #           (x1,y1,z1;..) once. Any summed distance over the frames [a, b) is then answered as
+  #           index[b] - index[a] (see c/utils/c_path_length.c).
+  #
+  # @param   [Array]    data      Array of arrays, in the form of [ [x,y,z],[..]...] .
+  #
+  # @returns [String]             Packed float64 buffer ( "d*" ) containing data.length prefix values.
+  def path_length_index data = nil
+
+    # Input verification {{{
+    raise ArgumentError, "Data cannot be nil"     if( data.nil? )
+    raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" unless( data.all? { |point| point.length == 3 } )
+    # }}}
+
+    index   = "\0" * ( 8 * data.length )
+    result  = C_mathematics.c_path_length_index( data.flatten.pack( "d*" ), data.length, index )
+
+    raise ArgumentError, "Path length index could not be built (#{result.to_s})" unless( result == data.length )
+
+    index
+  end # of def path_length_index }}}
+
+
+  # @fn       def eucledian_distance_window data = nil, points = nil, index = nil # {{{
   # @brief    The function eucledian_distance_window takes a given dataset (x1,y1,z1;..) and calculates the
   #           eucleadian distance for given points in both directions like a window function. That means that
   #           with e.g. points = 5 ; 5 points before point X and 5 points after X are measured and summed up.
+  #           At the beginning (end) of the frames only the points after (before) X are included.
   #
   # @param   [Array]    data      Array of arrays, in the form of [ [x,y,z],[..]...] .
   # @param   [Integer]  points    Accepts integer of how many points before and after should be included in the calculation
+  # @param   [String]   index     Optional, output of path_length_index( data ) if it has been built already
   #
   # @returns [Array]              Array, conaining floats. Each index of the array corresponds to the data frame.
-  #
-  # @todo Refactor this code more nicely.
-  def eucledian_distance_window data = nil, points = nil
+  def eucledian_distance_window data = nil, points = nil, index = nil
 
     # Input verification {{{
     raise ArgumentError, "Data cannot be nil"     if( data.nil? )
     raise ArgumentError, "Points cannot be nil"   if( points.nil? )
     # }}}
 
-    distances = []
-
     if( data.first.length == 4 )
 
       puts "WARNING - got data with 4 slots ---------------------"
@@ -223,70 +526,16 @@ class Mathematics
     raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" if( data.length == 3 )
     raise ArgumentError, "Data has not the right shape should be  [ [x,y,z],[..]...]" unless( data.first.length == 3 )
 
-    d = data
-
-    d.each_index do |index|
-      from  = nil
-      to    = nil
-      sum   = 0
-
-      if( (index.to_i - points.to_i) < 0 ) 
-        # we are at the beginning of the frames - just include the first points
-        from  = index
-        to    = index + points
-        ( eval( "#{from.to_s}...#{to.to_s}" ) ).each do |n|
-          if( d[n].length == 3 and d[n+1].length == 3 )
-            #puts "d[n]: #{d[n].join(", ").to_s}"
-            #puts "d[n+1]: #{d[n+1].join(", ").to_s}"
-            sum += eucledian_distance( d[n], d[n+1] )
-          else
-            puts "Data has not the right shape (should be a 3D point) not (from idx: #{from.to_s} to idx: #{to.to_s} -> n: #{n.to_s} n+1: #{(n+1).to_s} -> d[n]: #{d[n].to_s} d[n+1]: #{d[n+1].to_s}"
-            #puts "Data has not the right shape (should be a 3D point) not (from idx: #{from.to_s} to idx: #{to.to_s} -> n: #{n.to_s} n+1: #{(n+1).to_s} -> d[n]: #{d[n].join(",").to_s} d[n+1]: #{d[n+1].join(",").to_s}"
-            raise ArgumentError, "Error"
-          end
-        end
-        distances[ index ] = sum
-        next
-      end
+    # Cumulative arc length is built once, each window is the difference of two prefix values
+    index         = path_length_index( data ) if( index.nil? )
+    distances     = "\0" * ( 8 * data.length )
 
-      if( (index.to_i + points.to_i > (d.length-1)) )
-        # we are at the end of the frames - just include the last points
-        from  = index - points
-        to    = index
-        ( eval( "#{from.to_s}...#{to.to_s}" ) ).each do |n|
-          if( d[n].length == 3 and d[n+1].length == 3 )
-            #puts "d[n]: #{d[n].join(", ").to_s}"
-            #puts "d[n+1]: #{d[n+1].join(", ").to_s}"
-
-            sum += eucledian_distance( d[n], d[n+1] ) 
-          else
-            puts "Data has not the right shape (should be a 3D point) not (from idx: #{from.to_s} to idx: #{to.to_s} -> n: #{n.to_s} n+1: #{(n+1).to_s} -> d[n]: #{d[n].join(",").to_s} d[n+1]: #{d[n+1].join(",").to_s}"
-            raise ArgumentError, "Error"
-          end
-        end
-        distances[ index ] = sum
-        next
-      end
+    raise ArgumentError, "Path length index should hold #{data.length.to_s} values" unless( index.bytesize == 8 * data.length )
+    result        = C_mathematics.c_path_length_window( index, data.length, points.to_i, distances )
 
-      from  = index - points
-      to    = index + points
+    raise ArgumentError, "Eucledian distance window could not be calculated (#{result.to_s})" unless( result == data.length )
 
-      ( eval( "#{from.to_s}...#{to.to_s}" ) ).each do |n| 
-        if( d[n].length == 3 and d[n+1].length == 3 )
-          #puts "d[n]: #{d[n].join(", ").to_s}"
-          #puts "d[n+1]: #{d[n+1].join(", ").to_s}"
-
-          sum += eucledian_distance( d[n], d[n+1] )
-        else
-            puts "Data has not the right shape (should be a 3D point) not (from idx: #{from.to_s} to idx: #{to.to_s} -> n: #{n.to_s} n+1: #{(n+1).to_s} -> d[n]: #{d[n].join(",").to_s} d[n+1]: #{d[n+1].join(",").to_s}"
-            raise ArgumentError, "Error"
-        end
-      end
-
-      distances[ index ] = sum
-    end
-
-    distances
+    distances.unpack( "d*" )
   end # of def eucledian_distance_window data, points }}}
 
 
@@ -405,10 +654,12 @@ class Mathematics
 
 
   # @fn       def derivative input, h = 10**(-7) # {{{
-  # The function takes an Array of input and calculates the derivative with the given step size h
+  # The function takes an Array of input and calculates the derivative of a natural cubic spline
+  # fitted through it (frames 0..n-1) at every frame.
   #
   # @param  [Array] input   Array, containing the input of the data which we want the derivative
-  # @param  [Float] h       Stepsize h, most of the time you want a small epsilon such as 
+  # @param  [Float] h       Stepsize h of the former numerical approximation, kept for compatibility.
+  #                         The derivative is now taken analytically from the spline (see spline_derivatives).
   # @return [Array]         
   #
   # http://stackoverflow.com/questions/1559695/implementing-the-derivative-in-c-c
@@ -434,32 +685,48 @@ class Mathematics
     # }}}
 
     # Main
-    derivative      = []
-    frames          = []
+    derivative, second, third = *( spline_derivatives( [ input ] ).first )
+
+    # Post-condition check
+    raise ArgumentError, "The function result should be of type Array, but is (#{derivative.class.to_s})" unless( derivative.is_a?(Array) )
+
+    derivative
+  end # of def derivative }}}
 
-    # Prepare a GSL Spline
-    spline          = GSL::Spline.alloc( "cspline", input.length )
 
-    # Generate frame steps for fitting
-    0.upto( input.length - 1 ) { |i| frames << (i) } # i*h
+  # @fn       def spline_derivatives signals, frames = nil # {{{
+  # @brief    Fits a natural cubic spline (GSL "cspline") once through every signal and returns its
+  #           analytic first, second and third derivative at each frame. All signals share the
+  #           same frame axis, so the spline system is only factorized once for the whole batch.
+  #
+  # @param    [Array]   signals   Array of signals of equal length, [ [ y0, y1, ... ], ... ]
+  # @param    [Array]   frames    Frame axis (strictly increasing), defaults to 0..n-1
+  #
+  # @returns  [Array]             One [ first, second, third ] derivative triple per signal
+  def spline_derivatives signals, frames = nil
 
-    # Fit a spline to the input data
-    spline.init( GSL::Vector.alloc( frames ), GSL::Vector.alloc( input ) )
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument signals should be of type Array, but is (#{signals.class.to_s})" unless( signals.is_a?( Array ) )
+    raise ArgumentError, "Signals cannot be empty" if( signals.empty? )
+    raise ArgumentError, "All signals need to be Arrays of the same, non zero length" unless( signals.all? { |s| s.is_a?( Array ) and s.length == signals.first.length } and not signals.first.empty? )
+    raise ArgumentError, "The argument frames should be nil or an Array of #{signals.first.length.to_s} values" unless( frames.nil? or ( frames.is_a?( Array ) and frames.length == signals.first.length ) )
+    # }}}
 
-    # Calculate derivative by numerical approximation
-    ( 0..(input.length - 1) ).step( h ) do |step|
+    n           = signals.first.length
+    frames      = ( 0...n ).to_a if( frames.nil? )
 
-      # A simple three-point estimation is to compute the slope of a nearby secant line through the
-      # points (x-h,f(x-h)) and (x+h,f(x+h))
-      deriv         = ( spline.eval( step.to_f + h ) - spline.eval( step.to_f - h ) ) / ( 2 * h )
-      derivative   << deriv if( (step % 1) == 0.0 )
-    end
+    d1, d2, d3  = Array.new( 3 ) { "\0" * ( 8 * n * signals.length ) }
+
+    written     = C_mathematics.c_spline_derivatives( frames.collect { |x| x.to_f }.pack( "d*" ), n, signals.flatten.collect { |y| y.to_f }.pack( "d*" ), signals.length, d1, d2, d3 )
+    raise ArgumentError, "Spline derivatives failed, the frame axis has to be strictly increasing" unless( written == n * signals.length )
+
+    result      = [ d1, d2, d3 ].collect { |d| d.unpack( "d*" ).each_slice( n ).to_a }.transpose
 
     # Post-condition check
-    raise ArgumentError, "The function result should be of type Array, but is (#{derivative.class.to_s})" unless( derivative.is_a?(Array) )
+    raise ArgumentError, "There should be one derivative triple per signal" unless( result.length == signals.length )
 
-    derivative
-  end # of def derivative }}}
+    result
+  end # of def spline_derivatives }}}
 
 
   # @fn       def angle_between_two_lines line1_point1 = nil, line1_point2 = nil, line2_point1 = nil, line2_point2 = nil # {{{
@@ -525,6 +792,30 @@ class Mathematics
     return ( (u1*v1) + (u2*v2) + (u3*v3) )
   end # of def dot_product }}} 
 
+
+  private
+
+  # @fn       def kdtree_dimensions tree # {{{
+  # @brief    Checks that a String is a complete KD-tree buffer before it goes to the native code. The
+  #           tree starts with its number of points and dimensions (c/utils/c_kdtree.c), n x d values
+  #           follow, garbage (NaN, huge) headers are kept out of the size calculation.
+  #
+  # @param    [String]  tree      Output of kdtree (or anything else)
+  #
+  # @returns  [Integer]           Dimensions of the tree points
+  def kdtree_dimensions tree
+
+    raise ArgumentError, "Tree is not a KD-tree buffer" unless( tree.is_a?( String ) and tree.bytesize >= 16 )
+
+    points, dimensions = tree.unpack( "d2" )
+    raise ArgumentError, "Tree is not a KD-tree buffer" unless( ( points >= 1 and points <= tree.bytesize / 8 ) and ( dimensions >= 1 and dimensions <= tree.bytesize / ( 8 * points ) ) )
+
+    points, dimensions = points.to_i, dimensions.to_i
+    raise ArgumentError, "Tree is not a KD-tree buffer" unless( tree.bytesize >= 8 * C_mathematics.c_kdtree_size( points, dimensions ) )
+
+    dimensions
+  end # of def kdtree_dimensions }}}
+
 end # of class Mathematics }}}
 
 # Direct Invocation (local testing) # {{{
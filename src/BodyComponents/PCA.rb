@@ -27,6 +27,9 @@ require 'narray'
 # Libraries: Plotting
 require 'gnuplot'
 
+# Native kernels (SWIG), build with "rake compile" - see c/README
+require_relative 'c/c_mathematics'
+
 
 # The class PCA provides the functionality of calculating the Principle Component Analysis for given vectors.
 # For details please see here: http://en.wikipedia.org/wiki/Principal_component_analysis
@@ -149,7 +152,7 @@ class PCA # {{{
     x_bar, y_bar  = mean( set1 ), mean( set2 )
     divisor       = 0.0
 
-    0.upto( set1.length ) do |i|
+    0.upto( set1.length - 1 ) do |i|
 
       xx          = set1[i].to_f - x_bar
       yy          = set2[i].to_f - y_bar
@@ -253,6 +256,14 @@ class PCA # {{{
   # input: e.g. [ [1,2,3], [2,3,4], [5,6,7] ]
   # shape: n x n
   #
+  # The data is read only once by a native Welford accumulator (c/utils/c_covariance.c) instead of
+  # calling covariance for every (i,j) pair.
+  #
+  # Note: covariance used to loop 0.upto( set1.length ), one index past the end. The nil element
+  # became 0.0 and added an extra x_bar * y_bar term to every entry. The accumulator (and the fixed
+  # covariance) do not have it, so every covariance matrix, and all PCA results derived from it,
+  # differ from the ones computed before.
+  #
   # @param    [GSL::Matrix] input   Accepts a GSL::Matrix type where each column is one dimension and each row is a data set
   # @returns  [GSL::Matrix]         Covariance matrix of the type GSL::Matrix with the rank nxn
   def covariance_matrix input # {{{
@@ -267,23 +278,173 @@ class PCA # {{{
     #         | a3 b3 c3 d3 |
 
     # Since x denotes the input dimensions (n) our covariance matrix will be of rank n x n
-    y, x    = input.shape      # determine rank
+    result  = covariance_matrix_from_accumulator( covariance_accumulator( input ) )
+
+    # Post-condition check
+    raise ArgumentError, "Result should be of type GSL::Matrix, but it is (#{result.class.to_s})" unless( result.is_a?( GSL::Matrix ) )
+
+    result
+  end # def covmatrix }}}
+
+
+  # The function covariance_accumulator reads the rows of input once and adds them to a (new or given)
+  # covariance accumulator. Accumulators of different chunks of the same data (e.g. done in
+  # parallel) can be combined with merge_covariance_accumulators.
+  #
+  # @param    [GSL::Matrix] input         Accepts a GSL::Matrix (or Array of rows) where each column is one dimension and each row is a data set
+  # @param    [String]      accumulator   Optional, output of a previous covariance_accumulator call which should be continued
+  # @returns  [String]                    Packed ( "d*" ) accumulator [ d, n, mean, M2 ]
+  def covariance_accumulator input, accumulator = nil # {{{
+
+    rows        = ( input.is_a?( GSL::Matrix ) ) ? ( input.to_a ) : ( input )
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Input should be of type GSL::Matrix or Array, but it is (#{input.class.to_s})" unless( rows.is_a?( Array ) )
+    raise ArgumentError, "Input rows should all have the same number of dimensions" unless( rows.all? { |row| row.length == rows.first.length } )
+    raise ArgumentError, "Input cannot be empty without a given accumulator" if( rows.empty? and accumulator.nil? )
+    raise ArgumentError, "Accumulator is not a covariance accumulator" if( not accumulator.nil? and not covariance_accumulator?( accumulator ) )
+    # }}}
 
-    result  = GSL::Matrix.alloc( x, x )
+    dimensions  = ( rows.empty? ) ? ( accumulator.unpack( "d" ).first.to_i ) : ( rows.first.length )
+
+    if( accumulator.nil? )
+      accumulator = "\0" * ( 8 * C_mathematics.c_covariance_accumulator_size( dimensions ) )
+      C_mathematics.c_covariance_init( dimensions, accumulator )
+    end
 
-    # Fill the covariance matrix according to the schema of pdf page 8
-    0.upto( x-1 ) do |i|
-      0.upto( x-1 ) do |j|
-        result[i,j] = covariance( input.column(i).to_a, input.column(j).to_a )
-      end # 0.upto( x-1 ) do |j|
-    end # of 0.upto( x-1 ) do |i|
+    packed      = rows.flatten.pack( "d*" )
+    raise ArgumentError, "Input should hold #{rows.length.to_s} x #{dimensions.to_s} values" unless( packed.bytesize == 8 * rows.length * dimensions )
 
+    result      = C_mathematics.c_covariance_accumulate( packed, rows.length, dimensions, accumulator )
 
     # Post-condition check
-    raise ArgumentError, "Result should be of type GSL::Matrix, but it is (#{result.class.to_s})" unless( result.is_a?( GSL::Matrix ) )
+    raise ArgumentError, "Covariance accumulator could not be updated, dimensions do not match (#{result.to_s})" if( result < 0 )
+
+    accumulator
+  end # of def covariance_accumulator }}}
+
+
+  # The function covariance_accumulator? checks that a String is a complete covariance accumulator,
+  # its dimension header has to match its length before it may be handed to the native code
+  #
+  # @param    [String]      accumulator   Output of covariance_accumulator (or anything else)
+  # @returns  [Boolean]                   True if the native code can use it as an accumulator
+  def covariance_accumulator? accumulator # {{{
+
+    return false unless( accumulator.is_a?( String ) and accumulator.bytesize >= 8 )
+
+    # d * d values follow the header, this also keeps garbage (NaN, huge) headers out of the size calculation
+    dimensions  = accumulator.unpack( "d" ).first
+
+    return false unless( dimensions >= 1 and dimensions <= Math.sqrt( accumulator.bytesize / 8 ) )
+
+    accumulator.bytesize == 8 * C_mathematics.c_covariance_accumulator_size( dimensions.to_i )
+  end # of def covariance_accumulator? }}}
+
+
+  # The function merge_covariance_accumulators combines two covariance accumulators of the same
+  # dimension as if all rows had been added to one accumulator.
+  #
+  # @param    [String]      accumulator   Output of covariance_accumulator
+  # @param    [String]      other         Output of covariance_accumulator
+  # @returns  [String]                    Packed ( "d*" ) merged accumulator
+  def merge_covariance_accumulators accumulator, other # {{{
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Accumulator is not a covariance accumulator" unless( covariance_accumulator?( accumulator ) )
+    raise ArgumentError, "Other is not a covariance accumulator" unless( covariance_accumulator?( other ) )
+    # }}}
+
+    result      = accumulator.dup
+    count       = C_mathematics.c_covariance_merge( result, other )
+
+    # Post-condition check
+    raise ArgumentError, "Covariance accumulators could not be merged, dimensions do not match (#{count.to_s})" if( count < 0 )
 
     result
-  end # def covmatrix }}}
+  end # of def merge_covariance_accumulators }}}
+
+
+  # The function covariance_matrix_from_accumulator turns an accumulator into the sample covariance matrix
+  #
+  # @param    [String]      accumulator   Output of covariance_accumulator or merge_covariance_accumulators
+  # @returns  [GSL::Matrix]               Covariance matrix of the type GSL::Matrix with the rank nxn
+  def covariance_matrix_from_accumulator accumulator # {{{
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Accumulator is not a covariance accumulator" unless( covariance_accumulator?( accumulator ) )
+    # }}}
+
+    x           = accumulator.unpack( "d" ).first.to_i
+    covariance  = "\0" * ( 8 * x * x )
+    result      = C_mathematics.c_covariance_matrix( accumulator, covariance )
+
+    # Post-condition check
+    raise ArgumentError, "Covariance matrix needs at least two data sets (#{result.to_s})" unless( result == x * x )
+
+    GSL::Matrix.alloc( covariance.unpack( "d*" ), x, x )
+  end # of def covariance_matrix_from_accumulator }}}
+
+
+  # The function moment_index builds the cumulative sums of x and of the outer products x * x^T of
+  # all rows once (c/utils/c_moments.c). With it window_moments answers the mean and covariance of
+  # any [from, to] frame window in O(d^2), regardless of the window length.
+  #
+  # @param    [GSL::Matrix] input   Accepts a GSL::Matrix (or Array of rows) where each column is one dimension and each row is a frame
+  # @returns  [String]              Packed ( "d*" ) prefix moment index
+  def moment_index input # {{{
+
+    rows        = ( input.is_a?( GSL::Matrix ) ) ? ( input.to_a ) : ( input )
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Input should be of type GSL::Matrix or Array, but it is (#{input.class.to_s})" unless( rows.is_a?( Array ) )
+    raise ArgumentError, "Input cannot be empty" if( rows.empty? )
+    raise ArgumentError, "Input rows should all have the same number of dimensions" unless( rows.all? { |row| row.length == rows.first.length } )
+    # }}}
+
+    dimensions  = rows.first.length
+    index       = "\0" * ( 8 * C_mathematics.c_moment_index_size( rows.length, dimensions ) )
+    packed      = rows.flatten.pack( "d*" )
+    raise ArgumentError, "Input should hold #{rows.length.to_s} x #{dimensions.to_s} values" unless( packed.bytesize == 8 * rows.length * dimensions )
+
+    result      = C_mathematics.c_moment_index( packed, rows.length, dimensions, index )
+
+    # Post-condition check
+    raise ArgumentError, "Moment index could not be built (#{result.to_s})" unless( result == rows.length )
+
+    index
+  end # of def moment_index }}}
+
+
+  # The function window_moments returns mean and covariance of the frames from..to (inclusive) out
+  # of a moment index
+  #
+  # @param    [String]      index   Output of moment_index
+  # @param    [Integer]     from    First frame of the window
+  # @param    [Integer]     to      Last frame of the window
+  # @returns  [Array]               Array containing the mean (Array) as first and the covariance matrix (GSL::Matrix) as second element
+  def window_moments index, from, to # {{{
+
+    # Pre-condition check
+    raise ArgumentError, "Index is not a moment index" unless( index.is_a?( String ) and index.bytesize >= 16 )
+
+    # ( n + 1 ) x d values follow the header at least, this also keeps garbage (NaN, huge) headers out of the size calculation
+    dimensions, frames  = index.unpack( "d2" )
+    raise ArgumentError, "Index is not a moment index" unless( ( dimensions >= 1 and dimensions <= index.bytesize / 8 ) and ( frames >= 1 and frames <= index.bytesize / ( 8 * dimensions ) ) )
+
+    dimensions, frames  = dimensions.to_i, frames.to_i
+    raise ArgumentError, "Index is not a moment index" unless( index.bytesize == 8 * C_mathematics.c_moment_index_size( frames, dimensions ) )
+    raise ArgumentError, "Window #{from.to_s}..#{to.to_s} is not inside of the indexed frames 0..#{(frames - 1).to_s}" unless( from.is_a?( Integer ) and to.is_a?( Integer ) and ( 0 <= from ) and ( from <= to ) and ( to < frames ) )
+
+    mean                = "\0" * ( 8 * dimensions )
+    covariance          = "\0" * ( 8 * dimensions * dimensions )
+    result              = C_mathematics.c_moment_window( index, from, to, mean, covariance )
+
+    # Post-condition check
+    raise ArgumentError, "Window moments could not be calculated (#{result.to_s})" unless( result == to - from + 1 )
+
+    [ mean.unpack( "d*" ), GSL::Matrix.alloc( covariance.unpack( "d*" ), dimensions, dimensions ) ]
+  end # of def window_moments }}}
 
 
   # The function substract_mean will ajust the data to be useable for PCA. This is done by
@@ -379,8 +540,9 @@ class PCA # {{{
   #
   # @param    [Array]   input               Input is array of arrays. Each sub-array contains integers or floats. e.g. [ [x1, x2, x3,...], [y1,y2,y3,....], [z1,z2,....]] 
   # @param    [Integer] reduce_dimensions   Integer, number of dimension which to reduce from the original. Resulting dimensions are n-p in total (n = orign. dimensions, p = dimensions to reduce).
+  # @param    [GSL::Matrix] cov_matrix      Optional, covariance matrix of input if it is known already (e.g. from window_moments)
   # @returns  [Array]                       An array containing "Array of arrays" with data as first, eigen_values as second and finally eigen_vectors as last element, e.g. [ Array, GSL::Eigen::EigenVectors, GSL::Eigen:EigenVectors ] 
-  def do_pca input, reduce_dimensions # {{{
+  def do_pca input, reduce_dimensions, cov_matrix = nil # {{{
 
     # Pre-condition check {{{
     # raise ArgumentError, "Data needs to be of the shape [ [x1,x2,..xn], [y1,y2,..yn], [z1,z2,...zn] ] but it is has ( #{input.length.to_s} ) elements" unless( input.length == 3 )
@@ -398,13 +560,10 @@ class PCA # {{{
     matrix                          = GSL::Matrix.alloc( *input ).transpose
 
     # Determine the covariance matrix from the mean reduced input
-    cov_matrix                      = covariance_matrix( matrix )
-
-    # Extract eigen-values and -vectors via GSL
-    eigen_values, eigen_vectors     = cov_matrix.eigen_symmv
+    cov_matrix                      = covariance_matrix( matrix ) if( cov_matrix.nil? )
 
-    # Sort in-place the eigen-vectors or importance (most to least)
-    GSL::Eigen.symmv_sort eigen_values, eigen_vectors, GSL::Eigen::SORT_VAL_DESC
+    # Extract eigen-values and -vectors, sorted by importance (most to least)
+    eigen_values, eigen_vectors     = eigen_symmetric( cov_matrix )
 
     # Calculate the finaldata with all eigenvectors
     if( reduce_dimensions <= 0 )
@@ -441,14 +600,101 @@ class PCA # {{{
 
     # Post-condition check {{{
     raise ArgumentError, "Result variable should be of type Array, but is (#{result.class.to_s})" unless( result.is_a?(Array) )
-    raise ArgumentError, "Eigen values variable should be of type GSL::Eigen::EigenValues, but is (#{eigen_values.class.to_s})" unless( eigen_values.is_a?(GSL::Eigen::EigenValues) )
-    raise ArgumentError, "Eigen vectors variable should be of type GSL::Eigen::EigenVectors, but is (#{eigen_vectors.class.to_s})" unless( eigen_vectors.is_a?(GSL::Eigen::EigenVectors) )
+    raise ArgumentError, "Eigen values variable should be of type GSL::Vector, but is (#{eigen_values.class.to_s})" unless( eigen_values.is_a?(GSL::Vector) )
+    raise ArgumentError, "Eigen vectors variable should be of type GSL::Matrix, but is (#{eigen_vectors.class.to_s})" unless( eigen_vectors.is_a?(GSL::Matrix) )
     # }}}
 
     [ result, eigen_values, eigen_vectors ]
   end # of def do_pca }}}
 
 
+  # The function eigen_symmetric extracts eigen-values and -vectors of a (small) symmetric matrix, e.g. a
+  # covariance matrix, with the native Jacobi solver in c/utils/c_eigen.c (no allocation, d <= 64).
+  # The eigen pairs are sorted by importance (most to least) like GSL::Eigen.symmv_sort with SORT_VAL_DESC.
+  #
+  # @param    [GSL::Matrix] matrix  Symmetric matrix of rank d x d
+  # @returns  [Array]               Array containing the eigen values (GSL::Vector) as first and the eigen vectors (GSL::Matrix, one per column) as second element
+  def eigen_symmetric matrix # {{{
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Input should be of type GSL::Matrix, but it is (#{matrix.class.to_s})" unless( matrix.is_a?( GSL::Matrix ) )
+    raise ArgumentError, "Input should be a square matrix, but it is of size #{matrix.size1.to_s}x#{matrix.size2.to_s}" unless( matrix.size1 == matrix.size2 )
+    # }}}
+
+    dimensions    = matrix.size1
+    values        = "\0" * ( 8 * dimensions )
+    vectors       = "\0" * ( 8 * dimensions * dimensions )
+    result        = C_mathematics.c_eigen_symmetric( matrix.to_a.flatten.pack( "d*" ), dimensions, values, vectors )
+
+    # Post-condition check
+    raise ArgumentError, "Eigen system could not be solved for a #{dimensions.to_s}x#{dimensions.to_s} matrix (#{result.to_s})" if( result < 0 )
+
+    [ GSL::Vector.alloc( values.unpack( "d*" ) ), GSL::Matrix.alloc( vectors.unpack( "d*" ), dimensions, dimensions ) ]
+  end # of def eigen_symmetric }}}
+
+
+  # The function sliding_pca performs a local PCA over a window of frames before and after every frame
+  # (c/utils/c_sliding_pca.c). The window covariance is updated incrementally as frames enter and leave
+  # and the eigen basis is carried over from frame to frame, so this is O(n * d^3) instead of running
+  # do_pca for every window.
+  #
+  # @param    [Array]   data        Array of arrays in short form, one row [x1,y1,z1,x2,...] of d values per frame
+  # @param    [Integer] window      Number of frames before and after each frame
+  # @param    [Integer] components  Number of local principal components to project each frame on
+  # @returns  [Array]               Array containing the local eigen value spectra (one descending array of d values per frame) as first and the local coordinates (one array of components values per frame) as second element
+  def sliding_pca data, window, components = 3 # {{{
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be of type Array, but is (#{data.class.to_s})" unless( data.is_a?( Array ) )
+    raise ArgumentError, "Data cannot be empty" if( data.empty? )
+    raise ArgumentError, "Data rows should all have the same number of dimensions" unless( data.all? { |row| row.length == data.first.length } )
+    raise ArgumentError, "Window needs to be a positive integer" unless( window.is_a?( Integer ) and window >= 0 )
+    raise ArgumentError, "Components need to be between 1 and #{data.first.length.to_s}" unless( components.is_a?( Integer ) and ( 1..data.first.length ).include?( components ) )
+    # }}}
+
+    frames, dimensions  = data.length, data.first.length
+    spectra             = "\0" * ( 8 * frames * dimensions )
+    projected           = "\0" * ( 8 * frames * components )
+    packed              = data.flatten.pack( "d*" )
+
+    raise ArgumentError, "Data should hold #{frames.to_s} x #{dimensions.to_s} values" unless( packed.bytesize == 8 * frames * dimensions )
+
+    result              = C_mathematics.c_sliding_pca( packed, frames, dimensions, window, components, spectra, projected )
+
+    # Post-condition check
+    raise ArgumentError, "Sliding window PCA failed (#{result.to_s})" unless( result == frames )
+
+    [ spectra.unpack( "d*" ).each_slice( dimensions ).to_a, projected.unpack( "d*" ).each_slice( components ).to_a ]
+  end # of def sliding_pca }}}
+
+
+  # The function intrinsic_dimensionality counts for every local spectrum how many principal components are
+  # needed to explain the given fraction of the variance (e.g. output of sliding_pca).
+  #
+  # @param    [Array]   spectra   Array of arrays, descending eigen values per frame
+  # @param    [Float]   energy    Fraction of the total variance which needs to be explained (0 < energy <= 1)
+  # @returns  [Array]             Array of integers, local intrinsic dimensionality per frame
+  def intrinsic_dimensionality spectra, energy = 0.9 # {{{
+
+    # Pre-condition check
+    raise ArgumentError, "Energy needs to be in (0, 1]" unless( energy > 0 and energy <= 1 )
+
+    spectra.collect do |values|
+      total       = values.inject( 0.0 ) { |sum, value| sum + [ value, 0.0 ].max }
+      explained   = 0.0
+      dimensions  = 0
+
+      values.each do |value|
+        break if( explained >= energy * total and dimensions > 0 )
+        explained  += [ value, 0.0 ].max
+        dimensions += 1
+      end
+
+      dimensions
+    end
+  end # of def intrinsic_dimensionality }}}
+
+
   # The function array_of_arrays_to_eigensystem converts the external data structure of type "array of arrays" to a eigensystem (GSL)
   #
   # @param    [Array]   data  Array of arrays. Each sub-array contains integers or floats
@@ -527,33 +773,30 @@ class PCA # {{{
   # "Change of basis to principal axis"
   #
   # @param    [Array]                    pca_result    Output from the do_pca function - the pca transformed data
-  # @param    [GSL::Eigen::EigenValues]  eigen_values  Output from the do_pca function - the extracted eigen_values of the pca input data
-  # @param    [GSL::Eigen::EigenVectors] eigen_vectors Output from the do_pca function - the extracted eigen_vectors (principle components) of the pca processed data
+  # @param    [GSL::Vector]              eigen_values  Output from the do_pca function - the extracted eigen_values of the pca input data
+  # @param    [GSL::Matrix]              eigen_vectors Output from the do_pca function - the extracted eigen_vectors (principle components) of the pca processed data
   # @returns  [Array]                                  Array of arrays - Transformed data to the new principle component based basis ready for use with the gnuplot functions.
   def transform_basis pca_result, eigen_values, eigen_vectors # {{{
 
     # Pre-condition check {{{
     raise ArgumentError, "Result variable should be of type Array, but is (#{pca_result.class.to_s})" unless( pca_result.is_a?(Array) )
-    raise ArgumentError, "Eigen values variable should be of type GSL::Eigen::EigenValues, but is (#{eigen_values.class.to_s})" unless( eigen_values.is_a?(GSL::Eigen::EigenValues) )
-    raise ArgumentError, "Eigen vectors variable should be of type GSL::Eigen::EigenVectors, but is (#{eigen_vectors.class.to_s})" unless( eigen_vectors.is_a?(GSL::Eigen::EigenVectors) )
+    raise ArgumentError, "Eigen values variable should be of type GSL::Vector, but is (#{eigen_values.class.to_s})" unless( eigen_values.is_a?(GSL::Vector) )
+    raise ArgumentError, "Eigen vectors variable should be of type GSL::Matrix, but is (#{eigen_vectors.class.to_s})" unless( eigen_vectors.is_a?(GSL::Matrix) )
+    raise ArgumentError, "Eigen vectors should be a square matrix, but it is of size #{eigen_vectors.size1.to_s}x#{eigen_vectors.size2.to_s}" unless( eigen_vectors.size1 == eigen_vectors.size2 )
+    raise ArgumentError, "Result variable should hold #{eigen_vectors.size1.to_s} components of the same length" unless( pca_result.length == eigen_vectors.size1 and pca_result.all? { |component| component.length == pca_result.first.length } )
     # }}}
 
-    # establish identity matrix "C"
-    original_basis          = GSL::Matrix.identity( eigen_vectors.size1 )
-
-    # create matrix with all eigen_vectors and invert it
-    new_basis               = eigen_vectors             # "D"
-    new_basis_inv           = eigen_vectors.invert      # "D^{-1}"
-
-    # T = D^{-1} * C 
-    transformation_matrix   = new_basis_inv * original_basis
+    # The eigen vectors are orthonormal, so D^{-1} = D^T and T = D^T * C with C the identity ("original basis")
+    dimensions              = eigen_vectors.size1
+    rows                    = pca_result.first.length
+    projected               = "\0" * ( 8 * rows * dimensions )
+    result                  = C_mathematics.c_eigen_project( eigen_vectors.to_a.flatten.pack( "d*" ), dimensions, dimensions, pca_result.transpose.flatten.pack( "d*" ), rows, projected )
 
-    # Transform data
-    result_final            = ( transformation_matrix * GSL::Matrix.alloc( *pca_result ) )
+    raise ArgumentError, "Change of basis failed (#{result.to_s})" unless( result == rows )
 
-    # You could verify that this is correct by =>  T^{-1} * result_final = result
-    # result_final            = result_final.to_na.to_a
-    result_final            = result_final.to_a
+    # Transform data (back into the long form, one row per principal component)
+    # You could verify that this is correct by =>  D * result_final = result
+    result_final            = projected.unpack( "d*" ).each_slice( dimensions ).to_a.transpose
 
     # Post-condition check
     raise ArgumentError, "Result should be of type Array, but is of (#{result_final.class.to_s})" unless( result_final.is_a?(Array) )
@@ -51,16 +51,7 @@ class Physics
     # }}}
 
     # Main
-    result        = []
-
-
-    all_distances = @mathematics.eucledian_distance_window( data.dup, points ) 
-
-    data.each_index do |i|
-      if( i <= (data.length - 2) )
-        result[ i ]     = all_distances[ i ].to_f / ( capturingIntervall.to_f * points )
-      end
-    end
+    result        = kinematics( data, 1.0, points, capturingIntervall ).first
 
     # Post-condition check
     raise ArgumentError, "Result of this function is supposed to be of type Array, but it is of (#{result.class.to_s})" unless( result.is_a?(Array) )
@@ -86,14 +77,7 @@ class Physics
     # }}}
 
     # Main
-    result        = []
-    v             = velocity( data, points, capturingIntervall )
-
-    data.each_index do |i|
-      if( i <= (data.length - 2) )
-        result[ i ]     = v[i] / ( capturingIntervall.to_f * points )
-      end
-    end # of data.each_index
+    result        = kinematics( data, 1.0, points, capturingIntervall )[1]
 
     # Post-condition check
     raise ArgumentError, "Result of this function should be of type Array, but is (#{result.class.to_s})" unless( result.is_a?( Array ) )
@@ -121,16 +105,7 @@ class Physics
     # }}}
 
     # Main
-    result        = []
-
-    a             = acceleration( data.dup, points, capturingIntervall )
-    v             = velocity( data.dup, points, capturingIntervall )
-
-    data.each_index do |i|
-      if( i <= (data.length - 2) )
-        result[ i ]     = mass * a[i] * v[i]
-      end
-    end # of data.each_index
+    result        = kinematics( data, mass, points, capturingIntervall )[2]
 
     # Post-condition check
     raise ArgumentError, "Result of this function should be of type Array, but is (#{result.class.to_s})" unless( result.is_a?( Array ) )
@@ -139,33 +114,27 @@ class Physics
   end # of def power data }}}
 
 
-  # @fn       def energy data, mass, points # {{{
+  # @fn       def energy data, mass, points, capturingIntervall = 0.08333 # {{{
   # @brief    The function energy calculates the phyiscal energy at each point for the data
   #
   # @param    [Array]   data                Accepts array of arrays in the shape of [ [x1,y1,z1], ...]
   # @param    [Float]   mass                Accepts float, representing the mass of the components involved (relative to 100% = full body)
   # @param    [Integer] points              Determines how many points should be used for the overall acceleration calculation
+  # @param    [Float]   capturingIntervall  Accepts float, representing the capture intervall of the motion capture equipment
   # @returns  [Array]                       Array containing corresponding energy values for the frames n and n+1 
-  def energy data, mass, points
+  def energy data, mass, points, capturingIntervall = 0.08333
 
     # Pre-condition check {{{
     raise ArgumentError, "The argument data should be of type Array, but it is of (#{data.class.to_s})" unless( data.is_a?( Array ) )
     raise ArgumentError, "The argument mass should be of type Float, but it is of (#{mass.class.to_s})" unless( mass.is_a?( Float ) )
     raise ArgumentError, "The argument points should be of type Integer, but it is of (#{points.class.to_s})" unless( points.is_a?( Integer ) )
+    raise ArgumentError, "The argument capturingIntervall should be of type float, but it is of (#{capturingIntervall.class.to_s})" unless( capturingIntervall.is_a?( Float ) )
     raise ArgumentError, "Data must be in the shape [ [x1,y1,z1], [...], ...]" if( data.length == 3 )
     # }}}
 
     # Main
-    result    = []
-    v         = velocity( data.dup, points )
-
-    data.each_index do |i|
-      if( i <= (data.length - 2) )
-        # Kinetic energy    E_kin = 0.5 * m * v^2
-        e_kin = 0.5 * mass * ( v[ i ].to_f ** 2 )
-        result[ i ] = e_kin
-      end
-    end
+    # Kinetic energy    E_kin = 0.5 * m * v^2
+    result    = kinematics( data, mass, points, capturingIntervall )[3]
 
     # Post-condition check
     raise ArgumentError, "Result of this function should be of type Array, but is (#{result.class.to_s})" unless( result.is_a?( Array ) )
@@ -173,6 +142,50 @@ class Physics
     result
   end # of def energy data }}}
 
+
+  # @fn       def kinematics data, mass, points, capturingIntervall = 0.08333 # {{{
+  # @brief    The function kinematics calculates velocity, acceleration, power and kinetic energy
+  #           (and their first and second derivatives over the frames) in one native pass over
+  #           the windowed path length, instead of recomputing it for every quantity.
+  #
+  # @param    [Array]   data                Accepts array of arrays in the shape of [ [x1,y1,z1], ...]
+  #                                         or the packed output of Mathematics#path_length_index
+  # @param    [Float]   mass                Accepts float, representing the mass of the components involved (relative to 100% = full body)
+  # @param    [Integer] points              Determines how many points should be used for the overall distance window
+  # @param    [Float]   capturingIntervall  Accepts float, representing the capture intervall of the motion capture equipment
+  # @returns  [Array]                       Array of 12 Arrays for the frames n and n+1:
+  #                                         [ v, a, p, e, v', a', p', e', v'', a'', p'', e'' ]
+  def kinematics data, mass, points, capturingIntervall = 0.08333
+
+    # Pre-condition check {{{
+    raise ArgumentError, "The argument data should be of type Array or String, but it is of (#{data.class.to_s})" unless( data.is_a?( Array ) or data.is_a?( String ) )
+    raise ArgumentError, "The argument mass should be of type Float, but it is of (#{mass.class.to_s})" unless( mass.is_a?( Float ) )
+    raise ArgumentError, "The argument points should be of type Integer, but it is of (#{points.class.to_s})" unless( points.is_a?( Integer ) )
+    raise ArgumentError, "The argument capturingIntervall should be of type float, but it is of (#{capturingIntervall.class.to_s})" unless( capturingIntervall.is_a?( Float ) )
+    raise ArgumentError, "Data must be in the shape [ [x1,y1,z1], [...], ...]" if( data.is_a?( Array ) and data.length == 3 )
+    raise ArgumentError, "Packed data should be a path length index of doubles" if( data.is_a?( String ) and data.bytesize % 8 != 0 )
+    # }}}
+
+    # Main
+    index         = ( data.is_a?( String ) ) ? ( data ) : ( @mathematics.path_length_index( data ) )
+    frames        = index.bytesize / 8
+    rows          = frames - 1
+
+    return Array.new( 12 ) { [] } if( rows < 1 )
+
+    out           = "\0" * ( 8 * 12 * rows )
+    written       = C_mathematics.c_kinematics( index, frames, points, capturingIntervall, mass, out )
+
+    raise ArgumentError, "Kinematics could not be calculated (#{written.to_s})" unless( written == rows )
+
+    result        = out.unpack( "d*" ).each_slice( rows ).to_a
+
+    # Post-condition check
+    raise ArgumentError, "Result of this function should contain 12 columns, but has (#{result.length.to_s})" unless( result.length == 12 )
+
+    result
+  end # of def kinematics data }}}
+
 end # of class Physics }}}
 
 
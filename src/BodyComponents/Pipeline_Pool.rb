@@ -0,0 +1,151 @@
+#!/usr/bin/ruby19
+#
+
+###
+#
+# File: Pipeline_Pool.rb
+#
+######
+
+
+###
+#
+# (c) 2012, Copyright, Bjoern Rennhak, The University of Tokyo
+#
+# @file       Pipeline_Pool.rb
+# @author     Bjoern Rennhak
+#
+# @brief      This class runs independent per configuration pipelines (load, filter, T-Data
+#             extraction) on a bounded pool of forked processes. Every task gets its own process
+#             which sends its result back marshalled over a pipe and exits, so at most "workers"
+#             configurations are in memory on the worker side at any time. Results are returned in
+#             task order, independent of the number of workers and of which task finishes first.
+#
+#######
+
+
+# @class      class Pipeline_Pool # {{{
+# @brief      Forks one process per task, at most workers at a time, and collects the results in order
+class Pipeline_Pool
+
+  # @fn       def initialize logger, workers # {{{
+  # @brief    Custom constructor for the Pipeline_Pool class
+  #
+  # @param    [Logger]      logger      Logger instance
+  # @param    [Integer]     workers     Maximum number of tasks in flight
+  def initialize logger, workers
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Logger cannot be nil" if( logger.nil? )
+    # }}}
+
+    @logger     = logger
+    @workers    = [ workers.to_i, 1 ].max
+  end # of def initialize }}}
+
+
+  # @fn       def map tasks, &block # {{{
+  # @brief    Runs the block for every task in a forked process, the return value of the block has
+  #           to be marshallable. A free slot is refilled as soon as a task finished, the parent
+  #           drains all pipes while waiting so large results never block a worker.
+  #
+  # @param    [Array]       tasks       Arguments handed to the block, one task per element
+  #
+  # @returns  [Array]                   Results of the block in the order of tasks
+  def map tasks, &block
+
+    # Pre-condition check {{{
+    raise ArgumentError, "Tasks should be an Array, but is (#{tasks.class.to_s})" unless( tasks.is_a?( Array ) )
+    raise ArgumentError, "A block is needed" unless( block_given? )
+    # }}}
+
+    return [] if( tasks.empty? )
+
+    @logger.message :info, "Starting pipeline pool (workers: #{[ @workers, tasks.length ].min.to_s}) (tasks: #{tasks.length.to_s})"
+
+    results     = Array.new( tasks.length )
+    done        = Array.new( tasks.length, false )
+    running     = Hash.new        # reader => [ index, pid, buffer ]
+    queue       = ( 0...tasks.length ).to_a
+    failed      = []
+
+    until( queue.empty? and running.empty? )
+
+      while( running.length < @workers and not queue.empty? )
+        index               = queue.shift
+        reader, pid         = spawn( index, tasks[ index ], running.keys, &block )
+        running[ reader ]   = [ index, pid, String.new( "", encoding: Encoding::BINARY ) ]
+      end
+
+      IO.select( running.keys ).first.each do |reader|
+        index, pid, buffer  = running[ reader ]
+
+        begin
+          buffer << reader.read_nonblock( 1 << 16 )
+          next
+        rescue IO::WaitReadable
+          next
+        rescue EOFError
+          # worker closed its pipe, it is done (or dead)
+        end
+
+        reader.close
+        running.delete( reader )
+
+        if( Process.wait2( pid ).last.success? and not buffer.empty? )
+          results[ index ]  = Marshal.load( buffer )
+          done[ index ]     = true
+          @logger.message :debug, "Pipeline task #{index.to_s} finished (#{buffer.bytesize.to_s} bytes)"
+        else
+          failed << index
+        end
+      end
+    end
+
+    raise ArgumentError, "#{failed.length.to_s} pipeline task(s) failed (#{failed.sort.join( ", " )})" unless( failed.empty? )
+    raise ArgumentError, "Expected #{tasks.length.to_s} pipeline results" unless( done.all? )
+
+    results
+  end # of def map }}}
+
+
+  # @fn       def spawn index, task, others, &block # {{{
+  # @brief    Forks the process of one task, the child writes Marshal.dump of its result and exits
+  #
+  # @param    [Integer]     index       Index of the task
+  # @param    [Object]      task        Argument handed to the block
+  # @param    [Array]       others      Read ends of the tasks in flight, closed in the child
+  #
+  # @returns  [Array]                   [ read end of the task's pipe, pid ]
+  def spawn index, task, others, &block
+    reader, writer    = IO.pipe
+    reader.binmode
+    writer.binmode
+
+    pid = fork do
+      # only keep our own end of our own pipe
+      reader.close
+      others.each { |other| other.close }
+
+      status  = 0
+
+      begin
+        writer.write( Marshal.dump( block.call( task ) ) )
+      rescue Exception => e
+        @logger.message :error, "Pipeline task #{index.to_s} failed (#{e.message})"
+        status = 1
+      end
+
+      writer.close unless( writer.closed? )
+      $stdout.flush
+      exit!( status )
+    end
+
+    writer.close
+
+    [ reader, pid ]
+  end # of def spawn }}}
+
+end # of class Pipeline_Pool # }}}
+
+# vim:ts=2:tw=100:wm=100
@@ -37,6 +37,7 @@ require 'rvg/rvg'
 $:.push('.')
 require 'Logger.rb'
 require 'Frames.rb'
+require 'FrameMatrix.rb'
 
 # Change Namespace
 include Magick
@@ -292,47 +293,49 @@ class PoseVisualizer # {{{
       configurations_dir, domain, name, pattern, speed, cycle, filename = config
 
 
-      center    = adt.pt30
+      # coordinates relative to pt30 gathered out of one frame matrix instead of Segment copies
+      matrix    = FrameMatrix.new( adt )
+      center    = matrix.id( "pt30" )
 
       # right
-      rfin      = ( adt.rfin - center).getCoordinates!
-      relb      = ( adt.relb - center).getCoordinates!
-      rsho      = ( adt.rsho - center).getCoordinates!
+      rfin      = matrix.coordinates( "rfin", center )
+      relb      = matrix.coordinates( "relb", center )
+      rsho      = matrix.coordinates( "rsho", center )
 
-      rtoe      = ( adt.rtoe - center).getCoordinates!
-      rank      = ( adt.rank - center).getCoordinates!
-      rkne      = ( adt.rkne - center).getCoordinates!
-      rhee      = ( adt.rhee - center).getCoordinates!
+      rtoe      = matrix.coordinates( "rtoe", center )
+      rank      = matrix.coordinates( "rank", center )
+      rkne      = matrix.coordinates( "rkne", center )
+      rhee      = matrix.coordinates( "rhee", center )
 
       # center
-      pt26      = ( adt.pt26 - center).getCoordinates!
-      pt27      = ( adt.pt27 - center).getCoordinates!
-      pt28      = ( adt.pt28 - center).getCoordinates!
-      pt29      = ( adt.pt29 - center).getCoordinates!
-      pt30      = ( adt.pt30 - center).getCoordinates!
-      pt31      = ( adt.pt31 - center).getCoordinates!
+      pt26      = matrix.coordinates( "pt26", center )
+      pt27      = matrix.coordinates( "pt27", center )
+      pt28      = matrix.coordinates( "pt28", center )
+      pt29      = matrix.coordinates( "pt29", center )
+      pt30      = matrix.coordinates( "pt30", center )
+      pt31      = matrix.coordinates( "pt31", center )
 
       # waist
-      rfwt      = ( adt.rfwt - center).getCoordinates!
-      rbwt      = ( adt.rbwt - center).getCoordinates!
-      lfwt      = ( adt.lfwt - center).getCoordinates!
-      lbwt      = ( adt.lbwt - center).getCoordinates!
+      rfwt      = matrix.coordinates( "rfwt", center )
+      rbwt      = matrix.coordinates( "rbwt", center )
+      lfwt      = matrix.coordinates( "lfwt", center )
+      lbwt      = matrix.coordinates( "lbwt", center )
 
       # left
-      lfin      = ( adt.lfin - center).getCoordinates!
-      lelb      = ( adt.lelb - center).getCoordinates!
-      lsho      = ( adt.lsho - center).getCoordinates!
+      lfin      = matrix.coordinates( "lfin", center )
+      lelb      = matrix.coordinates( "lelb", center )
+      lsho      = matrix.coordinates( "lsho", center )
 
-      ltoe      = ( adt.ltoe - center).getCoordinates!
-      lank      = ( adt.lank - center).getCoordinates!
-      lkne      = ( adt.lkne - center).getCoordinates!
-      lhee      = ( adt.lhee - center).getCoordinates!
+      ltoe      = matrix.coordinates( "ltoe", center )
+      lank      = matrix.coordinates( "lank", center )
+      lkne      = matrix.coordinates( "lkne", center )
+      lhee      = matrix.coordinates( "lhee", center )
 
       # head
-      lfhd      = ( adt.lfhd - center).getCoordinates!
-      lbhd      = ( adt.lbhd - center).getCoordinates!
-      rfhd      = ( adt.rfhd - center).getCoordinates!
-      rbhd      = ( adt.rbhd - center).getCoordinates!
+      lfhd      = matrix.coordinates( "lfhd", center )
+      lbhd      = matrix.coordinates( "lbhd", center )
+      rfhd      = matrix.coordinates( "rfhd", center )
+      rbhd      = matrix.coordinates( "rbhd", center )
 
       # e.g. aarms=>[[:rfin, :rsho]], :legs=>[[:rtoe, :pt29]], :upper_arms=>[[:relb, :rsho]], :fore_arms=>[[:pt27, :relb]], :hands=>[[:rfin, :pt27]], :thighs=>[[:rkne, :pt29]], :shanks=>[[:rank, :rkne]], :feet=>[[:rtoe, :rank]]}
       components_right  = adt.body.group_12_model_right
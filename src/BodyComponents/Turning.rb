@@ -32,6 +32,8 @@ require 'PCA.rb'
 require 'Clustering.rb'
 require 'Mathematics.rb'
 require 'Physics.rb'
+require 'FrameMatrix.rb'
+require 'FrameView.rb'
 
 # Change Namespace
 include GSL
@@ -58,9 +60,27 @@ class Turning
     @mathematics                  = Mathematics.new
     @physics                      = Physics.new
     @filter                       = Filter.new( @options, @from, @to )
+
+    # marker coordinates as one matrix per axis, views instead of Segment copies (see FrameMatrix.rb)
+    @frames                       = FrameMatrix.new( @adt )
   end # of def initialize }}}
 
 
+  # @fn def frame_views markers, center = nil, from = nil, to = nil # {{{
+  # @brief Views of the frames [ from, to ] of some markers, nothing is copied until a stage reads them
+  #        ( nil..to is 0..to, from..nil is from..(length-from) as it always was for the segment based methods )
+  # @param markers Array of marker ids or names, the first one determines the length
+  # @param center Marker the coordinates are relative to, nil for absolute coordinates
+  # @param from Expects a number indicating to start from which time frame
+  # @param to Expects a number indicating to end on which time frame
+  # @returns Array, containing one FrameView per marker
+  def frame_views markers, center = nil, from = nil, to = nil
+    to = @frames.count( markers.first ) - from if( not from.nil? and to.nil? )
+
+    markers.collect { |marker| FrameView.new( @frames, marker, center, from, to ) }
+  end # of def frame_views }}}
+
+
   # @fn def getTurningPoints segment1 = "pt27", segment2 = "relb", segment3 = "pt26", segment4 = "lelb", center = "p30", direction = "xy", from = nil, to = nil  # {{{
   # @brief getTurningPoints returns a set of values after turning point calculation (B. Rennhak's Method '09) 
   #        takes four segments ( a,b,c,d - 2 for each line (a+b) (c+d) ) one segment for
@@ -87,33 +107,25 @@ class Turning
     #
     ###########
 
-    # Easy handling
-    pt30 = @adt.pt30
-    pt27 = @adt.pt27
-    pt9  = @adt.relb
-    pt26 = @adt.pt26
-    pt5  = @adt.lelb
+    # Views of the frames in range ( from..-1 if to is nil ), only those frames are ever gathered
+    pt30              = FrameView.new( @frames, "pt30", nil, from, to )
 
     # Make coords relative to p30 not global -- not normalized
-    pt27new           = pt27 - pt30
-    pt9new            = pt9  - pt30
+    pt27new           = FrameView.new( @frames, "pt27", "pt30", from, to )
+    pt9new            = FrameView.new( @frames, "relb", "pt30", from, to )
     slopeCoordsVars1  = []
 
-    pt26new           = pt26 - pt30
-    pt5new            = pt5  - pt30
+    pt26new           = FrameView.new( @frames, "pt26", "pt30", from, to )
+    pt5new            = FrameView.new( @frames, "lelb", "pt30", from, to )
     slopeCoordsVars2  = []
 
-    [ pt27new.getCoordinates!.zip( pt9new.getCoordinates! ) ].each do |array|
-      array.each do |point27Array, point9Array|
-        slopeCoordsVars1 << getSlopeForm( point27Array, point9Array, direction )
-      end
+    pt27new.coordinates.zip( pt9new.coordinates ).each do |point27Array, point9Array|
+      slopeCoordsVars1 << getSlopeForm( point27Array, point9Array, direction )
     end
 
-    [ pt26new.getCoordinates!.zip( pt5new.getCoordinates! ) ].each do |array|
-      array.each do |point26Array, point5Array|
-        slopeCoordsVars2 << getSlopeForm( point26Array, point5Array, direction )
-      end
-    end 
+    pt26new.coordinates.zip( pt5new.coordinates ).each do |point26Array, point5Array|
+      slopeCoordsVars2 << getSlopeForm( point26Array, point5Array, direction )
+    end
 
     points = []
 
@@ -124,9 +136,9 @@ class Turning
       end
     end
 
-    pt30Coords = pt30.getCoordinates!
+    pt30Coords = pt30.coordinates
     final = []
-    n = 0
+    n = pt30.from
 
     # get the norms
     normX, normY = 0, 0
@@ -140,9 +152,9 @@ class Turning
 
     points.each do |p1, p2|
 
-      x = pt30Coords[n].shift
-      y = pt30Coords[n].shift
-      z = pt30Coords[n].shift
+      x = pt30Coords[ n - pt30.from ].shift
+      y = pt30Coords[ n - pt30.from ].shift
+      z = pt30Coords[ n - pt30.from ].shift
 
 
       norm = false
@@ -157,26 +169,7 @@ class Turning
       n += 1
     end
 
-    # Modify our array if we want only a certain range
-    if( from.nil? )
-      if( to.nil? )
-        # from && to == nil
-        # do nothing, we have already all resuts
-      else
-        # from == nil ; to != nil
-        # we start from 0 upto to
-        final = eval( "final[0..#{to}]" )
-      end
-    else
-      if( to.nil? )
-        # from != nil ; to == nil
-        final = eval( "final[#{from}..-1]" )
-      else
-        # from && to != nil
-        final = eval( "final[#{from}..#{to}]" )
-      end
-    end
-
+    # the views already cover only frames from..to, n keeps the frame numbers of the recording
     final
 
   end # end of getTurningPoints }}}
@@ -205,67 +198,12 @@ class Turning
     #
     ###########
 
-    # FIXME: Substitudte eval through the proper method which exists now in ruby core
-    # Easy handling method internal
-    center  = eval( "@adt.#{center.to_s}" )
-    seg1    = eval( "@adt.#{segment1.to_s}" )
-    seg2    = eval( "@adt.#{segment2.to_s}" )
-    seg3    = eval( "@adt.#{segment3.to_s}" )
-    seg4    = eval( "@adt.#{segment4.to_s}" )
-
-    # Make coords relative to p30 not global -- not normalized
-    seg1new           = seg1 - center
-    seg2new           = seg2 - center
-    seg3new           = seg3 - center
-    seg4new           = seg4 - center
-
-    # Modify our array if we want only a certain range
-    # FIXME: Array.slice only supports start, length not from,to. Reimplement this properly.
-    if( from.nil? )
-      if( to.nil? )
-        # from && to == nil
-        # do nothing, we have already all resuts
-        #puts "From and To Nil"
-        seg1newCoord  = seg1new.getCoordinates!
-        seg2newCoord  = seg2new.getCoordinates!
-        seg3newCoord  = seg3new.getCoordinates!
-        seg4newCoord  = seg4new.getCoordinates!
-      else
-        # from == nil ; to != nil
-        # we start from 0 upto to
-        #puts "From nil to not nil"
-        seg1newCoord  = seg1new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "0..#{to}" ) ]
-      end
-    else
-      if( to.nil? )
-        # from != nil ; to == nil
-        # e.g. from = 250 
-        # totalLength - from = x
-        #puts "From not nil to is nil"
-        length = seg1new.getCoordinates!.length
-        seg1newCoord  = seg1new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-      else
-        # from && to != nil
-        #puts "From (#{from.to_s}) not nil and to (#{to.to_s}) not nil"
-        seg1newCoord  = seg1new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-      end
-    end
+    # Coords relative to p30 not global -- not normalized, already in the long form PCA expects
+    views             = frame_views( [ segment1, segment2, segment3, segment4 ], center, from, to )
 
     pca = PCA.new
 
-    s1 = pca.reshape_data( seg1newCoord, true, false )
-    s2 = pca.reshape_data( seg2newCoord, true, false )
-    s3 = pca.reshape_data( seg3newCoord, true, false )
-    s4 = pca.reshape_data( seg4newCoord, true, false )
+    s1, s2, s3, s4    = views.collect { |view| view.columns }
 
 
     # FIXME
@@ -304,18 +242,21 @@ class Turning
   #
   # @param data Accepts array of arrays. Polyline X = [x1,y1,z2; x2,y2,z2; ....; xN,yN,zN]
   #
+  # @param threshold Float, the torsion is interpolated (pchip) for all frames where kappa < threshold
+  #
   # @returns Array, containing [kappa,tau,T,N,B,s,ds]
-  #          Kappa  -> (Unsigned) Curvature
-  #          Tau    -> Torsion
-  #          T      -> is the unit vector tangent to the curve, pointing in the direction of motion.
-  #          N      -> is the derivative of T with respect to the arclength parameter of the curve, divided by its length.
-  #          B      -> is the cross product of T and N.
-  #          s      -> 
-  #          ds     ->
+  #          Kappa  -> (Unsigned) Curvature (n-3 values)
+  #          Tau    -> Torsion (n-3 values)
+  #          T      -> is the unit vector tangent to the curve, pointing in the direction of motion. (n-3 [x,y,z])
+  #          N      -> is the derivative of T with respect to the arclength parameter of the curve, divided by its length. (n-3 [x,y,z])
+  #          B      -> is the cross product of T and N. (n-3 [x,y,z])
+  #          s      -> Cumulative arc length (n-1 values)
+  #          ds     -> Length of each polyline segment (n-1 values)
   #
   # This function is based on the code found at
   # http://thedailyreviewer.com/compsys/view/curvature-of-a-curve-in-3d-109234866
-  # - no name of the author was given.
+  # - no name of the author was given. It used to run as matlab/frenetframe.m through a MATLAB
+  # chroot, now it is the native kernel c_frenet_frame (c/utils/c_frenet.c).
   #
   # @warning The frenet frame doesn't always exist, the torsion is not defined when kappa = 0, there it gets interpolated.
   # @warning This method might not work well with noisy data. For noisy torsions it would be better to use quintic splines.
@@ -327,26 +268,27 @@ class Turning
   #   o A helix has constant curvature and constant t
   def frenet_frame data, threshold = 0.001 
 
-    # If we only have two points
-    threshold = 0.001 if data.length <=  2
+    # Pre-condition check {{{
+    raise ArgumentError, "Data should be of type Array, but it is of (#{data.class.to_s})" unless( data.is_a?( Array ) )
+    raise ArgumentError, "Data should be of shape [ [x,y,z],...]" unless( data.first.length == 3 )
+    raise ArgumentError, "The Frenet frame needs at least four points, but we only have #{data.length.to_s}" if( data.length < 4 )
+    # }}}
 
-    # f = GSL::Function.alloc { |x|
-    #    pow(x, 1.5)
-    # }
+    # One contiguous buffer in and preallocated buffers out, see c/utils/c_frenet.c
+    points                            = data.length
+    rows                              = points - 3
 
-    #   t_result = []
+    kappa, tau                        = "\0" * ( 8 * rows ), "\0" * ( 8 * rows )
+    t, n, b                           = "\0" * ( 24 * rows ), "\0" * ( 24 * rows ), "\0" * ( 24 * rows )
+    s, ds                             = "\0" * ( 8 * ( points - 1 ) ), "\0" * ( 8 * ( points - 1 ) )
 
-    #   h = 1e-8
-    #   result, abserr = f.deriv_central(x, h)
+    packed                            = data.flatten.pack( "d*" )
+    raise ArgumentError, "Data should be of shape [ [x,y,z],...], some rows have not 3 values" unless( packed.bytesize == 24 * points )
 
-    # FIXME Use rsruby for this --> do computations in GNU R since ruby is a pain .. or use matlab
-
-    #T = 
-    #T = diff(X); % dX/dt
-    
-    # exit
+    result = C_mathematics.c_frenet_frame( packed, points, threshold.to_f, kappa, tau, t, n, b, s, ds )
+    raise ArgumentError, "Native Frenet frame calculation failed (#{result.to_s})" unless( result == rows )
 
-    []
+    [ kappa, tau ].collect { |buffer| buffer.unpack( "d*" ) } + [ t, n, b ].collect { |buffer| buffer.unpack( "d*" ).each_slice( 3 ).to_a } + [ s, ds ].collect { |buffer| buffer.unpack( "d*" ) }
   end # of def frenet_frame }}}
 
 
@@ -374,67 +316,10 @@ class Turning
 
 
 
-    # FIXME: Substitudte eval through the proper method which exists now in ruby core
-    # Easy handling method internal
-    center  = eval( "@adt.#{center.to_s}" )
-    seg1    = eval( "@adt.#{segment1.to_s}" )
-    seg2    = eval( "@adt.#{segment2.to_s}" )
-    seg3    = eval( "@adt.#{segment3.to_s}" )
-    seg4    = eval( "@adt.#{segment4.to_s}" )
-
-    # Make coords relative to p30 not global -- not normalized
-    seg1new           = seg1 - center
-    seg2new           = seg2 - center
-    seg3new           = seg3 - center
-    seg4new           = seg4 - center
-
-    # Get CPA from the two 3D lines
-    ptPnew            = @mathematics.distance_of_line_to_line( seg1new, seg2new, seg3new, seg4new )
-
-    # Modify our array if we want only a certain range
-    # FIXME: Array.slice only supports start, length not from,to. Reimplement this properly.
-    if( from.nil? )
-      if( to.nil? )
-        # from && to == nil
-        # do nothing, we have already all resuts
-        #puts "From and To Nil"
-        seg1newCoord  = seg1new.getCoordinates!
-        seg2newCoord  = seg2new.getCoordinates!
-        seg3newCoord  = seg3new.getCoordinates!
-        seg4newCoord  = seg4new.getCoordinates!
-        ptPnewCoord   = ptPnew.getCoordinates!
-      else
-        # from == nil ; to != nil
-        # we start from 0 upto to
-        #puts "From nil to not nil"
-        seg1newCoord  = seg1new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "0..#{to}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "0..#{to}" ) ]
-        ptPnewCoord   = ptPnew.getCoordinates![ eval( "0..#{to}" ) ]
-      end
-    else
-      if( to.nil? )
-        # from != nil ; to == nil
-        # e.g. from = 250 
-        # totalLength - from = x
-        #puts "From not nil to is nil"
-        length = seg1new.getCoordinates!.length
-        seg1newCoord  = seg1new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-        ptPnewCoord   = ptPnew.getCoordinates![ eval( "#{from}..#{length-from}" ) ]
-      else
-        # from && to != nil
-        #puts "From (#{from.to_s}) not nil and to (#{to.to_s}) not nil"
-        seg1newCoord  = seg1new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg2newCoord  = seg2new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg3newCoord  = seg3new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        seg4newCoord  = seg4new.getCoordinates![ eval( "#{from}..#{to}" ) ]
-        ptPnewCoord   = ptPnew.getCoordinates![ eval( "#{from}..#{to}" ) ]
-      end
-    end
+    # Get CPA from the two 3D lines, coords relative to p30 not global -- not normalized
+    # (one native pass over the frames in range, see c/utils/c_cpa.c)
+    views             = frame_views( [ segment1, segment2, segment3, segment4, center ], nil, from, to )
+    ptPnewCoord       = @mathematics.closest_point_of_approach( *views.collect { |view| view.interleaved } )
 
     # e.g.
     # Point l1_1 :   pt9  (right elbow)
@@ -737,8 +622,8 @@ EOS
   end # of def get_octants }}}
 
 
-  # @fn def get_dot_graph hash = nil, filename = "graphs/cluster.dot"  # {{{
-  def get_dot_graph hash = nil, filename = "graphs/cluster.dot" 
+  # @fn def self.get_dot_graph hash = nil, filename = "graphs/cluster.dot"  # {{{
+  def self.get_dot_graph hash = nil, filename = "graphs/cluster.dot" 
 
     # Hash data is
     # (key ) frame = (value) cluster id
@@ -870,16 +755,12 @@ EOS
     else
       @log.message :success, "Using RAW data for PCA matrix"
 
-      # Push raw data into storage for PCA
+      # Push raw data into storage for PCA, local coordinates straight in the long form
+      center      = @frames.id( "pt30" )
+
       tmp_components.flatten.uniq.each do |c|
         @log.message :info, "Transferring #{c.to_s} from absolute to local coordinate system"
-        component = eval("@adt.#{c.to_s}")
-        center    = eval("@adt.pt30")
-
-        local     = component - center
-
-        coord     = local.getCoordinates!
-        components << coord.dup
+        components << @frames.columns( @frames.id( c ), center )
       end
     end
 
@@ -888,10 +769,17 @@ EOS
     all   = []
     count = 0
     components.each do |c|
-      all   += pca.reshape_data( c, true, false )
+      all   += ( @options.use_raw_data ) ? c : pca.reshape_data( c, true, false )
       count += 1
     end
 
+    unless( @options.local_pca_window.nil? )
+      @log.message :info, "Performing sliding window PCA with #{@options.local_pca_window.to_s} frames before and after each frame"
+      # only the local spectra are used, one projected component is the cheapest projection
+      local_spectra                     = pca.sliding_pca( all.transpose, @options.local_pca_window, 1 ).first
+      local_dimensionality              = pca.intrinsic_dimensionality( local_spectra )
+    end
+
     @log.message :info, "Performing PCA reduction on all body components CPA"
 
     all_pca, all_eval, all_evec       = pca.do_pca( all, ((count*3)-3) )
@@ -899,22 +787,26 @@ EOS
 
     spread                            = 20
 
-    all_distances                     = @mathematics.eucledian_distance_window( pca.reshape_data( all_final.dup, false, true), spread )
-    all_energy                        = @physics.energy( pca.reshape_data( all_final.dup, false, true ), mass, spread )
+    # T-Data points [ [x,y,z], ... ], reshaped once and shared by everything below (returned as well)
+    pd                                = pca.reshape_data( all_final.dup, false, true )
+
+    # The T-Data path length index is built once and shared by the distance window and kinematics
+    tdata_index                       = @mathematics.path_length_index( pd )
+
+    all_distances                     = @mathematics.eucledian_distance_window( pd, spread, tdata_index )
+    energy_kinematics                 = @physics.kinematics( tdata_index, mass, spread, @options.capture_interval.to_f )
+    all_energy, e_prime, e_prime_prime = energy_kinematics.values_at( 3, 7, 11 )
 
     # Calculate the distance of tdata point to local coordinate center
     ext_calc                          = false
 
     if( ext_calc )
 
-      tdata_distance                    = []
+      center                            = FrameView.new( @frames, "pt30", nil, 0, pd.length - 1 ).coordinates
 
-      center                            = ( eval("@adt.pt30") ).getCoordinates!
-
-      ( pca.reshape_data( all_final.dup, false, true  ) ).each_with_index do |array, index|
-        # eucledian distance between t-data point and coord center (float)
-        tdata_distance << @mathematics.eucledian_distance( array, center[ index ] )
-      end # of ( pca.reshape_data( all_final.dup,...)
+      # eucledian distance between t-data point and coord center (float)
+      tdata                             = pd
+      tdata_distance                    = @mathematics.eucledian_distances_pairwise( tdata, center )
 
       # Warning: This works only for one component per CLI
       #
@@ -937,60 +829,36 @@ EOS
 
     end # of if( ext_calc )
 
-    # This is also returned by the function
-    pd = pca.reshape_data( all_final.dup, false, true  )
-    
     # octants = get_octants( pd.dup, components_sav )
     clustering            = Clustering.new( @options )
     kmeans, centroids     = clustering.kmeans( pd, 4 )
     
-    get_dot_graph( kmeans )
+    Turning.get_dot_graph( kmeans )
 
     #kmeans      = octants
 
-    #### Messy Mablab interaction
-    # Dump to file for matlab
-    File.open( "work/data.csv", File::WRONLY|File::TRUNC|File::CREAT, 0667 ) do |f|
-      # pd = pca.reshape_data( all_final.dup, false, true  )
+    @log.message :info, "Calculating the Frenet frame of the T-Data"
 
-      pd.each do |x,y,z|
-        f.write( "#{x.to_s}, #{y.to_s}, #{z.to_s}\n" )
-      end
-    end
-
-    @log.message :info, "Calling MATLAB for some specialized processing"
-    `sudo su -c "chroot /export/temp/MatLAB_7_Linux/matlab /home/mh/ml/bin/matlab_call.sh"`
-
-    # Read file @from matlab processing for frenet frame
-    # kappa index is exacly 2 shorter than the others
-    kappa = File.open( "work/kappa.csv", "r" ).readlines.collect! { |n| n.to_f }
+    # kappa index is exacly 3 shorter than the T-Data
+    kappa, tau, tangent, normal, binormal, arc_length, arc_segments = frenet_frame( pd, 0.001 )
 
     unless( @options.boxcar_filter.nil? )
       @log.message :info, "Applying FIR Boxcar filter of order #{@options.boxcar_filter.to_s} to Curvature"
-      boxcar_kappa = @filter.box_car_filter( kappa.zip(kappa), @options.boxcar_filter.to_i )
-      kappa = boxcar_kappa.collect { |a,b| b }
+      kappa = @filter.fir_filter( kappa, nil, @options.boxcar_filter.to_i )
     end
 
     @log.message :info, "Performing additional calculations (E_k, etc.)" 
 
-    v                                 = @physics.velocity( pca.reshape_data( all_final.dup, false, true ), 5 )
-    a                                 = @physics.acceleration( pca.reshape_data( all_final.dup, false, true), 5 )
-    p                                 = @physics.power( pca.reshape_data( all_final.dup, false, true ), mass, 5 )
-
-
-    h = 10 ** (-1)
-    e_prime       = @mathematics.derivative( all_energy, h )  # slope of the function
-    e_prime_prime = @mathematics.derivative( e_prime, h )     # rate of change (or slope of the slope)
-
-    v_prime       = @mathematics.derivative( v, h )           # slope of the function
-    v_prime_prime = @mathematics.derivative( v_prime, h )     # rate of change (or slope of the slope)
+    # v, a, p and the slope / rate of change (or slope of the slope) of v in one pass
+    kinematics                        = @physics.kinematics( tdata_index, mass, 5, @options.capture_interval.to_f )
+    v, a, p                           = kinematics.values_at( 0, 1, 2 )
+    v_prime, v_prime_prime            = kinematics.values_at( 4, 8 )
 
 
     # Determine local max & min
     kappa_sign_graph        = []                              # local max or min
 
-    kappa_slope             = @mathematics.derivative( kappa, h )       # slope of the function
-    kappa_rate_of_change    = @mathematics.derivative( kappa_slope, h ) # rate of change (slope of the slope)
+    kappa_slope, kappa_rate_of_change = @mathematics.spline_derivatives( [ kappa ] ).first  # slope, rate of change (slope of the slope)
 
     kappa_slope.each_with_index do |k, i|
       next if( kappa_slope.length <= i+1 )  # abort if we reached the end
@@ -1063,6 +931,25 @@ EOS
 
     velocity_candidates.uniq!
 
+    # Frames where the local intrinsic dimensionality drops (sliding window PCA, --local-pca)
+    dimensionality_candidates = []
+
+    unless( local_dimensionality.nil? )
+      local_dimensionality.each_with_index do |dimensions, frame|
+        next if( frame == 0 )
+
+        if( dimensions < local_dimensionality[ frame - 1 ] )
+          dimensionality_candidates << frame - 2
+          dimensionality_candidates << frame - 1
+          dimensionality_candidates << frame
+          dimensionality_candidates << frame + 1
+          dimensionality_candidates << frame + 2
+        end
+      end
+
+      dimensionality_candidates.uniq!
+    end
+
     result = []
     0.upto( all_energy.length - 1 ).each do |frame|
       sum = ""
@@ -1070,6 +957,7 @@ EOS
       sum += "ccccc"  if( kappa_candidates.include?(frame) )
       sum += "eeeee" if( energy_candidates.include?(frame) )
       sum += "vvvvv" if( velocity_candidates.include?(frame) )
+      sum += "ddddd" if( dimensionality_candidates.include?(frame) )
 
       result << sum
     end
@@ -1292,8 +1180,6 @@ EOS
     @log.message :info, "DMPs are: #{@dance_master_poses.join(", ")}"
     @log.message :info, "Turningposes are: #{turning_poses.join(", ")}"
 
-    #### Messy Mablab interaction end
-
     #pca.covariance_matrix_gnuplot( all, "cov.gp" )
     #pca.eigenvalue_energy_gnuplot( all, "energy.gp" )
 
@@ -0,0 +1,228 @@
+#!/usr/bin/ruby
+#
+
+###
+#
+# File: VPM_Cache.rb
+#
+######
+
+
+###
+#
+# (c) 2009-2011, Copyright, Bjoern Rennhak, The University of Tokyo
+#
+# @file       VPM_Cache.rb
+# @author     Bjoern Rennhak
+#
+# @brief      Binary columnar cache of parsed VPM motion capture files (MotionX ADT objects).
+#
+#             Layout of a cache file (native byte order, all offsets of the columns 8 byte aligned)
+#
+#               "VPMC"                                                magic
+#               version, markers, frames, names, skeleton ( int32 )  header, byte sizes of the two blobs
+#               capture interval ( double )
+#               source hash ( 40 bytes, SHA1 hex of the VPM file )
+#               frames of every marker ( markers x int32 )
+#               marker names ( "\0" separated )
+#               skeleton ( Marshal of the ADT without its coordinates )
+#               padding
+#               columns ( markers x [ x, y, z ], one contiguous float64 array each )
+#
+#######
+
+
+# Standard includes
+require 'digest/sha1'
+require 'fileutils'
+
+# Local includes
+$:.push('.')
+require 'Logger.rb'
+require 'FrameMatrix.rb'
+
+
+# @class      class VPM_Cache # {{{
+# @brief      Loads VPM files through the MotionX ADT parser once and from the cache afterwards
+class VPM_Cache
+
+  # @fn       def initialize options = nil, cache_dir = "cache" # {{{
+  # @brief    Custom constructor for the VPM_Cache class
+  #
+  # @param    [OpenStruct]  options     Options OpenStruct processed by the parse_cmd_arguments function
+  # @param    [String]      cache_dir   Directory of the cache files
+  def initialize options = nil, cache_dir = "cache"
+
+    # Input verification {{{
+    raise ArgumentError, "Options cannot be nil"    if( options.nil? )
+    raise ArgumentError, "Cache dir cannot be nil"  if( cache_dir.nil? )
+    # }}}
+
+    @options    = options
+    @cache_dir  = cache_dir
+    @log        = Logger.new( @options )
+
+    @magic      = "VPMC"
+    @version    = 1
+  end # of def initialize }}}
+
+
+  # @fn       def load file # {{{
+  # @brief    Returns the ADT of a VPM file. A valid cache (same SHA1 of the VPM file) is read in one
+  #           go and its columns are unpacked straight into the segments, otherwise the file is parsed
+  #           by ADT.new and the cache is (re)written.
+  #
+  # @param    [String]      file        VPM file
+  #
+  # @returns  [ADT]                     ADT Class Object of the MotionX package VPM plugin
+  def load file
+
+    # Input verification {{{
+    raise ArgumentError, "File should be a readable VPM file, but is (#{file.to_s})" unless( file.is_a?( String ) and File.readable?( file ) )
+    # }}}
+
+    return ADT.new( file ) unless( @options.cache )
+
+    hash        = Digest::SHA1.file( file ).hexdigest
+    path        = cache_path( file )
+
+    if( File.exist?( path ) )
+      begin
+        adt     = read( path, hash )
+
+        unless( adt.nil? )
+          @log.message :debug, "Loaded #{file.to_s} from cache (#{path.to_s})"
+          return adt
+        end
+
+        @log.message :info, "Cache of #{file.to_s} is outdated, parsing the VPM file again"
+      rescue StandardError => e
+        @log.message :warning, "Cache of #{file.to_s} could not be read (#{e.message}), parsing the VPM file again"
+      end
+    end
+
+    adt         = ADT.new( file )
+
+    begin
+      write( path, adt, hash )
+    rescue StandardError => e
+      @log.message :warning, "Cache of #{file.to_s} could not be written (#{e.message})"
+    end
+
+    adt
+  end # of def load }}}
+
+
+  # @fn       def cache_path file # {{{
+  # @brief    Cache file of a VPM file, the path digest keeps equally named recordings apart
+  #
+  # @param    [String]      file        VPM file
+  #
+  # @returns  [String]                  Path of the cache file
+  def cache_path file
+    File.join( @cache_dir, "#{File.basename( file, ".*" )}_#{Digest::SHA1.hexdigest( File.expand_path( file ) )[ 0, 12 ]}.vpmc" )
+  end # of def cache_path }}}
+
+
+  # @fn       def write path, adt, hash # {{{
+  # @brief    Writes the cache file of a parsed ADT. The coordinates are taken out of the segments for
+  #           the Marshal of the skeleton and put back afterwards, they only go into the columns.
+  #
+  # @param    [String]      path        Path of the cache file
+  # @param    [ADT]         adt         ADT Class Object of the MotionX package VPM plugin
+  # @param    [String]      hash        SHA1 hex of the VPM file
+  def write path, adt, hash
+
+    names       = FrameMatrix.markers( adt )
+    columns     = names.collect { |s| segment = adt.public_send( s ); [ segment.xtran, segment.ytran, segment.ztran ] }
+
+    raise ArgumentError, "Segments have axes of different lengths" unless( columns.all? { |x, y, z| x.length == y.length and y.length == z.length } )
+
+    begin
+      names.each { |s| segment = adt.public_send( s ); segment.xtran, segment.ytran, segment.ztran = nil, nil, nil }
+      skeleton  = Marshal.dump( adt )
+    ensure
+      names.each_with_index { |s, i| segment = adt.public_send( s ); segment.xtran, segment.ytran, segment.ztran = *columns[ i ] }
+    end
+
+    counts      = columns.collect { |x, y, z| x.length }
+    joined      = names.join( "\0" )
+    header      = @magic + [ @version, names.length, counts.max.to_i, joined.bytesize, skeleton.bytesize ].pack( "l5" ) + [ @options.capture_interval.to_f ].pack( "d" ) + hash + counts.pack( "l*" )
+    offset      = header.bytesize + joined.bytesize + skeleton.bytesize
+
+    FileUtils.mkdir_p( @cache_dir )
+
+    # written under a per process name (Pipeline_Pool workers may cache the same VPM file at the same
+    # time) and renamed into place only once complete, a run reading it meanwhile sees the old file or none
+    temporary   = "#{path}.#{Process.pid.to_s}.tmp"
+
+    begin
+      File.open( temporary, "wb" ) do |f|
+        f.write( header )
+        f.write( joined )
+        f.write( skeleton )
+        f.write( "\0" * ( ( 8 - offset % 8 ) % 8 ) )
+        columns.each { |axes| axes.each { |axis| f.write( axis.pack( "d*" ) ) } }
+      end
+
+      File.rename( temporary, path )
+    ensure
+      File.delete( temporary ) if( File.exist?( temporary ) )
+    end
+  end # of def write }}}
+
+
+  # @fn       def read path, hash # {{{
+  # @brief    Reads a cache file, nil if it belongs to another version of the VPM file (or format)
+  #
+  # @param    [String]      path        Path of the cache file
+  # @param    [String]      hash        SHA1 hex of the current VPM file
+  #
+  # @returns  [ADT]                     ADT Class Object of the MotionX package VPM plugin or nil
+  def read path, hash
+
+    buffer      = File.binread( path )
+
+    return nil unless( buffer.byteslice( 0, 4 ) == @magic )
+
+    version, count, frames, names_size, skeleton_size = buffer.byteslice( 4, 20 ).unpack( "l5" )
+    interval    = buffer.byteslice( 24, 8 ).unpack( "d" ).first
+    source      = buffer.byteslice( 32, 40 )
+
+    return nil unless( version == @version and source == hash )
+
+    @log.message :warning, "Cache was written with a capture interval of #{interval.to_s}, but #{@options.capture_interval.to_s} is used" unless( interval == @options.capture_interval.to_f )
+
+    counts      = buffer.byteslice( 72, 4 * count ).unpack( "l*" )
+    offset      = 72 + 4 * count
+    names       = buffer.byteslice( offset, names_size ).split( "\0" )
+    adt         = Marshal.load( buffer.byteslice( offset + names_size, skeleton_size ) )
+    offset     += names_size + skeleton_size
+    offset     += ( 8 - offset % 8 ) % 8
+
+    raise ArgumentError, "Cache has #{names.length.to_s} marker names, but #{count.to_s} markers" unless( names.length == count and counts.length == count )
+
+    # only names of the marker list are looked up, nothing read from the file is evaluated
+    markers     = FrameMatrix.markers( adt )
+    unknown     = names.reject { |s| markers.include?( s ) }
+    raise ArgumentError, "Cache has unknown marker names (#{unknown.join( ", " )})" unless( unknown.empty? )
+
+    names.each_with_index do |s, i|
+      segment                                   = adt.public_send( s )
+      segment.xtran, segment.ytran, segment.ztran = *( 0...3 ).collect { |axis| buffer.byteslice( offset + 8 * counts[ i ] * axis, 8 * counts[ i ] ).unpack( "d*" ) }
+      offset                                   += 24 * counts[ i ]
+    end
+
+    raise ArgumentError, "Cache is truncated" unless( offset == buffer.bytesize )
+
+    adt
+  end # of def read }}}
+
+end # of class VPM_Cache # }}}
+
+
+# Direct Invocation (local testing) # {{{
+if __FILE__ == $0
+end # of if __FILE__ == $0 }}}
+
+# vim:ts=2:tw=100:wm=100
@@ -2,7 +2,59 @@
  %{
  /* Includes the header in the wrapper code */
  #include "utils/c_mathematics.h"
+ #include "utils/c_frenet.h"
+ #include "utils/c_path_length.h"
+ #include "utils/c_cpa.h"
+ #include "utils/c_covariance.h"
+ #include "utils/c_moments.h"
+ #include "utils/c_eigen.h"
+ #include "utils/c_sliding_pca.h"
+ #include "utils/c_savitzky_golay.h"
+ #include "utils/c_arc_smooth.h"
+ #include "utils/c_fir.h"
+ #include "utils/c_spline.h"
+ #include "utils/c_kinematics.h"
+ #include "utils/c_kmeans.h"
+ #include "utils/c_kmeans_restarts.h"
+ #include "utils/c_kmeans_minibatch.h"
+ #include "utils/c_kmeans_search.h"
+ #include "utils/c_kmeans_score.h"
+ #include "utils/c_cluster_distances.h"
+ #include "utils/c_kdtree.h"
+ #include "utils/c_frame_matrix.h"
  %}
- 
+
+ /* Contiguous buffers are handed over as packed Ruby Strings, e.g. [ x0, y0, z0, ... ].pack( "d*" ).
+  * Output buffers are preallocated by the caller (e.g. "\0" * ( 8 * n )) and written in place.
+  * The typemap cannot know how many values a kernel reads or writes, every Ruby wrapper checks
+  * the bytesize of its buffers against the counts it passes before calling in. */
+ %typemap(in) double *BUFFER {
+   Check_Type( $input, T_STRING );
+   rb_str_modify( $input );
+   $1 = ( double * ) RSTRING_PTR( $input );
+ }
+
+ %apply double *BUFFER { double *, const double * }
+
  /* Parse the header file to generate wrappers */
  %include "utils/c_mathematics.h"
+ %include "utils/c_frenet.h"
+ %include "utils/c_path_length.h"
+ %include "utils/c_cpa.h"
+ %include "utils/c_covariance.h"
+ %include "utils/c_moments.h"
+ %include "utils/c_eigen.h"
+ %include "utils/c_sliding_pca.h"
+ %include "utils/c_savitzky_golay.h"
+ %include "utils/c_arc_smooth.h"
+ %include "utils/c_fir.h"
+ %include "utils/c_spline.h"
+ %include "utils/c_kinematics.h"
+ %include "utils/c_kmeans.h"
+ %include "utils/c_kmeans_restarts.h"
+ %include "utils/c_kmeans_minibatch.h"
+ %include "utils/c_kmeans_search.h"
+ %include "utils/c_kmeans_score.h"
+ %include "utils/c_cluster_distances.h"
+ %include "utils/c_kdtree.h"
+ %include "utils/c_frame_matrix.h"
@@ -0,0 +1,37 @@
+#!/usr/bin/ruby
+#
+
+###
+#
+# File: extconf.rb
+#
+######
+
+
+###
+#
+# (c) 2009-2011, Copyright, Bjoern Rennhak, The University of Tokyo
+#
+# @file       extconf.rb
+# @author     Bjoern Rennhak
+#
+# @brief      Generates the Makefile for the SWIG wrapped c_mathematics extension.
+#             Run "swig -ruby c_mathematics.i" first (or simply "rake compile" from the top directory).
+#
+#######
+
+
+require 'mkmf'
+
+have_library( "m" )
+have_library( "pthread" )     # c_kmeans_restarts.c
+
+$CFLAGS    << " -std=c99 -O3"
+$CFLAGS    << " -msse2" if( try_cflags( "-msse2" ) )                 # portable baseline, c_mathematics.c picks AVX at runtime
+$INCFLAGS  << " -I$(srcdir)/utils"
+$VPATH     << "$(srcdir)/utils"
+$srcs       = [ "c_mathematics_wrap.c" ] + Dir.glob( File.join( File.dirname( __FILE__ ), "utils", "*.c" ) ).collect { |f| File.basename( f ) }
+
+create_makefile( "c_mathematics" )
+
+# vim:ts=2:tw=100:wm=100
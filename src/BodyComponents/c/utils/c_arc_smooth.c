@@ -0,0 +1,396 @@
+/*!
+ *
+ * \file        c_arc_smooth.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Sliding polynomial smoother over the arc length of a 3D trajectory.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "c_arc_smooth.h"             ///< Include own header
+
+
+/*! \fn       static void sums_add( const double *pdT, const double *pdX, int iFrom, int iTo, double dC, double dL, int iOrder, double dSign, double *pdP, double *pdQ ) // {{{
+ *  \brief    Adds (dSign = 1.0) or removes (dSign = -1.0) the points [iFrom, iTo) to the normal equation
+ *            sums P[j] = sum u^j ( j = 0..2k ) and Q[a][j] = sum u^j x_a ( j = 0..k ) with u = ( t - c ) / L.
+ */
+static void sums_add( const double *pdT, const double *pdX, int iFrom, int iTo, double dC, double dL, int iOrder, double dSign, double *pdP, double *pdQ )
+{
+  int i = 0;
+  int j = 0;
+  int a = 0;
+
+  for( i = iFrom; i < iTo; i++ )
+  {
+    double dU = ( pdT[i] - dC ) / dL;
+    double dP = dSign;
+
+    for( j = 0; j <= ( 2 * iOrder ); j++ )
+    {
+      pdP[j] += dP;
+
+      if( j <= iOrder )
+      {
+        for( a = 0; a < 3; a++ )
+        {
+          pdQ[ ( a * ( iOrder + 1 ) ) + j ] += dP * pdX[ ( 3 * i ) + a ];
+        }
+      }
+
+      dP *= dU;
+    }
+  }
+} // }}}
+
+
+/*! \fn       static void sums_rebase( double dAlpha, double dBeta, int iOrder, double *pdP, double *pdQ ) // {{{
+ *  \brief    Moves the sums into a new local coordinate u' = alpha * u + beta (binomial expansion),
+ *            O(k^2) instead of touching the points again.
+ */
+static void sums_rebase( double dAlpha, double dBeta, int iOrder, double *pdP, double *pdQ )
+{
+  int    j  = 0;
+  int    m  = 0;
+  int    a  = 0;
+  int    iN = ( 2 * iOrder ) + 1;
+  double adP[ iN ];
+  double adQ[ 3 * ( iOrder + 1 ) ];
+  double adAlpha[ iN ];
+  double adBeta[ iN ];
+  double adBinomial[ iN ];
+
+  adAlpha[0] = 1.0;
+  adBeta[0]  = 1.0;
+
+  for( j = 1; j < iN; j++ )
+  {
+    adAlpha[j] = adAlpha[ j - 1 ] * dAlpha;
+    adBeta[j]  = adBeta[ j - 1 ] * dBeta;
+  }
+
+  for( j = 0; j < iN; j++ )
+  {
+    // binomial coefficients C( j, m ) of this row
+    adBinomial[0] = 1.0;
+    for( m = 1; m <= j; m++ )
+    {
+      adBinomial[m] = ( adBinomial[ m - 1 ] * ( double ) ( j - m + 1 ) ) / ( double ) m;
+    }
+
+    adP[j] = 0.0;
+    for( m = 0; m <= j; m++ )
+    {
+      adP[j] += adBinomial[m] * adAlpha[m] * adBeta[ j - m ] * pdP[m];
+    }
+
+    if( j <= iOrder )
+    {
+      for( a = 0; a < 3; a++ )
+      {
+        double dSum = 0.0;
+
+        for( m = 0; m <= j; m++ )
+        {
+          dSum += adBinomial[m] * adAlpha[m] * adBeta[ j - m ] * pdQ[ ( a * ( iOrder + 1 ) ) + m ];
+        }
+
+        adQ[ ( a * ( iOrder + 1 ) ) + j ] = dSum;
+      }
+    }
+  }
+
+  for( j = 0; j < iN; j++ )
+  {
+    pdP[j] = adP[j];
+  }
+
+  for( j = 0; j < ( 3 * ( iOrder + 1 ) ); j++ )
+  {
+    pdQ[j] = adQ[j];
+  }
+} // }}}
+
+
+/*! \fn       static int solve( const double *pdP, const double *pdQ, int iOrder, int iK, double *pdCoefficients ) // {{{
+ *  \brief    Solves the normal equations of the order iK ( <= iOrder ) for x, y and z at once
+ *            (Gauss elimination with partial pivoting).
+ *
+ *  \return   0 on success, -1 if the system is singular
+ */
+static int solve( const double *pdP, const double *pdQ, int iOrder, int iK, double *pdCoefficients )
+{
+  int    i  = 0;
+  int    j  = 0;
+  int    r  = 0;
+  int    iN = iK + 1;
+  double adM[ iN ][ iN + 3 ];
+
+  for( i = 0; i < iN; i++ )
+  {
+    for( j = 0; j < iN; j++ )
+    {
+      adM[i][j] = pdP[ i + j ];
+    }
+
+    for( j = 0; j < 3; j++ )
+    {
+      adM[i][ iN + j ] = pdQ[ ( j * ( iOrder + 1 ) ) + i ];
+    }
+  }
+
+  for( i = 0; i < iN; i++ )
+  {
+    int iPivot = i;
+
+    for( r = i + 1; r < iN; r++ )
+    {
+      if( fabs( adM[r][i] ) > fabs( adM[ iPivot ][i] ) )
+      {
+        iPivot = r;
+      }
+    }
+
+    if( fabs( adM[ iPivot ][i] ) <= ( 1e-12 * pdP[0] ) )
+    {
+      return -1;
+    }
+
+    if( iPivot != i )
+    {
+      for( j = 0; j < ( iN + 3 ); j++ )
+      {
+        double dTemp      = adM[i][j];
+        adM[i][j]         = adM[ iPivot ][j];
+        adM[ iPivot ][j]  = dTemp;
+      }
+    }
+
+    for( r = i + 1; r < iN; r++ )
+    {
+      double dFactor = adM[r][i] / adM[i][i];
+
+      for( j = i; j < ( iN + 3 ); j++ )
+      {
+        adM[r][j] -= dFactor * adM[i][j];
+      }
+    }
+  }
+
+  for( j = 0; j < 3; j++ )
+  {
+    for( i = iN - 1; i >= 0; i-- )
+    {
+      double dSum = adM[i][ iN + j ];
+
+      for( r = i + 1; r < iN; r++ )
+      {
+        dSum -= adM[i][r] * pdCoefficients[ ( j * ( iOrder + 1 ) ) + r ];
+      }
+
+      pdCoefficients[ ( j * ( iOrder + 1 ) ) + i ] = dSum / adM[i][i];
+    }
+
+    for( i = iN; i <= iOrder; i++ )
+    {
+      pdCoefficients[ ( j * ( iOrder + 1 ) ) + i ] = 0.0;
+    }
+  }
+
+  return 0;
+} // }}}
+
+
+/*! \fn       int c_arc_length_smooth( const double *pdX, int iPoints, int iWindow, int iOrder, double *pdOut ) // {{{
+ *  \brief    Smooths a 3D trajectory with polynomials x(t), y(t), z(t) of the order k over the
+ *            cumulative arc length t (same parameterization as Filter#filter_motion_capture_data).
+ *
+ *            The trajectory is walked once with windows of W = 2h points which overlap by
+ *            h = iWindow / 2 points. The least squares normal equations (power sums of the local
+ *            parameter u = ( t - c ) / L) are kept running: when the window moves by h points they
+ *            are rebased onto the new window center and scale, the h leaving points are removed
+ *            and the h entering ones added. Every point gets the fits of the windows covering it,
+ *            blended with sin^2 weights which sum up to one for two overlapping windows, so there
+ *            are no jumps at window boundaries. Rebasing amplifies rounding errors, so the sums are
+ *            rebuilt from scratch whenever the accumulated amplification would exceed
+ *            C_ARC_SMOOTH_MAX_GROWTH. If a window is degenerate (e.g. a marker which
+ *            does not move) the order is reduced until the system can be solved.
+ *
+ *  \param    pdX         Trajectory of iPoints rows, interleaved [ x0, y0, z0, x1, y1, z1, ... ]
+ *  \param    iPoints     Number of points n
+ *  \param    iWindow     Point window, windows of 2 * ( iWindow / 2 ) points advancing by iWindow / 2
+ *  \param    iOrder      Order k of the polynomials, at most C_ARC_SMOOTH_MAX_ORDER
+ *  \param    pdOut       Output, n rows [ x, y, z ], must not overlap pdX
+ *
+ *  \return   Number of rows written (n), -1 on invalid arguments or out of memory
+ */
+int c_arc_length_smooth( const double *pdX, int iPoints, int iWindow, int iOrder, double *pdOut )
+{
+  const double dPi      = 3.14159265358979323846;
+  int          iHop     = ( ( iWindow / 2 ) < 1 ) ? ( 1 ) : ( iWindow / 2 );
+  int          iSpan    = 2 * iHop;
+  int          iStart   = 0;
+  int          iEnd     = 0;
+  int          iCount   = 0;
+  int          i        = 0;
+  int          a        = 0;
+  int          k        = 0;
+  double       dC       = 0.0;
+  double       dL       = 1.0;
+  double       dGrowth  = 0.0;
+  double      *pdT      = NULL;
+  double      *pdWeight = NULL;
+  double       adP[ ( 2 * C_ARC_SMOOTH_MAX_ORDER ) + 1 ];
+  double       adQ[ 3 * ( C_ARC_SMOOTH_MAX_ORDER + 1 ) ];
+  double       adCoefficients[ 3 * ( C_ARC_SMOOTH_MAX_ORDER + 1 ) ];
+
+  if( ( iPoints < 1 ) || ( iWindow < 0 ) || ( iOrder < 0 ) || ( iOrder > C_ARC_SMOOTH_MAX_ORDER ) )
+  {
+    return -1;
+  }
+
+  pdT       = ( double * ) malloc( sizeof( double ) * ( size_t ) iPoints );
+  pdWeight  = ( double * ) calloc( ( size_t ) iPoints, sizeof( double ) );
+
+  if( ( pdT == NULL ) || ( pdWeight == NULL ) )
+  {
+    free( pdT );
+    free( pdWeight );
+    return -1;
+  }
+
+  // cumulative arc length t, t[0] = 0
+  pdT[0] = 0.0;
+  for( i = 1; i < iPoints; i++ )
+  {
+    double dX = pdX[ ( 3 * i ) + 0 ] - pdX[ ( 3 * ( i - 1 ) ) + 0 ];
+    double dY = pdX[ ( 3 * i ) + 1 ] - pdX[ ( 3 * ( i - 1 ) ) + 1 ];
+    double dZ = pdX[ ( 3 * i ) + 2 ] - pdX[ ( 3 * ( i - 1 ) ) + 2 ];
+
+    pdT[i] = pdT[ i - 1 ] + sqrt( ( dX * dX ) + ( dY * dY ) + ( dZ * dZ ) );
+  }
+
+  for( i = 0; i < ( 3 * iPoints ); i++ )
+  {
+    pdOut[i] = 0.0;
+  }
+
+  for( iStart = 0; iStart < iPoints; iStart += iHop )
+  {
+    int    iNewEnd = ( ( iStart + iSpan ) > iPoints ) ? ( iPoints ) : ( iStart + iSpan );
+    double dNewC   = 0.5 * ( pdT[ iNewEnd - 1 ] + pdT[ iStart ] );
+    double dNewL   = 0.5 * ( pdT[ iNewEnd - 1 ] - pdT[ iStart ] );
+    double dStep   = 0.0;
+
+    dNewL = ( dNewL > 1e-12 ) ? ( dNewL ) : ( 1.0 );
+
+    // a rebase u' = alpha * u + beta can amplify rounding errors by up to ( |alpha| + |beta| )^2k
+    dStep = pow( fabs( dL / dNewL ) + fabs( ( dC - dNewC ) / dNewL ), 2.0 * iOrder );
+
+    if( ( iCount == 0 ) || ( ( dGrowth * dStep ) > C_ARC_SMOOTH_MAX_GROWTH ) )
+    {
+      dGrowth = 1.0;
+
+      // (re)build the sums of this window from scratch
+      for( k = 0; k <= ( 2 * iOrder ); k++ )
+      {
+        adP[k] = 0.0;
+      }
+
+      for( k = 0; k < ( 3 * ( iOrder + 1 ) ); k++ )
+      {
+        adQ[k] = 0.0;
+      }
+
+      sums_add( pdT, pdX, iStart, iNewEnd, dNewC, dNewL, iOrder, 1.0, adP, adQ );
+    }
+    else
+    {
+      // running update: rebase, drop the points before iStart, add the new ones
+      dGrowth *= dStep;
+      sums_rebase( dL / dNewL, ( dC - dNewC ) / dNewL, iOrder, adP, adQ );
+      sums_add( pdT, pdX, iStart - iHop, iStart, dNewC, dNewL, iOrder, -1.0, adP, adQ );
+      sums_add( pdT, pdX, iEnd, iNewEnd, dNewC, dNewL, iOrder, 1.0, adP, adQ );
+    }
+
+    iEnd  = iNewEnd;
+    dC    = dNewC;
+    dL    = dNewL;
+    iCount++;
+
+    // highest order which can be solved for this window
+    for( k = ( ( iOrder < ( iEnd - iStart - 1 ) ) ? ( iOrder ) : ( iEnd - iStart - 1 ) ); k > 0; k-- )
+    {
+      if( solve( adP, adQ, iOrder, k, adCoefficients ) == 0 )
+      {
+        break;
+      }
+    }
+
+    if( k == 0 )
+    {
+      solve( adP, adQ, iOrder, 0, adCoefficients );
+    }
+
+    // evaluate (Horner) and blend into the output
+    for( i = iStart; i < iEnd; i++ )
+    {
+      double dU = ( pdT[i] - dC ) / dL;
+      double dS = sin( ( dPi * ( ( double ) ( i - iStart ) + 0.5 ) ) / ( double ) iSpan );
+      double dW = dS * dS;
+
+      for( a = 0; a < 3; a++ )
+      {
+        const double *pdA  = adCoefficients + ( a * ( iOrder + 1 ) );
+        double        dFit = pdA[ iOrder ];
+
+        for( k = iOrder - 1; k >= 0; k-- )
+        {
+          dFit = ( dFit * dU ) + pdA[k];
+        }
+
+        pdOut[ ( 3 * i ) + a ] += dW * dFit;
+      }
+
+      pdWeight[i] += dW;
+    }
+
+    if( iEnd == iPoints )
+    {
+      break;
+    }
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    for( a = 0; a < 3; a++ )
+    {
+      pdOut[ ( 3 * i ) + a ] /= pdWeight[i];
+    }
+  }
+
+  free( pdT );
+  free( pdWeight );
+
+  return iPoints;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
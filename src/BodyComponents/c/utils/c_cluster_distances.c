@@ -0,0 +1,464 @@
+/*!
+ *
+ * \file        c_cluster_distances.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Summed and mean inter cluster distances (blocked, threaded pairwise or exact squared from moments).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_cluster_distances.h"      ///< Include own header
+
+
+/*! \struct   pairwise_pool
+ *  \brief    Points sorted by cluster and cut into chunks of at most C_CLUSTER_DISTANCES_BLOCK
+ *            points of one cluster. Threads take row chunks, a row chunk is paired with every later
+ *            chunk of another cluster.
+ */
+typedef struct
+{
+  const double    *pdSorted;          ///< iDimensions x iPoints, dimension major (structure of arrays)
+  int              iPoints;
+  int              iDimensions;
+  int              iK;
+  int              iChunks;
+  const int       *piStart;           ///< first sorted point of every chunk
+  const int       *piLength;
+  const int       *piLabel;
+  double          *pdRows;            ///< iChunks x iK, summed distances of a row chunk to every cluster
+  int              iNext;             ///< next row chunk to hand out
+  int              iFailed;
+  pthread_mutex_t  tLock;
+} pairwise_pool;
+
+
+/*! \fn       static double tile_sum( const pairwise_pool *ptPool, int iA, int iB, double *pdScratch ) // {{{
+ *  \brief    Sum of the distances of all points of chunk iA to all points of chunk iB. The inner
+ *            loops run over the (contiguous) coordinates of chunk iB, one dimension at a time.
+ */
+static double tile_sum( const pairwise_pool *ptPool, int iA, int iB, double *pdScratch )
+{
+  int    i      = 0;
+  int    j      = 0;
+  int    c      = 0;
+  int    iN     = ptPool->iPoints;
+  int    iLB    = ptPool->piLength[ iB ];
+  double dSum   = 0.0;
+
+  for( i = ptPool->piStart[ iA ]; i < ( ptPool->piStart[ iA ] + ptPool->piLength[ iA ] ); i++ )
+  {
+    for( j = 0; j < iLB; j++ )
+    {
+      pdScratch[j] = 0.0;
+    }
+
+    for( c = 0; c < ptPool->iDimensions; c++ )
+    {
+      const double *pdB = ptPool->pdSorted + ( ( long ) c * iN ) + ptPool->piStart[ iB ];
+      double        dA  = ptPool->pdSorted[ ( long ) c * iN + i ];
+
+      for( j = 0; j < iLB; j++ )
+      {
+        pdScratch[j] += ( pdB[j] - dA ) * ( pdB[j] - dA );
+      }
+    }
+
+    for( j = 0; j < iLB; j++ )
+    {
+      dSum += sqrt( pdScratch[j] );
+    }
+  }
+
+  return dSum;
+} // }}}
+
+
+/*! \fn       static void *pairwise_thread( void *pvPool ) // {{{
+ *  \brief    Takes row chunks until none are left. Every row has its own accumulator, so the result
+ *            does not depend on the number of threads.
+ */
+static void *pairwise_thread( void *pvPool )
+{
+  pairwise_pool *ptPool     = ( pairwise_pool * ) pvPool;
+  double        *pdScratch  = ( double * ) malloc( sizeof( double ) * C_CLUSTER_DISTANCES_BLOCK );
+  int            iFailed    = ( pdScratch == NULL );
+
+  for( ;; )
+  {
+    int iA = 0;
+    int iB = 0;
+
+    pthread_mutex_lock( &( ptPool->tLock ) );
+    iA              = ptPool->iNext;
+    ptPool->iNext  += 1;
+    ptPool->iFailed = ptPool->iFailed || iFailed;
+    pthread_mutex_unlock( &( ptPool->tLock ) );
+
+    if( iFailed || ( iA >= ptPool->iChunks ) )
+    {
+      break;
+    }
+
+    // chunks are sorted by cluster, the ones of the same cluster directly follow and are skipped
+    iB = iA + 1;
+    while( ( iB < ptPool->iChunks ) && ( ptPool->piLabel[ iB ] == ptPool->piLabel[ iA ] ) )
+    {
+      iB++;
+    }
+
+    for( ; iB < ptPool->iChunks; iB++ )
+    {
+      ptPool->pdRows[ ( long ) iA * ptPool->iK + ptPool->piLabel[ iB ] ] += tile_sum( ptPool, iA, iB, pdScratch );
+    }
+  }
+
+  free( pdScratch );
+
+  return NULL;
+} // }}}
+
+
+/*! \fn       static int cluster_counts( const double *pdLabels, int iPoints, int iK, long *plCounts ) // {{{
+ *  \brief    Number of points of every cluster
+ *
+ *  \return   0 on success, -1 if a label is outside of [ 0, k )
+ */
+static int cluster_counts( const double *pdLabels, int iPoints, int iK, long *plCounts )
+{
+  int i = 0;
+
+  memset( plCounts, 0, sizeof( long ) * iK );
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    int iLabel = ( int ) pdLabels[i];
+
+    if( ( iLabel < 0 ) || ( iLabel >= iK ) )
+    {
+      return -1;
+    }
+
+    plCounts[ iLabel ]++;
+  }
+
+  return 0;
+} // }}}
+
+
+/*! \fn       static void cluster_means( const double *pdSums, const long *plCounts, int iK, double *pdMeans ) // {{{
+ *  \brief    pdMeans = pdSums / ( n_A n_B ), zero on the diagonal and for empty clusters
+ */
+static void cluster_means( const double *pdSums, const long *plCounts, int iK, double *pdMeans )
+{
+  int a = 0;
+  int b = 0;
+
+  for( a = 0; a < iK; a++ )
+  {
+    for( b = 0; b < iK; b++ )
+    {
+      int iIndex        = a * iK + b;
+
+      pdMeans[ iIndex ] = ( ( a == b ) || ( plCounts[a] == 0 ) || ( plCounts[b] == 0 ) ) ? ( 0.0 ) : ( pdSums[ iIndex ] / ( ( double ) plCounts[a] * ( double ) plCounts[b] ) );
+    }
+  }
+} // }}}
+
+
+/*! \fn       int c_cluster_distances( const double *pdData, int iPoints, int iDimensions, const double *pdLabels, int iK, int iThreads, double *pdSums, double *pdMeans ) // {{{
+ *  \brief    k x k matrix of the summed Euclidean distances of every point of cluster A to every
+ *            point of cluster B, and the mean ( sum / ( n_A n_B ) ). Only the pairs A < B are
+ *            computed (the matrix is symmetric, the diagonal is zero):
+ *
+ *              o points are sorted by cluster into a structure of arrays buffer (one pass)
+ *              o clusters are cut into chunks of C_CLUSTER_DISTANCES_BLOCK points, every pair of
+ *                chunks (tile) is one cache resident block of n_a x n_b distances
+ *              o the row chunks are spread over iThreads threads (the calling one included),
+ *                every row sums into its own accumulator, reduced in order afterwards
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    pdLabels        Cluster index of every point ( n values in [ 0, k ) )
+ *  \param    iK              Number of clusters k
+ *  \param    iThreads        Number of worker threads
+ *  \param    pdSums          Output, k x k summed distances
+ *  \param    pdMeans         Output, k x k mean distances
+ *
+ *  \return   k, -1 on invalid arguments or if memory could not be allocated
+ */
+int c_cluster_distances( const double *pdData, int iPoints, int iDimensions, const double *pdLabels, int iK, int iThreads, double *pdSums, double *pdMeans )
+{
+  int            i         = 0;
+  int            c         = 0;
+  int            t         = 0;
+  int            iStarted  = 0;
+  int            iChunks   = 0;
+  long          *plCounts  = NULL;
+  long          *plFill    = NULL;
+  double        *pdSorted  = NULL;
+  int           *piStart   = NULL;
+  int           *piLength  = NULL;
+  int           *piLabel   = NULL;
+  double        *pdRows    = NULL;
+  pthread_t     *ptThreads = NULL;
+  pairwise_pool  tPool;
+
+  if( ( pdData == NULL ) || ( pdLabels == NULL ) || ( pdSums == NULL ) || ( pdMeans == NULL ) || ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) )
+  {
+    return -1;
+  }
+
+  plCounts  = ( long * ) malloc( sizeof( long ) * iK );
+  plFill    = ( long * ) malloc( sizeof( long ) * iK );
+  pdSorted  = ( double * ) malloc( sizeof( double ) * iPoints * iDimensions );
+
+  // at most one partial chunk per cluster
+  piStart   = ( int * ) malloc( sizeof( int ) * ( iPoints / C_CLUSTER_DISTANCES_BLOCK + iK ) );
+  piLength  = ( int * ) malloc( sizeof( int ) * ( iPoints / C_CLUSTER_DISTANCES_BLOCK + iK ) );
+  piLabel   = ( int * ) malloc( sizeof( int ) * ( iPoints / C_CLUSTER_DISTANCES_BLOCK + iK ) );
+
+  if( ( plCounts == NULL ) || ( plFill == NULL ) || ( pdSorted == NULL ) || ( piStart == NULL ) || ( piLength == NULL ) || ( piLabel == NULL ) || ( cluster_counts( pdLabels, iPoints, iK, plCounts ) != 0 ) )
+  {
+    free( plCounts );
+    free( plFill );
+    free( pdSorted );
+    free( piStart );
+    free( piLength );
+    free( piLabel );
+    return -1;
+  }
+
+  // counting sort by cluster, chunks follow the cluster order
+  for( c = 0, i = 0; c < iK; c++ )
+  {
+    long lOffset = 0;
+
+    plFill[c] = i;
+
+    for( lOffset = 0; lOffset < plCounts[c]; lOffset += C_CLUSTER_DISTANCES_BLOCK )
+    {
+      piStart[ iChunks ]  = i + ( int ) lOffset;
+      piLength[ iChunks ] = ( ( plCounts[c] - lOffset ) > C_CLUSTER_DISTANCES_BLOCK ) ? ( C_CLUSTER_DISTANCES_BLOCK ) : ( ( int ) ( plCounts[c] - lOffset ) );
+      piLabel[ iChunks ]  = c;
+      iChunks++;
+    }
+
+    i += ( int ) plCounts[c];
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    long lTo = plFill[ ( int ) pdLabels[i] ]++;
+
+    for( c = 0; c < iDimensions; c++ )
+    {
+      pdSorted[ ( long ) c * iPoints + lTo ] = pdData[ ( long ) i * iDimensions + c ];
+    }
+  }
+
+  iThreads  = ( iThreads < 1 ) ? ( 1 ) : ( ( iThreads > iChunks ) ? ( iChunks ) : ( iThreads ) );
+  pdRows    = ( double * ) calloc( ( size_t ) iChunks * iK, sizeof( double ) );
+  ptThreads = ( pthread_t * ) malloc( sizeof( pthread_t ) * iThreads );
+
+  if( ( pdRows == NULL ) || ( ptThreads == NULL ) || ( pthread_mutex_init( &( tPool.tLock ), NULL ) != 0 ) )
+  {
+    free( plCounts );
+    free( plFill );
+    free( pdSorted );
+    free( piStart );
+    free( piLength );
+    free( piLabel );
+    free( pdRows );
+    free( ptThreads );
+    return -1;
+  }
+
+  tPool.pdSorted     = pdSorted;
+  tPool.iPoints      = iPoints;
+  tPool.iDimensions  = iDimensions;
+  tPool.iK           = iK;
+  tPool.iChunks      = iChunks;
+  tPool.piStart      = piStart;
+  tPool.piLength     = piLength;
+  tPool.piLabel      = piLabel;
+  tPool.pdRows       = pdRows;
+  tPool.iNext        = 0;
+  tPool.iFailed      = 0;
+
+  // the calling thread works too, if a thread cannot be started the others take its share
+  for( t = 1; t < iThreads; t++ )
+  {
+    if( pthread_create( &( ptThreads[ iStarted ] ), NULL, pairwise_thread, &tPool ) == 0 )
+    {
+      iStarted++;
+    }
+  }
+
+  pairwise_thread( &tPool );
+
+  for( t = 0; t < iStarted; t++ )
+  {
+    pthread_join( ptThreads[t], NULL );
+  }
+
+  pthread_mutex_destroy( &( tPool.tLock ) );
+
+  // rows of cluster A only hold the clusters B > A, mirror them
+  memset( pdSums, 0, sizeof( double ) * iK * iK );
+
+  for( i = 0; i < iChunks; i++ )
+  {
+    for( c = piLabel[i] + 1; c < iK; c++ )
+    {
+      pdSums[ piLabel[i] * iK + c ] += pdRows[ ( long ) i * iK + c ];
+    }
+  }
+
+  for( i = 0; i < iK; i++ )
+  {
+    for( c = i + 1; c < iK; c++ )
+    {
+      pdSums[ c * iK + i ] = pdSums[ i * iK + c ];
+    }
+  }
+
+  cluster_means( pdSums, plCounts, iK, pdMeans );
+
+  free( plCounts );
+  free( plFill );
+  free( pdSorted );
+  free( piStart );
+  free( piLength );
+  free( piLabel );
+  free( pdRows );
+  free( ptThreads );
+
+  return ( tPool.iFailed ) ? ( -1 ) : ( iK );
+} // }}}
+
+
+/*! \fn       int c_cluster_distances_squared( const double *pdData, int iPoints, int iDimensions, const double *pdLabels, int iK, double *pdSums, double *pdMeans ) // {{{
+ *  \brief    Exact k x k matrix of the summed squared Euclidean distances of all point pairs of
+ *            two clusters, from per cluster moments in O( n d ) instead of O( n^2 d ):
+ *
+ *              sum_a sum_b | a - b |^2 = n_B S_A + n_A S_B + n_A n_B | mu_A - mu_B |^2
+ *
+ *            with mu the mean and S = sum | x - mu |^2 the scatter of a cluster (two passes, no
+ *            cancellation of large raw moments). The mean is S_A / n_A + S_B / n_B + | mu_A - mu_B |^2.
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    pdLabels        Cluster index of every point ( n values in [ 0, k ) )
+ *  \param    iK              Number of clusters k
+ *  \param    pdSums          Output, k x k summed squared distances
+ *  \param    pdMeans         Output, k x k mean squared distances
+ *
+ *  \return   k, -1 on invalid arguments or if memory could not be allocated
+ */
+int c_cluster_distances_squared( const double *pdData, int iPoints, int iDimensions, const double *pdLabels, int iK, double *pdSums, double *pdMeans )
+{
+  int     i         = 0;
+  int     a         = 0;
+  int     b         = 0;
+  int     c         = 0;
+  long   *plCounts  = NULL;
+  double *pdMu      = NULL;
+  double *pdScatter = NULL;
+
+  if( ( pdData == NULL ) || ( pdLabels == NULL ) || ( pdSums == NULL ) || ( pdMeans == NULL ) || ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) )
+  {
+    return -1;
+  }
+
+  plCounts  = ( long * ) malloc( sizeof( long ) * iK );
+  pdMu      = ( double * ) calloc( ( size_t ) iK * iDimensions, sizeof( double ) );
+  pdScatter = ( double * ) calloc( ( size_t ) iK, sizeof( double ) );
+
+  if( ( plCounts == NULL ) || ( pdMu == NULL ) || ( pdScatter == NULL ) || ( cluster_counts( pdLabels, iPoints, iK, plCounts ) != 0 ) )
+  {
+    free( plCounts );
+    free( pdMu );
+    free( pdScatter );
+    return -1;
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    double *pdM = pdMu + ( ( int ) pdLabels[i] * iDimensions );
+
+    for( c = 0; c < iDimensions; c++ )
+    {
+      pdM[c] += pdData[ ( long ) i * iDimensions + c ];
+    }
+  }
+
+  for( a = 0; a < iK; a++ )
+  {
+    for( c = 0; ( c < iDimensions ) && ( plCounts[a] > 0 ); c++ )
+    {
+      pdMu[ a * iDimensions + c ] /= ( double ) plCounts[a];
+    }
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    const double *pdM = pdMu + ( ( int ) pdLabels[i] * iDimensions );
+
+    for( c = 0; c < iDimensions; c++ )
+    {
+      double dD = pdData[ ( long ) i * iDimensions + c ] - pdM[c];
+
+      pdScatter[ ( int ) pdLabels[i] ] += dD * dD;
+    }
+  }
+
+  for( a = 0; a < iK; a++ )
+  {
+    for( b = 0; b < iK; b++ )
+    {
+      double dMu = 0.0;
+
+      for( c = 0; c < iDimensions; c++ )
+      {
+        double dD = pdMu[ a * iDimensions + c ] - pdMu[ b * iDimensions + c ];
+
+        dMu += dD * dD;
+      }
+
+      pdSums[ a * iK + b ] = ( a == b ) ? ( 0.0 ) : ( ( double ) plCounts[b] * pdScatter[a] + ( double ) plCounts[a] * pdScatter[b] + ( double ) plCounts[a] * ( double ) plCounts[b] * dMu );
+    }
+  }
+
+  cluster_means( pdSums, plCounts, iK, pdMeans );
+
+  free( plCounts );
+  free( pdMu );
+  free( pdScatter );
+
+  return iK;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
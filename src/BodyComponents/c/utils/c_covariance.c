@@ -0,0 +1,247 @@
+/*!
+ *
+ * \file        c_covariance.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       One pass (Welford) covariance accumulators which can be merged.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stdlib.h>
+#include "c_covariance.h"             ///< Include own header
+
+
+/*! \fn       int c_covariance_accumulator_size( int iDimensions ) // {{{
+ *  \brief    Number of doubles an accumulator for iDimensions dimensions needs.
+ */
+int c_covariance_accumulator_size( int iDimensions )
+{
+  if( iDimensions < 1 )
+  {
+    return -1;
+  }
+
+  return C_COVARIANCE_ACCUMULATOR_SIZE( iDimensions );
+} // }}}
+
+
+/*! \fn       int c_covariance_init( int iDimensions, double *pdAccumulator ) // {{{
+ *  \brief    Resets an accumulator to the empty set of iDimensions dimensions.
+ *
+ *  \param    iDimensions     Number of dimensions d
+ *  \param    pdAccumulator   Output, c_covariance_accumulator_size( d ) values
+ *
+ *  \return   Number of values written, -1 on invalid arguments
+ */
+int c_covariance_init( int iDimensions, double *pdAccumulator )
+{
+  int i     = 0;
+  int iSize = c_covariance_accumulator_size( iDimensions );
+
+  if( iSize < 0 )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iSize; i++ )
+  {
+    pdAccumulator[i] = 0.0;
+  }
+
+  pdAccumulator[0] = ( double ) iDimensions;
+
+  return iSize;
+} // }}}
+
+
+/*! \fn       int c_covariance_accumulate( const double *pdData, int iRows, int iDimensions, double *pdAccumulator ) // {{{
+ *  \brief    Adds iRows observations to the accumulator with the Welford update
+ *
+ *              n      = n + 1
+ *              delta  = x - mean
+ *              mean   = mean + delta / n
+ *              M2     = M2 + delta * ( x - mean )^T
+ *
+ *            Only the upper triangle of M2 is updated, the lower one is mirrored at the end.
+ *
+ *  \param    pdData          Observations, iRows rows of iDimensions values (row major)
+ *  \param    iRows           Number of observations n
+ *  \param    iDimensions     Number of dimensions d, has to match the accumulator
+ *  \param    pdAccumulator   Accumulator, see c_covariance_init
+ *
+ *  \return   Number of observations in the accumulator, -1 on invalid arguments
+ */
+int c_covariance_accumulate( const double *pdData, int iRows, int iDimensions, double *pdAccumulator )
+{
+  int     r       = 0;
+  int     i       = 0;
+  int     j       = 0;
+  double  dN      = 0.0;
+  double *pdMean  = pdAccumulator + 2;
+  double *pdM2    = pdAccumulator + 2 + iDimensions;
+  double *pdDelta = NULL;
+
+  if( ( iRows < 0 ) || ( iDimensions < 1 ) || ( ( int ) pdAccumulator[0] != iDimensions ) )
+  {
+    return -1;
+  }
+
+  pdDelta = ( double * ) malloc( sizeof( double ) * iDimensions );
+
+  if( pdDelta == NULL )
+  {
+    return -1;
+  }
+
+  dN = pdAccumulator[1];
+
+  for( r = 0; r < iRows; r++ )
+  {
+    const double *pdX = pdData + ( ( long ) r * iDimensions );
+
+    dN += 1.0;
+
+    for( i = 0; i < iDimensions; i++ )
+    {
+      pdDelta[i]  = pdX[i] - pdMean[i];
+      pdMean[i]  += pdDelta[i] / dN;
+    }
+
+    for( i = 0; i < iDimensions; i++ )
+    {
+      double *pdRow = pdM2 + ( i * iDimensions );
+
+      for( j = i; j < iDimensions; j++ )
+      {
+        pdRow[j] += pdDelta[i] * ( pdX[j] - pdMean[j] );
+      }
+    }
+  }
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    for( j = 0; j < i; j++ )
+    {
+      pdM2[ ( i * iDimensions ) + j ] = pdM2[ ( j * iDimensions ) + i ];
+    }
+  }
+
+  free( pdDelta );
+
+  pdAccumulator[1] = dN;
+
+  return ( int ) dN;
+} // }}}
+
+
+/*! \fn       int c_covariance_merge( double *pdAccumulator, const double *pdOther ) // {{{
+ *  \brief    Merges the accumulator pdOther (e.g. of a chunk done in parallel) into pdAccumulator
+ *            (Chan et al. pairwise update)
+ *
+ *              n      = nA + nB
+ *              delta  = meanB - meanA
+ *              mean   = meanA + delta * nB / n
+ *              M2     = M2A + M2B + delta * delta^T * nA * nB / n
+ *
+ *  \param    pdAccumulator   Accumulator A, updated in place
+ *  \param    pdOther         Accumulator B of the same dimension
+ *
+ *  \return   Number of observations in the merged accumulator, -1 on invalid arguments
+ */
+int c_covariance_merge( double *pdAccumulator, const double *pdOther )
+{
+  int     i           = 0;
+  int     j           = 0;
+  int     iDimensions = ( int ) pdAccumulator[0];
+  double  dNA         = pdAccumulator[1];
+  double  dNB         = pdOther[1];
+  double  dN          = dNA + dNB;
+  double *pdMean      = pdAccumulator + 2;
+  double *pdM2        = pdAccumulator + 2 + iDimensions;
+  double *pdDelta     = NULL;
+
+  if( ( iDimensions < 1 ) || ( ( int ) pdOther[0] != iDimensions ) )
+  {
+    return -1;
+  }
+
+  if( dNB == 0.0 )
+  {
+    return ( int ) dNA;
+  }
+
+  pdDelta = ( double * ) malloc( sizeof( double ) * iDimensions );
+
+  if( pdDelta == NULL )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    pdDelta[i]  = pdOther[ 2 + i ] - pdMean[i];
+    pdMean[i]  += pdDelta[i] * ( dNB / dN );
+  }
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    for( j = 0; j < iDimensions; j++ )
+    {
+      pdM2[ ( i * iDimensions ) + j ] += pdOther[ 2 + iDimensions + ( i * iDimensions ) + j ] + ( pdDelta[i] * pdDelta[j] * ( ( dNA * dNB ) / dN ) );
+    }
+  }
+
+  free( pdDelta );
+
+  pdAccumulator[1] = dN;
+
+  return ( int ) dN;
+} // }}}
+
+
+/*! \fn       int c_covariance_matrix( const double *pdAccumulator, double *pdCovariance ) // {{{
+ *  \brief    Sample covariance matrix ( M2 / ( n - 1 ) ) of an accumulator.
+ *
+ *  \param    pdAccumulator   Accumulator with at least two observations
+ *  \param    pdCovariance    Output, d x d values (row major)
+ *
+ *  \return   Number of values written (d * d), -1 on invalid arguments
+ */
+int c_covariance_matrix( const double *pdAccumulator, double *pdCovariance )
+{
+  int           i           = 0;
+  int           iDimensions = ( int ) pdAccumulator[0];
+  double        dN          = pdAccumulator[1];
+  const double *pdM2        = pdAccumulator + 2 + iDimensions;
+
+  if( ( iDimensions < 1 ) || ( dN < 2.0 ) )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < ( iDimensions * iDimensions ); i++ )
+  {
+    pdCovariance[i] = pdM2[i] / ( dN - 1.0 );
+  }
+
+  return ( iDimensions * iDimensions );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
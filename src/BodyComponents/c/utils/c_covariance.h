@@ -0,0 +1,43 @@
+/*!
+ *
+ * \file        c_covariance.h
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       One pass (Welford) covariance accumulators which can be merged.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#ifndef _C_COVARIANCE_H_
+#  define _C_COVARIANCE_H_
+
+
+///! Accumulator layout (doubles): [ d, n, mean( d ), M2( d x d, row major ) ]
+#  define C_COVARIANCE_ACCUMULATOR_SIZE( iDimensions ) ( 2 + ( iDimensions ) + ( ( iDimensions ) * ( iDimensions ) ) )
+
+///! Prototypes
+int c_covariance_accumulator_size( int /* iDimensions */ );
+int c_covariance_init( int /* iDimensions */, double * /* pdAccumulator */ );
+int c_covariance_accumulate( const double * /* pdData */, int /* iRows */, int /* iDimensions */, double * /* pdAccumulator */ );
+int c_covariance_merge( double * /* pdAccumulator */, const double * /* pdOther */ );
+int c_covariance_matrix( const double * /* pdAccumulator */, double * /* pdCovariance */ );
+
+#endif
+
+// vim:ts=2:tw=100:wm=100
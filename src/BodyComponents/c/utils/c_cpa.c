@@ -0,0 +1,122 @@
+/*!
+ *
+ * \file        c_cpa.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Closest point of approach (CPA) of two 3D lines over all frames of a recording.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include "c_cpa.h"                    ///< Include own header
+
+
+/*! \fn       int c_closest_point_of_approach( const double *pdL1P0, const double *pdL1P1, const double *pdL2P0, const double *pdL2P1, const double *pdCenter, int iFrames, double *pdCPA ) // {{{
+ *  \brief    Fused version of Mathematics#distance_of_line_to_line. For every frame the four marker
+ *            positions are made relative to the center marker, the two lines
+ *
+ *              L1(s) = P0 + s * u      u = L1P1 - L1P0
+ *              L2(t) = Q0 + t * v      v = L2P1 - L2P0
+ *
+ *            are solved for the parameters sc, tc of their closest points and dP = L1(sc) - L2(tc)
+ *            is written out. If the lines are almost parallel ( a*c - b*b < 1e-8 ) sc is fixed to 0
+ *            and tc is taken with the largest denominator.
+ *
+ *  \param    pdL1P0      Line 1 point 0, iFrames rows, interleaved [ x0, y0, z0, x1, y1, z1, ... ]
+ *  \param    pdL1P1      Line 1 point 1, same layout
+ *  \param    pdL2P0      Line 2 point 0, same layout
+ *  \param    pdL2P1      Line 2 point 1, same layout
+ *  \param    pdCenter    Local coordinate center (e.g. pt30), same layout
+ *  \param    iFrames     Number of frames n
+ *  \param    pdCPA       Output, n rows [ x, y, z ]
+ *
+ *  \return   Number of rows written (n), -1 if there are no frames
+ *
+ *  \note     http://softsurfer.com/Archive/algorithm_0106/algorithm_0106.htm
+ */
+int c_closest_point_of_approach( const double *pdL1P0, const double *pdL1P1, const double *pdL2P0, const double *pdL2P1, const double *pdCenter, int iFrames, double *pdCPA )
+{
+  int i = 0;
+  int k = 0;
+
+  if( iFrames < 1 )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iFrames; i++ )
+  {
+    const int iRow = 3 * i;
+    double    adU[3], adV[3], adW[3];
+    double    dA = 0.0, dB = 0.0, dC = 0.0, dD = 0.0, dE = 0.0;
+    double    dDenominator, dSc, dTc;
+
+    // same arithmetic as the Segment version, all points relative to the center first
+    for( k = 0; k < 3; k++ )
+    {
+      double dP0 = pdL1P0[ iRow + k ] - pdCenter[ iRow + k ];
+      double dP1 = pdL1P1[ iRow + k ] - pdCenter[ iRow + k ];
+      double dQ0 = pdL2P0[ iRow + k ] - pdCenter[ iRow + k ];
+      double dQ1 = pdL2P1[ iRow + k ] - pdCenter[ iRow + k ];
+
+      adU[k]  = dP1 - dP0;
+      adV[k]  = dQ1 - dQ0;
+      adW[k]  = dP0 - dQ0;
+
+      dA     += adU[k] * adU[k];    // always >= 0
+      dB     += adU[k] * adV[k];
+      dC     += adV[k] * adV[k];    // always >= 0
+      dD     += adU[k] * adW[k];
+      dE     += adV[k] * adW[k];
+    }
+
+    dDenominator = ( dA * dC ) - ( dB * dB );   // always >= 0
+
+    // compute the line parameters of the two closest points
+    if( dDenominator < 0.00000001 )
+    {
+      // lines almost parallel - use largest denominator
+      dSc = 0.0;
+
+      if( dB > dC )
+      {
+        dTc = ( dB != 0.0 ) ? ( dD / dB ) : ( 0.0 );
+      }
+      else
+      {
+        dTc = ( dC != 0.0 ) ? ( dE / dC ) : ( 0.0 );
+      }
+    }
+    else
+    {
+      dSc = ( ( dB * dE ) - ( dC * dD ) ) / dDenominator;
+      dTc = ( ( dA * dE ) - ( dB * dD ) ) / dDenominator;
+    }
+
+    // difference of the two closest points, L1(sc) - L2(tc)
+    for( k = 0; k < 3; k++ )
+    {
+      pdCPA[ iRow + k ] = adW[k] + ( dSc * adU[k] ) - ( dTc * adV[k] );
+    }
+  }
+
+  return iFrames;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
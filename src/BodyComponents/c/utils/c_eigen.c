@@ -0,0 +1,240 @@
+/*!
+ *
+ * \file        c_eigen.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Small symmetric eigen problems (PCA) with fixed size stack storage.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include "c_eigen.h"                  ///< Include own header
+
+
+/*! \fn       int c_eigen_symmetric( const double *pdMatrix, int iDimensions, double *pdValues, double *pdVectors ) // {{{
+ *  \brief    Eigen values and vectors of a real symmetric matrix (e.g. a covariance matrix) with
+ *            the cyclic Jacobi method. All work is done on the stack, there is no allocation.
+ *
+ *            The eigen pairs are sorted by descending eigen value (same as GSL symmv_sort with
+ *            SORT_VAL_DESC), the vectors are orthonormal and each one is signed so that its
+ *            largest component is positive.
+ *
+ *  \param    pdMatrix      Symmetric matrix, d x d values (row major)
+ *  \param    iDimensions   Number of dimensions d, at most C_EIGEN_MAX_DIMENSIONS
+ *  \param    pdValues      Output, d eigen values
+ *  \param    pdVectors     Output, d x d values (row major), column i is the eigen vector of pdValues[i]
+ *
+ *  \return   Number of Jacobi sweeps needed, -1 on invalid arguments or if it did not converge
+ */
+int c_eigen_symmetric( const double *pdMatrix, int iDimensions, double *pdValues, double *pdVectors )
+{
+  const int iMaxSweeps = 64;
+  int       n          = iDimensions;
+  int       iSweep     = 0;
+  int       i          = 0;
+  int       j          = 0;
+  int       p          = 0;
+  int       q          = 0;
+  int       r          = 0;
+  double    adA[ C_EIGEN_MAX_DIMENSIONS ][ C_EIGEN_MAX_DIMENSIONS ];
+  double    adV[ C_EIGEN_MAX_DIMENSIONS ][ C_EIGEN_MAX_DIMENSIONS ];
+  int       aiOrder[ C_EIGEN_MAX_DIMENSIONS ];
+  double    dScale     = 0.0;
+
+  if( ( n < 1 ) || ( n > C_EIGEN_MAX_DIMENSIONS ) )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < n; i++ )
+  {
+    for( j = 0; j < n; j++ )
+    {
+      adA[i][j]   = 0.5 * ( pdMatrix[ ( i * n ) + j ] + pdMatrix[ ( j * n ) + i ] );
+      adV[i][j]   = ( i == j ) ? ( 1.0 ) : ( 0.0 );
+      dScale     += adA[i][j] * adA[i][j];
+    }
+  }
+
+  for( iSweep = 0; iSweep < iMaxSweeps; iSweep++ )
+  {
+    double dOff = 0.0;
+
+    for( p = 0; p < n; p++ )
+    {
+      for( q = p + 1; q < n; q++ )
+      {
+        dOff += adA[p][q] * adA[p][q];
+      }
+    }
+
+    // off diagonal norm small compared to the whole matrix (or the zero matrix)
+    if( dOff <= ( 1e-30 * dScale ) )
+    {
+      break;
+    }
+
+    for( p = 0; p < n; p++ )
+    {
+      for( q = p + 1; q < n; q++ )
+      {
+        double dApq = adA[p][q];
+        double dTheta, dT, dC, dS, dTau;
+
+        if( dApq == 0.0 )
+        {
+          continue;
+        }
+
+        // rotation angle which annihilates A[p][q]
+        dTheta  = ( adA[q][q] - adA[p][p] ) / ( 2.0 * dApq );
+        dT      = 1.0 / ( fabs( dTheta ) + sqrt( ( dTheta * dTheta ) + 1.0 ) );
+        dT      = ( dTheta < 0.0 ) ? ( -dT ) : ( dT );
+        dC      = 1.0 / sqrt( ( dT * dT ) + 1.0 );
+        dS      = dT * dC;
+        dTau    = dS / ( 1.0 + dC );
+
+        adA[p][p] -= dT * dApq;
+        adA[q][q] += dT * dApq;
+        adA[p][q]  = 0.0;
+        adA[q][p]  = 0.0;
+
+        for( r = 0; r < n; r++ )
+        {
+          double dG, dH;
+
+          if( ( r != p ) && ( r != q ) )
+          {
+            dG          = adA[r][p];
+            dH          = adA[r][q];
+            adA[r][p]   = dG - ( dS * ( dH + ( dG * dTau ) ) );
+            adA[r][q]   = dH + ( dS * ( dG - ( dH * dTau ) ) );
+            adA[p][r]   = adA[r][p];
+            adA[q][r]   = adA[r][q];
+          }
+
+          dG            = adV[r][p];
+          dH            = adV[r][q];
+          adV[r][p]     = dG - ( dS * ( dH + ( dG * dTau ) ) );
+          adV[r][q]     = dH + ( dS * ( dG - ( dH * dTau ) ) );
+        }
+      }
+    }
+  }
+
+  if( iSweep == iMaxSweeps )
+  {
+    return -1;
+  }
+
+  // sort descending by eigen value (insertion sort, d is small)
+  for( i = 0; i < n; i++ )
+  {
+    aiOrder[i] = i;
+  }
+
+  for( i = 1; i < n; i++ )
+  {
+    int iKey = aiOrder[i];
+
+    for( j = i - 1; ( j >= 0 ) && ( adA[ aiOrder[j] ][ aiOrder[j] ] < adA[ iKey ][ iKey ] ); j-- )
+    {
+      aiOrder[ j + 1 ] = aiOrder[j];
+    }
+
+    aiOrder[ j + 1 ] = iKey;
+  }
+
+  for( j = 0; j < n; j++ )
+  {
+    int    iColumn = aiOrder[j];
+    int    iMax    = 0;
+    double dSign   = 1.0;
+
+    for( i = 1; i < n; i++ )
+    {
+      if( fabs( adV[i][ iColumn ] ) > fabs( adV[ iMax ][ iColumn ] ) )
+      {
+        iMax = i;
+      }
+    }
+
+    dSign       = ( adV[ iMax ][ iColumn ] < 0.0 ) ? ( -1.0 ) : ( 1.0 );
+    pdValues[j] = adA[ iColumn ][ iColumn ];
+
+    for( i = 0; i < n; i++ )
+    {
+      pdVectors[ ( i * n ) + j ] = dSign * adV[i][ iColumn ];
+    }
+  }
+
+  return iSweep;
+} // }}}
+
+
+/*! \fn       int c_eigen_project( const double *pdVectors, int iDimensions, int iComponents, const double *pdData, int iRows, double *pdOut ) // {{{
+ *  \brief    Change of basis onto the first iComponents eigen vectors. The eigen vector matrix is
+ *            orthonormal, so its inverse is its transpose and out = data * V[:, 0..k-1].
+ *
+ *  \param    pdVectors     Output of c_eigen_symmetric, d x d values (row major, eigen vectors as columns)
+ *  \param    iDimensions   Number of dimensions d
+ *  \param    iComponents   Number of principal components k to keep ( 1 <= k <= d )
+ *  \param    pdData        Observations, iRows rows of d values (row major)
+ *  \param    iRows         Number of observations n
+ *  \param    pdOut         Output, n rows of k values (row major)
+ *
+ *  \return   Number of rows written (n), -1 on invalid arguments
+ */
+int c_eigen_project( const double *pdVectors, int iDimensions, int iComponents, const double *pdData, int iRows, double *pdOut )
+{
+  int r = 0;
+  int i = 0;
+  int j = 0;
+
+  if( ( iDimensions < 1 ) || ( iComponents < 1 ) || ( iComponents > iDimensions ) || ( iRows < 0 ) )
+  {
+    return -1;
+  }
+
+  for( r = 0; r < iRows; r++ )
+  {
+    const double *pdX = pdData + ( ( long ) r * iDimensions );
+    double       *pdY = pdOut + ( ( long ) r * iComponents );
+
+    for( j = 0; j < iComponents; j++ )
+    {
+      pdY[j] = 0.0;
+    }
+
+    for( i = 0; i < iDimensions; i++ )
+    {
+      const double *pdRow = pdVectors + ( i * iDimensions );
+
+      for( j = 0; j < iComponents; j++ )
+      {
+        pdY[j] += pdX[i] * pdRow[j];
+      }
+    }
+  }
+
+  return iRows;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
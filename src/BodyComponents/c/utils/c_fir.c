@@ -0,0 +1,234 @@
+/*!
+ *
+ * \file        c_fir.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Streaming FIR filter (running sum boxcar or arbitrary taps).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include "c_fir.h"                    ///< Include own header
+
+
+/*! \fn       int c_fir_state_size( int iTaps ) // {{{
+ *  \brief    Number of doubles the state of a filter with iTaps taps needs.
+ */
+int c_fir_state_size( int iTaps )
+{
+  if( iTaps < 1 )
+  {
+    return -1;
+  }
+
+  return C_FIR_STATE_SIZE( iTaps );
+} // }}}
+
+
+/*! \fn       int c_fir_init( const double *pdTaps, int iTaps, int iBoxcar, double *pdState ) // {{{
+ *  \brief    Sets up a streaming FIR filter
+ *
+ *              y[n] = \sum_{i=0}^{T-1} b_i x[n + i]
+ *
+ *            (same alignment as Filter#box_car_filter, the window starts at the current sample).
+ *            A boxcar ( b_i = 1 / T ) keeps a running sum instead and costs O(1) per sample.
+ *
+ *  \param    pdTaps      Tap weights b, iTaps values (ignored for a boxcar)
+ *  \param    iTaps       Number of taps T
+ *  \param    iBoxcar     If not 0 the filter is a moving average over T samples
+ *  \param    pdState     Output, c_fir_state_size( T ) values
+ *
+ *  \return   Number of values written, -1 on invalid arguments
+ */
+int c_fir_init( const double *pdTaps, int iTaps, int iBoxcar, double *pdState )
+{
+  int i     = 0;
+  int iSize = c_fir_state_size( iTaps );
+
+  if( iSize < 0 )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iSize; i++ )
+  {
+    pdState[i] = 0.0;
+  }
+
+  pdState[0] = ( double ) iTaps;
+  pdState[1] = ( iBoxcar != 0 ) ? ( 1.0 ) : ( 0.0 );
+
+  for( i = 0; i < iTaps; i++ )
+  {
+    pdState[ 5 + i ] = ( iBoxcar != 0 ) ? ( 1.0 / ( double ) iTaps ) : ( pdTaps[i] );
+  }
+
+  return iSize;
+} // }}}
+
+
+/*! \fn       int c_fir_push( double *pdState, const double *pdIn, int iSamples, double *pdOut ) // {{{
+ *  \brief    Feeds iSamples new samples through the filter. Output n needs the samples n..n+T-1,
+ *            so the outputs lag the input by T-1 samples; the last T-1 come out of c_fir_flush.
+ *            Signals can be pushed in pieces of any size.
+ *
+ *  \param    pdState     State of c_fir_init, updated in place
+ *  \param    pdIn        New samples
+ *  \param    iSamples    Number of new samples
+ *  \param    pdOut       Output, room for iSamples values
+ *
+ *  \return   Number of outputs written, -1 on invalid arguments
+ */
+int c_fir_push( double *pdState, const double *pdIn, int iSamples, double *pdOut )
+{
+  int           i       = 0;
+  int           k       = 0;
+  int           iOut    = 0;
+  int           iTaps   = ( int ) pdState[0];
+  int           iBoxcar = ( pdState[1] != 0.0 );
+  long          lSeen   = ( long ) pdState[2];
+  double        dSum    = pdState[3];
+  double        dComp   = pdState[4];
+  const double *pdB     = pdState + 5;
+  double       *pdRing  = pdState + 5 + iTaps;
+
+  if( ( iTaps < 1 ) || ( iSamples < 0 ) )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iSamples; i++ )
+  {
+    int    iSlot = ( int ) ( lSeen % iTaps );
+    double dX    = pdIn[i];
+
+    if( iBoxcar )
+    {
+      // running sum with Neumaier compensation: + new sample, - the one leaving the window
+      double adTerms[2];
+      int    t;
+
+      adTerms[0] = dX;
+      adTerms[1] = ( lSeen >= iTaps ) ? ( -pdRing[ iSlot ] ) : ( 0.0 );
+
+      for( t = 0; t < 2; t++ )
+      {
+        double dNew = dSum + adTerms[t];
+
+        if( ( ( dSum < 0.0 ) ? ( -dSum ) : ( dSum ) ) >= ( ( adTerms[t] < 0.0 ) ? ( -adTerms[t] ) : ( adTerms[t] ) ) )
+        {
+          dComp += ( dSum - dNew ) + adTerms[t];
+        }
+        else
+        {
+          dComp += ( adTerms[t] - dNew ) + dSum;
+        }
+
+        dSum = dNew;
+      }
+    }
+
+    pdRing[ iSlot ] = dX;
+    lSeen++;
+
+    if( lSeen >= iTaps )
+    {
+      if( iBoxcar )
+      {
+        pdOut[ iOut ] = ( dSum + dComp ) / ( double ) iTaps;
+      }
+      else
+      {
+        // oldest sample of the window is the one after the newest
+        double dY = 0.0;
+
+        for( k = 0; k < iTaps; k++ )
+        {
+          dY += pdB[k] * pdRing[ ( lSeen + k ) % iTaps ];
+        }
+
+        pdOut[ iOut ] = dY;
+      }
+
+      iOut++;
+    }
+  }
+
+  pdState[2] = ( double ) lSeen;
+  pdState[3] = dSum;
+  pdState[4] = dComp;
+
+  return iOut;
+} // }}}
+
+
+/*! \fn       int c_fir_flush( const double *pdState, double *pdOut ) // {{{
+ *  \brief    The last (at most T-1) outputs whose windows run over the end of the signal. They use
+ *            the remaining samples only and are rescaled by \sum b / \sum b_used, so a boxcar gives
+ *            the mean of the remaining samples (like Filter#box_car_filter).
+ *
+ *  \param    pdState     State of c_fir_init / c_fir_push
+ *  \param    pdOut       Output, room for T-1 values
+ *
+ *  \return   Number of outputs written, -1 on invalid arguments
+ */
+int c_fir_flush( const double *pdState, double *pdOut )
+{
+  int           k       = 0;
+  int           iOut    = 0;
+  int           iTaps   = ( int ) pdState[0];
+  long          lSeen   = ( long ) pdState[2];
+  long          lFirst  = 0;
+  long          m       = 0;
+  double        dTotal  = 0.0;
+  const double *pdB     = pdState + 5;
+  const double *pdRing  = pdState + 5 + iTaps;
+
+  if( iTaps < 1 )
+  {
+    return -1;
+  }
+
+  for( k = 0; k < iTaps; k++ )
+  {
+    dTotal += pdB[k];
+  }
+
+  lFirst = ( ( lSeen - iTaps + 1 ) < 0 ) ? ( 0 ) : ( lSeen - iTaps + 1 );
+
+  for( m = lFirst; m < lSeen; m++ )
+  {
+    int    iUsed = ( int ) ( lSeen - m );
+    double dY    = 0.0;
+    double dUsed = 0.0;
+
+    for( k = 0; k < iUsed; k++ )
+    {
+      dY    += pdB[k] * pdRing[ ( m + k ) % iTaps ];
+      dUsed += pdB[k];
+    }
+
+    pdOut[ iOut ] = ( dUsed != 0.0 ) ? ( dY * ( dTotal / dUsed ) ) : ( dY );
+    iOut++;
+  }
+
+  return iOut;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
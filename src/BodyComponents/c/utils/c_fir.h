@@ -0,0 +1,42 @@
+/*!
+ *
+ * \file        c_fir.h
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Streaming FIR filter (running sum boxcar or arbitrary taps).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#ifndef _C_FIR_H_
+#  define _C_FIR_H_
+
+
+///! State layout (doubles): [ taps, boxcar, seen, sum, compensation, b( taps ), ring( taps ) ]
+#  define C_FIR_STATE_SIZE( iTaps ) ( 5 + ( 2 * ( iTaps ) ) )
+
+///! Prototypes
+int c_fir_state_size( int /* iTaps */ );
+int c_fir_init( const double * /* pdTaps */, int /* iTaps */, int /* iBoxcar */, double * /* pdState */ );
+int c_fir_push( double * /* pdState */, const double * /* pdIn */, int /* iSamples */, double * /* pdOut */ );
+int c_fir_flush( const double * /* pdState */, double * /* pdOut */ );
+
+#endif
+
+// vim:ts=2:tw=100:wm=100
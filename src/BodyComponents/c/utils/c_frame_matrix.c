@@ -0,0 +1,87 @@
+/*!
+ *
+ * \file        c_frame_matrix.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Strided, center relative views of one marker out of a structure of arrays frame matrix.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stdlib.h>
+
+#include "c_frame_matrix.h"           ///< Include own header
+
+
+/*! \fn       int c_frame_matrix_gather( const double *pdAxis, int iFrames, int iMarker, int iCenter, int iFrom, int iCount, int iStride, int iOffset, double *pdOut ) // {{{
+ *  \brief    Copies the frames [ iFrom, iFrom + iCount ) of one marker out of one axis of a frame
+ *            matrix (see FrameMatrix.rb), optionally relative to a center marker
+ *
+ *              pdOut[ iOffset + i * iStride ] = A[ m ][ iFrom + i ] - A[ c ][ iFrom + i ]
+ *
+ *            A stride of 1 gives the long form row of the axis, a stride of 3 with an offset of the
+ *            axis gives interleaved [ x, y, z ] rows (e.g. for c_closest_point_of_approach) and wider
+ *            strides put many markers side by side (e.g. for c_savitzky_golay_filter).
+ *
+ *  \param    pdAxis      One axis of the matrix, marker after marker, iFrames values each
+ *  \param    iFrames     Frames per marker (row length of the matrix)
+ *  \param    iMarker     Marker id m
+ *  \param    iCenter     Marker id c of the coordinate center, -1 for absolute coordinates
+ *  \param    iFrom       First frame
+ *  \param    iCount      Number of frames
+ *  \param    iStride     Distance of two consecutive frames in pdOut
+ *  \param    iOffset     Position of the first frame in pdOut
+ *  \param    pdOut       Output, at least iOffset + ( iCount - 1 ) * iStride + 1 values
+ *
+ *  \return   Number of frames written (iCount), -1 on invalid arguments
+ */
+int c_frame_matrix_gather( const double *pdAxis, int iFrames, int iMarker, int iCenter, int iFrom, int iCount, int iStride, int iOffset, double *pdOut )
+{
+  int           i         = 0;
+  const double *pdSource  = NULL;
+  const double *pdCenter  = NULL;
+
+  if( ( iFrames < 1 ) || ( iMarker < 0 ) || ( iCenter < -1 ) || ( iFrom < 0 ) || ( iCount < 0 ) || ( ( iFrom + iCount ) > iFrames ) || ( iStride < 1 ) || ( iOffset < 0 ) )
+  {
+    return -1;
+  }
+
+  pdSource = pdAxis + ( ( long ) iMarker * iFrames ) + iFrom;
+
+  if( iCenter < 0 )
+  {
+    for( i = 0; i < iCount; i++ )
+    {
+      pdOut[ iOffset + ( ( long ) i * iStride ) ] = pdSource[ i ];
+    }
+
+    return iCount;
+  }
+
+  pdCenter = pdAxis + ( ( long ) iCenter * iFrames ) + iFrom;
+
+  for( i = 0; i < iCount; i++ )
+  {
+    pdOut[ iOffset + ( ( long ) i * iStride ) ] = pdSource[ i ] - pdCenter[ i ];
+  }
+
+  return iCount;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,353 @@
+/*!
+ *
+ * \file        c_frenet.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Frenet frame (curvature, torsion, T, N, B) of a 3D polyline.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ *  This is a port of matlab/frenetframe.m which was previously called through a MATLAB chroot.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "c_frenet.h"                 ///< Include own header
+
+
+/*! \fn       static void normalize3( double *pdV ) // {{{
+ *  \brief    Scales the vector pdV[0..2] to unit length, zero vectors are left untouched.
+ */
+static void normalize3( double *pdV )
+{
+  double dNorm = sqrt( pdV[0]*pdV[0] + pdV[1]*pdV[1] + pdV[2]*pdV[2] );
+
+  if( dNorm > 0.0 )
+  {
+    pdV[0] /= dNorm;
+    pdV[1] /= dNorm;
+    pdV[2] /= dNorm;
+  }
+} // }}}
+
+
+/*! \fn       static void cross3( const double *pdA, const double *pdB, double *pdR ) // {{{
+ *  \brief    pdR = pdA x pdB
+ */
+static void cross3( const double *pdA, const double *pdB, double *pdR )
+{
+  pdR[0] = pdA[1]*pdB[2] - pdA[2]*pdB[1];
+  pdR[1] = pdA[2]*pdB[0] - pdA[0]*pdB[2];
+  pdR[2] = pdA[0]*pdB[1] - pdA[1]*pdB[0];
+} // }}}
+
+
+/*! \fn       static void tangent( const double *pdX, int iIndex, double *pdT, double *pdDs ) // {{{
+ *  \brief    Unit tangent of the polyline segment iIndex -> iIndex+1 and the segment length.
+ */
+static void tangent( const double *pdX, int iIndex, double *pdT, double *pdDs )
+{
+  const double *pdP = pdX + ( 3 * iIndex );
+
+  pdT[0] = pdP[3] - pdP[0];
+  pdT[1] = pdP[4] - pdP[1];
+  pdT[2] = pdP[5] - pdP[2];
+
+  *pdDs  = sqrt( pdT[0]*pdT[0] + pdT[1]*pdT[1] + pdT[2]*pdT[2] );
+
+  normalize3( pdT );
+} // }}}
+
+
+/*! \fn       static double pchip_end_slope( double dH0, double dH1, double dDelta0, double dDelta1 ) // {{{
+ *  \brief    Shape preserving three-point end slope as used by MATLAB's pchip.
+ */
+static double pchip_end_slope( double dH0, double dH1, double dDelta0, double dDelta1 )
+{
+  double dSlope = ( ( ( 2.0 * dH0 + dH1 ) * dDelta0 ) - ( dH0 * dDelta1 ) ) / ( dH0 + dH1 );
+
+  if( ( dSlope * dDelta0 ) <= 0.0 )
+  {
+    dSlope = 0.0;
+  }
+  else if( ( ( dDelta0 * dDelta1 ) < 0.0 ) && ( fabs( dSlope ) > fabs( 3.0 * dDelta0 ) ) )
+  {
+    dSlope = 3.0 * dDelta0;
+  }
+
+  return dSlope;
+} // }}}
+
+
+/*! \fn       static void interpolate_torsion( double *pdTau, const double *pdKappa, int iRows, double dThreshold, int *piKnown, double *pdSlope ) // {{{
+ *  \brief    The torsion is undefined where kappa < threshold. These entries are replaced by a
+ *            monotone piecewise cubic hermite interpolation (pchip) through the well defined ones,
+ *            entries outside of the well defined range become 0 ( interp1( ..., 'pchip', 0 ) ).
+ *
+ *  \param    piKnown   Scratch buffer of iRows integers
+ *  \param    pdSlope   Scratch buffer of iRows doubles
+ */
+static void interpolate_torsion( double *pdTau, const double *pdKappa, int iRows, double dThreshold, int *piKnown, double *pdSlope )
+{
+  int iKnown = 0;
+  int i      = 0;
+  int k      = 0;
+
+  for( i = 0; i < iRows; i++ )
+  {
+    if( pdKappa[i] >= dThreshold )
+    {
+      piKnown[ iKnown ] = i;
+      iKnown++;
+    }
+  }
+
+  if( iKnown == iRows )
+  {
+    return;
+  }
+
+  if( iKnown < 2 )
+  {
+    for( i = 0; i < iRows; i++ )
+    {
+      if( ( iKnown == 0 ) || ( i != piKnown[0] ) )
+      {
+        pdTau[i] = 0.0;
+      }
+    }
+    return;
+  }
+
+  // Slopes at the known sample points
+  if( iKnown == 2 )
+  {
+    pdSlope[0] = ( pdTau[ piKnown[1] ] - pdTau[ piKnown[0] ] ) / (double) ( piKnown[1] - piKnown[0] );
+    pdSlope[1] = pdSlope[0];
+  }
+  else
+  {
+    for( k = 1; k < ( iKnown - 1 ); k++ )
+    {
+      double dH0     = (double) ( piKnown[k]   - piKnown[k-1] );
+      double dH1     = (double) ( piKnown[k+1] - piKnown[k]   );
+      double dDelta0 = ( pdTau[ piKnown[k]   ] - pdTau[ piKnown[k-1] ] ) / dH0;
+      double dDelta1 = ( pdTau[ piKnown[k+1] ] - pdTau[ piKnown[k]   ] ) / dH1;
+
+      if( ( dDelta0 * dDelta1 ) <= 0.0 )
+      {
+        pdSlope[k] = 0.0;
+      }
+      else
+      {
+        double dW0 = ( 2.0 * dH1 ) + dH0;
+        double dW1 = dH1 + ( 2.0 * dH0 );
+
+        pdSlope[k] = ( dW0 + dW1 ) / ( ( dW0 / dDelta0 ) + ( dW1 / dDelta1 ) );
+      }
+    }
+
+    {
+      double dH0     = (double) ( piKnown[1] - piKnown[0] );
+      double dH1     = (double) ( piKnown[2] - piKnown[1] );
+      double dDelta0 = ( pdTau[ piKnown[1] ] - pdTau[ piKnown[0] ] ) / dH0;
+      double dDelta1 = ( pdTau[ piKnown[2] ] - pdTau[ piKnown[1] ] ) / dH1;
+
+      pdSlope[0]     = pchip_end_slope( dH0, dH1, dDelta0, dDelta1 );
+    }
+
+    {
+      int    n       = iKnown - 1;
+      double dH0     = (double) ( piKnown[n]   - piKnown[n-1] );
+      double dH1     = (double) ( piKnown[n-1] - piKnown[n-2] );
+      double dDelta0 = ( pdTau[ piKnown[n]   ] - pdTau[ piKnown[n-1] ] ) / dH0;
+      double dDelta1 = ( pdTau[ piKnown[n-1] ] - pdTau[ piKnown[n-2] ] ) / dH1;
+
+      pdSlope[n]     = pchip_end_slope( dH0, dH1, dDelta0, dDelta1 );
+    }
+  }
+
+  // Extrapolation value is 0
+  for( i = 0; i < piKnown[0]; i++ )
+  {
+    pdTau[i] = 0.0;
+  }
+
+  for( i = piKnown[ iKnown - 1 ] + 1; i < iRows; i++ )
+  {
+    pdTau[i] = 0.0;
+  }
+
+  // Fill the gaps between two consecutive known points with the hermite cubic
+  for( k = 0; k < ( iKnown - 1 ); k++ )
+  {
+    int    iLeft  = piKnown[k];
+    int    iRight = piKnown[k+1];
+    double dH     = (double) ( iRight - iLeft );
+    double dY0    = pdTau[ iLeft  ];
+    double dY1    = pdTau[ iRight ];
+
+    for( i = iLeft + 1; i < iRight; i++ )
+    {
+      double dT   = (double) ( i - iLeft ) / dH;
+      double dT2  = dT * dT;
+      double dT3  = dT2 * dT;
+
+      pdTau[i]    = ( ( 2.0*dT3 - 3.0*dT2 + 1.0 ) * dY0 )
+                  + ( ( dT3 - 2.0*dT2 + dT ) * dH * pdSlope[k] )
+                  + ( ( -2.0*dT3 + 3.0*dT2 ) * dY1 )
+                  + ( ( dT3 - dT2 ) * dH * pdSlope[k+1] );
+    }
+  }
+} // }}}
+
+
+/*! \fn       int c_frenet_frame( const double *pdX, int iPoints, double dThreshold, double *pdKappa, double *pdTau, double *pdT, double *pdN, double *pdB, double *pdS, double *pdDs ) // {{{
+ *  \brief    Computes the Frenet frame of the polyline pdX in one pass (finite difference based).
+ *
+ *  \param    pdX         Polyline of iPoints rows, interleaved [ x0, y0, z0, x1, y1, z1, ... ]
+ *  \param    iPoints     Number of points n of the polyline (n >= 4)
+ *  \param    dThreshold  Torsion is interpolated for all frames where kappa < dThreshold
+ *  \param    pdKappa     Output, n-3 values, (unsigned) curvature
+ *  \param    pdTau       Output, n-3 values, torsion
+ *  \param    pdT         Output, n-3 rows of 3, unit tangent
+ *  \param    pdN         Output, n-3 rows of 3, unit normal
+ *  \param    pdB         Output, n-3 rows of 3, unit binormal
+ *  \param    pdS         Output, n-1 values, cumulative arc length
+ *  \param    pdDs        Output, n-1 values, segment lengths
+ *
+ *  \return   Number of frame rows (n-3) written, -1 if there are too few points or we run out of memory
+ *
+ *  \note     The polyline should be filtered for consecutive identical points beforehand.
+ */
+int c_frenet_frame( const double *pdX, int iPoints, double dThreshold, double *pdKappa, double *pdTau, double *pdT, double *pdN, double *pdB, double *pdS, double *pdDs )
+{
+  int     iRows       = iPoints - 3;
+  int     i           = 0;
+  int    *piKnown     = NULL;
+  double *pdSlope     = NULL;
+
+  double  adT0[3], adT1[3];           // T_i and T_{i+1}
+  double  adN[3],  adB[3];            // N_i and B_i
+  double  adNprev[3], adBprev[3];     // N_{i-1} and B_{i-1}
+  double  dDs0 = 0.0, dDs1 = 0.0, dDsPrev = 0.0;
+  double  dSum = 0.0;
+
+  if( iRows < 1 )
+  {
+    return -1;
+  }
+
+  piKnown = (int *)    malloc( sizeof( int )    * (size_t) iRows );
+  pdSlope = (double *) malloc( sizeof( double ) * (size_t) iRows );
+
+  if( ( piKnown == NULL ) || ( pdSlope == NULL ) )
+  {
+    free( piKnown );
+    free( pdSlope );
+    return -1;
+  }
+
+  tangent( pdX, 0, adT0, &dDs0 );
+  dSum    = dDs0;
+  pdDs[0] = dDs0;
+  pdS[0]  = dSum;
+
+  // Frame i needs T_i, T_{i+1} for N_i and B_{i-1}, N_{i-1} for the torsion of frame i-1
+  for( i = 0; i <= iRows; i++ )
+  {
+    double dK = 0.0;
+
+    tangent( pdX, i + 1, adT1, &dDs1 );
+    dSum          += dDs1;
+    pdDs[ i + 1 ]  = dDs1;
+    pdS[ i + 1 ]   = dSum;
+
+    // N // dT
+    adN[0] = adT1[0] - adT0[0];
+    adN[1] = adT1[1] - adT0[1];
+    adN[2] = adT1[2] - adT0[2];
+    dK     = sqrt( adN[0]*adN[0] + adN[1]*adN[1] + adN[2]*adN[2] );
+    normalize3( adN );
+
+    // B = T x N ; renormalise the frame N = B x T
+    cross3( adT0, adN, adB );
+    normalize3( adB );
+    cross3( adB, adT0, adN );
+
+    if( i > 0 )
+    {
+      // dB/ds, perpendicular to B ; tau = -dB/ds * N
+      double adDb[3];
+      double dCorr = 0.0;
+
+      adDb[0] = ( adB[0] - adBprev[0] );
+      adDb[1] = ( adB[1] - adBprev[1] );
+      adDb[2] = ( adB[2] - adBprev[2] );
+
+      if( dDsPrev > 0.0 )
+      {
+        adDb[0] /= dDsPrev;
+        adDb[1] /= dDsPrev;
+        adDb[2] /= dDsPrev;
+      }
+
+      dCorr   = adDb[0]*adBprev[0] + adDb[1]*adBprev[1] + adDb[2]*adBprev[2];
+      adDb[0] = adDb[0] - ( dCorr * adBprev[0] );
+      adDb[1] = adDb[1] - ( dCorr * adBprev[1] );
+      adDb[2] = adDb[2] - ( dCorr * adBprev[2] );
+
+      pdTau[ i - 1 ] = -( adDb[0]*adNprev[0] + adDb[1]*adNprev[1] + adDb[2]*adNprev[2] );
+    }
+
+    if( i < iRows )
+    {
+      pdKappa[i]          = ( dDs0 > 0.0 ) ? ( dK / dDs0 ) : ( 0.0 );
+
+      pdT[ 3*i ]          = adT0[0];
+      pdT[ 3*i + 1 ]      = adT0[1];
+      pdT[ 3*i + 2 ]      = adT0[2];
+
+      pdN[ 3*i ]          = adN[0];
+      pdN[ 3*i + 1 ]      = adN[1];
+      pdN[ 3*i + 2 ]      = adN[2];
+
+      pdB[ 3*i ]          = adB[0];
+      pdB[ 3*i + 1 ]      = adB[1];
+      pdB[ 3*i + 2 ]      = adB[2];
+    }
+
+    adNprev[0] = adN[0];  adNprev[1] = adN[1];  adNprev[2] = adN[2];
+    adBprev[0] = adB[0];  adBprev[1] = adB[1];  adBprev[2] = adB[2];
+    adT0[0]    = adT1[0]; adT0[1]    = adT1[1]; adT0[2]    = adT1[2];
+    dDsPrev    = dDs0;
+    dDs0       = dDs1;
+  }
+
+  interpolate_torsion( pdTau, pdKappa, iRows, dThreshold, piKnown, pdSlope );
+
+  free( piKnown );
+  free( pdSlope );
+
+  return iRows;
+} // }}}
+
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,457 @@
+/*!
+ *
+ * \file        c_kdtree.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       KD-tree over a point corpus (flat buffer), batched k nearest and radius queries.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "c_kdtree.h"                 ///< Include own header
+
+
+/*! \struct   kdtree_view
+ *  \brief    Pointers into a tree buffer (see C_KDTREE_SIZE)
+ */
+typedef struct
+{
+  int           iPoints;
+  int           iDimensions;
+  const double *pdPoints;             ///< points in tree order, row major
+  const double *pdIndex;              ///< original index of every point in tree order
+  const double *pdSplit;              ///< split dimension of the node in the middle of a range
+} kdtree_view;
+
+
+/*! \struct   kdtree_best
+ *  \brief    The best iK candidates of one query so far, sorted by ( distance, index )
+ */
+typedef struct
+{
+  int     iK;
+  int     iCount;
+  double  dBound;                     ///< squared radius, candidates further away are never taken
+  double *pdD2;
+  double *pdIndex;
+} kdtree_best;
+
+
+/*! \fn       static kdtree_view view( const double *pdTree ) // {{{
+ *  \brief    Splits a tree buffer into its parts
+ */
+static kdtree_view view( const double *pdTree )
+{
+  kdtree_view tView;
+
+  tView.iPoints     = ( int ) pdTree[0];
+  tView.iDimensions = ( int ) pdTree[1];
+  tView.pdPoints    = pdTree + 2;
+  tView.pdIndex     = tView.pdPoints + ( ( long ) tView.iPoints * tView.iDimensions );
+  tView.pdSplit     = tView.pdIndex + tView.iPoints;
+
+  return tView;
+} // }}}
+
+
+/*! \fn       static void select_median( const double *pdData, int iDimensions, int iDimension, int *piIndex, int iLow, int iHigh, int iNth ) // {{{
+ *  \brief    Reorders piIndex[ iLow, iHigh ) so that piIndex[ iNth ] holds the point that would be
+ *            there if the range was sorted by coordinate iDimension, with no larger ones before
+ *            and no smaller ones after it (quickselect, median of three pivot).
+ */
+static void select_median( const double *pdData, int iDimensions, int iDimension, int *piIndex, int iLow, int iHigh, int iNth )
+{
+  int iLeft  = iLow;
+  int iRight = iHigh - 1;
+
+  while( iLeft < iRight )
+  {
+    int    iMid    = iLeft + ( iRight - iLeft ) / 2;
+    double dA      = pdData[ ( long ) piIndex[ iLeft ]  * iDimensions + iDimension ];
+    double dB      = pdData[ ( long ) piIndex[ iMid ]   * iDimensions + iDimension ];
+    double dC      = pdData[ ( long ) piIndex[ iRight ] * iDimensions + iDimension ];
+    double dPivot  = ( dA < dB ) ? ( ( dB < dC ) ? ( dB ) : ( ( dA < dC ) ? ( dC ) : ( dA ) ) ) : ( ( dA < dC ) ? ( dA ) : ( ( dB < dC ) ? ( dC ) : ( dB ) ) );
+    int    i       = iLeft;
+    int    j       = iRight;
+
+    while( i <= j )
+    {
+      while( pdData[ ( long ) piIndex[i] * iDimensions + iDimension ] < dPivot )
+      {
+        i++;
+      }
+
+      while( pdData[ ( long ) piIndex[j] * iDimensions + iDimension ] > dPivot )
+      {
+        j--;
+      }
+
+      if( i <= j )
+      {
+        int iSwap    = piIndex[i];
+
+        piIndex[i]   = piIndex[j];
+        piIndex[j]   = iSwap;
+        i++;
+        j--;
+      }
+    }
+
+    if( iNth <= j )
+    {
+      iRight = j;
+    }
+    else if( iNth >= i )
+    {
+      iLeft  = i;
+    }
+    else
+    {
+      break;
+    }
+  }
+} // }}}
+
+
+/*! \fn       static void build( const double *pdData, int iDimensions, int *piIndex, double *pdSplit, int iLow, int iHigh ) // {{{
+ *  \brief    Splits [ iLow, iHigh ) at its median along the dimension of the largest spread, the
+ *            median point is the node, both halves are split recursively (depth log2( n ))
+ */
+static void build( const double *pdData, int iDimensions, int *piIndex, double *pdSplit, int iLow, int iHigh )
+{
+  int    i         = 0;
+  int    c         = 0;
+  int    iMid      = iLow + ( iHigh - iLow ) / 2;
+  int    iBest     = 0;
+  double dSpread   = -1.0;
+
+  if( ( iHigh - iLow ) <= C_KDTREE_LEAF )
+  {
+    return;
+  }
+
+  for( c = 0; c < iDimensions; c++ )
+  {
+    double dMin = HUGE_VAL;
+    double dMax = -HUGE_VAL;
+
+    for( i = iLow; i < iHigh; i++ )
+    {
+      double dV = pdData[ ( long ) piIndex[i] * iDimensions + c ];
+
+      dMin = ( dV < dMin ) ? ( dV ) : ( dMin );
+      dMax = ( dV > dMax ) ? ( dV ) : ( dMax );
+    }
+
+    if( ( dMax - dMin ) > dSpread )
+    {
+      dSpread = dMax - dMin;
+      iBest   = c;
+    }
+  }
+
+  select_median( pdData, iDimensions, iBest, piIndex, iLow, iHigh, iMid );
+  pdSplit[ iMid ] = ( double ) iBest;
+
+  build( pdData, iDimensions, piIndex, pdSplit, iLow, iMid );
+  build( pdData, iDimensions, piIndex, pdSplit, iMid + 1, iHigh );
+} // }}}
+
+
+/*! \fn       static void offer( kdtree_best *ptBest, double dD2, double dIndex ) // {{{
+ *  \brief    Inserts a candidate if it is within the bound and better than the worst one kept
+ *            (ties are broken by the lower index, so the result does not depend on the tree shape)
+ */
+static void offer( kdtree_best *ptBest, double dD2, double dIndex )
+{
+  int i = 0;
+
+  if( dD2 > ptBest->dBound )
+  {
+    return;
+  }
+
+  if( ptBest->iCount == ptBest->iK )
+  {
+    double dWorst = ptBest->pdD2[ ptBest->iK - 1 ];
+
+    if( ( dD2 > dWorst ) || ( ( dD2 == dWorst ) && ( dIndex > ptBest->pdIndex[ ptBest->iK - 1 ] ) ) )
+    {
+      return;
+    }
+
+    ptBest->iCount--;
+  }
+
+  for( i = ptBest->iCount; ( i > 0 ) && ( ( ptBest->pdD2[ i - 1 ] > dD2 ) || ( ( ptBest->pdD2[ i - 1 ] == dD2 ) && ( ptBest->pdIndex[ i - 1 ] > dIndex ) ) ); i-- )
+  {
+    ptBest->pdD2[i]    = ptBest->pdD2[ i - 1 ];
+    ptBest->pdIndex[i] = ptBest->pdIndex[ i - 1 ];
+  }
+
+  ptBest->pdD2[i]    = dD2;
+  ptBest->pdIndex[i] = dIndex;
+  ptBest->iCount++;
+} // }}}
+
+
+/*! \fn       static void search( const kdtree_view *ptTree, const double *pdQuery, int iLow, int iHigh, kdtree_best *ptBest ) // {{{
+ *  \brief    Visits the half containing the query first, the other half only if the splitting
+ *            plane is not further away than the worst candidate kept (or the bound)
+ */
+static void search( const kdtree_view *ptTree, const double *pdQuery, int iLow, int iHigh, kdtree_best *ptBest )
+{
+  int    i       = 0;
+  int    c       = 0;
+  int    iD      = ptTree->iDimensions;
+  int    iMid    = iLow + ( iHigh - iLow ) / 2;
+  int    iSplit  = 0;
+  double dPlane  = 0.0;
+  double dWorst  = 0.0;
+
+  if( ( iHigh - iLow ) <= C_KDTREE_LEAF )
+  {
+    for( i = iLow; i < iHigh; i++ )
+    {
+      const double *pdP = ptTree->pdPoints + ( ( long ) i * iD );
+      double        dD2 = 0.0;
+
+      for( c = 0; c < iD; c++ )
+      {
+        dD2 += ( pdQuery[c] - pdP[c] ) * ( pdQuery[c] - pdP[c] );
+      }
+
+      offer( ptBest, dD2, ptTree->pdIndex[i] );
+    }
+
+    return;
+  }
+
+  iSplit = ( int ) ptTree->pdSplit[ iMid ];
+  dPlane = pdQuery[ iSplit ] - ptTree->pdPoints[ ( long ) iMid * iD + iSplit ];
+
+  if( dPlane < 0.0 )
+  {
+    search( ptTree, pdQuery, iLow, iMid, ptBest );
+  }
+  else
+  {
+    search( ptTree, pdQuery, iMid + 1, iHigh, ptBest );
+  }
+
+  search( ptTree, pdQuery, iMid, iMid + 1, ptBest );
+
+  dWorst = ( ptBest->iCount == ptBest->iK ) ? ( ptBest->pdD2[ ptBest->iK - 1 ] ) : ( ptBest->dBound );
+
+  if( ( dPlane * dPlane ) <= dWorst )
+  {
+    if( dPlane < 0.0 )
+    {
+      search( ptTree, pdQuery, iMid + 1, iHigh, ptBest );
+    }
+    else
+    {
+      search( ptTree, pdQuery, iLow, iMid, ptBest );
+    }
+  }
+} // }}}
+
+
+/*! \fn       static int query( const double *pdTree, const double *pdQueries, int iQueries, int iK, double dBound, double *pdCounts, double *pdIndices, double *pdDistances ) // {{{
+ *  \brief    Runs the bounded k best search for every query, rows of iK results (unused slots -1)
+ *
+ *  \return   Number of queries, -1 on invalid arguments
+ */
+static int query( const double *pdTree, const double *pdQueries, int iQueries, int iK, double dBound, double *pdCounts, double *pdIndices, double *pdDistances )
+{
+  int          q      = 0;
+  int          i      = 0;
+  kdtree_view  tTree;
+  kdtree_best  tBest;
+
+  if( ( pdTree == NULL ) || ( pdQueries == NULL ) || ( pdIndices == NULL ) || ( pdDistances == NULL ) || ( iQueries < 0 ) || ( iK < 1 ) )
+  {
+    return -1;
+  }
+
+  tTree = view( pdTree );
+
+  if( ( tTree.iPoints < 1 ) || ( tTree.iDimensions < 1 ) )
+  {
+    return -1;
+  }
+
+  for( q = 0; q < iQueries; q++ )
+  {
+    double *pdI   = pdIndices   + ( ( long ) q * iK );
+    double *pdD   = pdDistances + ( ( long ) q * iK );
+
+    // the rows of the output double as candidate lists, the distances are squared until the end
+    tBest.iK      = iK;
+    tBest.iCount  = 0;
+    tBest.dBound  = dBound;
+    tBest.pdD2    = pdD;
+    tBest.pdIndex = pdI;
+
+    search( &tTree, pdQueries + ( ( long ) q * tTree.iDimensions ), 0, tTree.iPoints, &tBest );
+
+    for( i = 0; i < iK; i++ )
+    {
+      pdD[i] = ( i < tBest.iCount ) ? ( sqrt( pdD[i] ) ) : ( -1.0 );
+      pdI[i] = ( i < tBest.iCount ) ? ( pdI[i] ) : ( -1.0 );
+    }
+
+    if( pdCounts != NULL )
+    {
+      pdCounts[q] = ( double ) tBest.iCount;
+    }
+  }
+
+  return iQueries;
+} // }}}
+
+
+/*! \fn       int c_kdtree_size( int iPoints, int iDimensions ) // {{{
+ *  \brief    Number of doubles the tree over iPoints points of iDimensions dimensions needs.
+ */
+int c_kdtree_size( int iPoints, int iDimensions )
+{
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) )
+  {
+    return -1;
+  }
+
+  return C_KDTREE_SIZE( iPoints, iDimensions );
+} // }}}
+
+
+/*! \fn       int c_kdtree_build( const double *pdData, int iPoints, int iDimensions, double *pdTree ) // {{{
+ *  \brief    Builds a balanced KD-tree over a point corpus, once. The tree is implicit: every range
+ *            of the (reordered) points has its node in the middle, split along the dimension of the
+ *            largest spread, the halves left and right of it are the subtrees. Besides the split
+ *            dimensions nothing else has to be stored, and the whole tree is one flat buffer which
+ *            can be kept (or marshalled) as a packed String. The points are copied in tree order,
+ *            so a leaf is contiguous in memory.
+ *
+ *  \param    pdData        Points, iPoints x iDimensions, row major
+ *  \param    iPoints       Number of points n
+ *  \param    iDimensions   Dimensions d of every point
+ *  \param    pdTree        Output, c_kdtree_size( n, d ) values
+ *
+ *  \return   n, -1 on invalid arguments or if memory could not be allocated
+ */
+int c_kdtree_build( const double *pdData, int iPoints, int iDimensions, double *pdTree )
+{
+  int     i        = 0;
+  int     c        = 0;
+  int    *piIndex  = NULL;
+  double *pdPoints = NULL;
+  double *pdIndex  = NULL;
+  double *pdSplit  = NULL;
+
+  if( ( pdData == NULL ) || ( pdTree == NULL ) || ( c_kdtree_size( iPoints, iDimensions ) < 0 ) )
+  {
+    return -1;
+  }
+
+  piIndex  = ( int * ) malloc( sizeof( int ) * iPoints );
+
+  if( piIndex == NULL )
+  {
+    return -1;
+  }
+
+  pdTree[0] = ( double ) iPoints;
+  pdTree[1] = ( double ) iDimensions;
+  pdPoints  = pdTree + 2;
+  pdIndex   = pdPoints + ( ( long ) iPoints * iDimensions );
+  pdSplit   = pdIndex + iPoints;
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    piIndex[i] = i;
+    pdSplit[i] = -1.0;
+  }
+
+  build( pdData, iDimensions, piIndex, pdSplit, 0, iPoints );
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    for( c = 0; c < iDimensions; c++ )
+    {
+      pdPoints[ ( long ) i * iDimensions + c ] = pdData[ ( long ) piIndex[i] * iDimensions + c ];
+    }
+
+    pdIndex[i] = ( double ) piIndex[i];
+  }
+
+  free( piIndex );
+
+  return iPoints;
+} // }}}
+
+
+/*! \fn       int c_kdtree_nearest( const double *pdTree, const double *pdQueries, int iQueries, int iK, double *pdIndices, double *pdDistances ) // {{{
+ *  \brief    The iK nearest points of every query, closest first (equal distances by index). A
+ *            query costs O( log n ) for well spread low dimensional data instead of O( n ).
+ *
+ *  \param    pdTree        Tree from c_kdtree_build
+ *  \param    pdQueries     Query points, iQueries x d, row major
+ *  \param    iQueries      Number of queries
+ *  \param    iK            Neighbours per query (rows are filled with -1 if the tree has less points)
+ *  \param    pdIndices     Output, iQueries x iK point indices
+ *  \param    pdDistances   Output, iQueries x iK distances
+ *
+ *  \return   Number of queries, -1 on invalid arguments
+ */
+int c_kdtree_nearest( const double *pdTree, const double *pdQueries, int iQueries, int iK, double *pdIndices, double *pdDistances )
+{
+  return query( pdTree, pdQueries, iQueries, iK, HUGE_VAL, NULL, pdIndices, pdDistances );
+} // }}}
+
+
+/*! \fn       int c_kdtree_radius( const double *pdTree, const double *pdQueries, int iQueries, double dRadius, int iMax, double *pdCounts, double *pdIndices, double *pdDistances ) // {{{
+ *  \brief    The points within dRadius of every query, closest first, at most iMax per query (the
+ *            iMax closest ones if there are more, check pdCounts[q] == iMax and ask again with a
+ *            larger iMax if all of them are needed).
+ *
+ *  \param    pdTree        Tree from c_kdtree_build
+ *  \param    pdQueries     Query points, iQueries x d, row major
+ *  \param    iQueries      Number of queries
+ *  \param    dRadius       Search radius (inclusive)
+ *  \param    iMax          Maximum number of points per query
+ *  \param    pdCounts      Output, number of points found for every query
+ *  \param    pdIndices     Output, iQueries x iMax point indices (unused slots -1)
+ *  \param    pdDistances   Output, iQueries x iMax distances (unused slots -1)
+ *
+ *  \return   Number of queries, -1 on invalid arguments
+ */
+int c_kdtree_radius( const double *pdTree, const double *pdQueries, int iQueries, double dRadius, int iMax, double *pdCounts, double *pdIndices, double *pdDistances )
+{
+  if( ( dRadius < 0.0 ) || ( pdCounts == NULL ) )
+  {
+    return -1;
+  }
+
+  return query( pdTree, pdQueries, iQueries, iMax, dRadius * dRadius, pdCounts, pdIndices, pdDistances );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,45 @@
+/*!
+ *
+ * \file        c_kdtree.h
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       KD-tree over a point corpus (flat buffer), batched k nearest and radius queries.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#ifndef _C_KDTREE_H_
+#  define _C_KDTREE_H_
+
+
+///! Ranges of at most this many points are not split further but scanned
+#  define C_KDTREE_LEAF 8
+
+///! Tree layout (doubles): [ n, d, points( n x d, tree order ), index( n ), split dimension( n ) ]
+#  define C_KDTREE_SIZE( iPoints, iDimensions ) ( 2 + ( ( iPoints ) * ( iDimensions ) ) + ( 2 * ( iPoints ) ) )
+
+///! Prototypes
+int c_kdtree_size( int /* iPoints */, int /* iDimensions */ );
+int c_kdtree_build( const double * /* pdData */, int /* iPoints */, int /* iDimensions */, double * /* pdTree */ );
+int c_kdtree_nearest( const double * /* pdTree */, const double * /* pdQueries */, int /* iQueries */, int /* iK */, double * /* pdIndices */, double * /* pdDistances */ );
+int c_kdtree_radius( const double * /* pdTree */, const double * /* pdQueries */, int /* iQueries */, double /* dRadius */, int /* iMax */, double * /* pdCounts */, double * /* pdIndices */, double * /* pdDistances */ );
+
+#endif
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,117 @@
+/*!
+ *
+ * \file        c_kinematics.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Fused kinematics (velocity, acceleration, power, kinetic energy and derivatives) in one pass.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stdlib.h>
+#include "c_path_length.h"
+#include "c_spline.h"
+#include "c_kinematics.h"             ///< Include own header
+
+
+/*! \fn       int c_kinematics( const double *pdPrefix, int iPoints, int iWindow, double dInterval, double dMass, double *pdOut ) // {{{
+ *  \brief    Computes all kinematic quantities of Physics from one windowed path length pass
+ *
+ *              v     = D / ( dt * w )            D: path length of the window ( c_path_length_window )
+ *              a     = v / ( dt * w )
+ *              P     = m * a * v
+ *              E_kin = 0.5 * m * v^2
+ *
+ *            for frames 0..n-2, followed by the first and second derivatives (over frames) of
+ *            each of them, taken analytically from a natural cubic spline ( c_spline_derivatives ).
+ *
+ *  \param    pdPrefix    Cumulative arc length of the trajectory ( c_path_length_index ), iPoints values
+ *  \param    iPoints     Number of frames n of the trajectory
+ *  \param    iWindow     Frames before and after each frame of the distance window ( w )
+ *  \param    dInterval   Capture interval of the motion capture equipment in seconds ( dt )
+ *  \param    dMass       Mass of the body components involved ( m )
+ *  \param    pdOut       Output, C_KINEMATICS_COLUMNS columns of n - 1 values each, one column after
+ *                        the other: v, a, P, E, v', a', P', E', v'', a'', P'', E''
+ *
+ *  \return   Number of rows ( n - 1 ), -1 on invalid arguments
+ */
+int c_kinematics( const double *pdPrefix, int iPoints, int iWindow, double dInterval, double dMass, double *pdOut )
+{
+  int     i           = 0;
+  int     iRows       = iPoints - 1;
+  int     iWritten    = 0;
+  double  dScale      = 0.0;
+  double *pdDistances = NULL;
+  double *pdFrames    = NULL;
+  double *pdThird     = NULL;
+  double *pdV         = pdOut;
+  double *pdA         = pdOut + ( 1 * ( long ) iRows );
+  double *pdP         = pdOut + ( 2 * ( long ) iRows );
+  double *pdE         = pdOut + ( 3 * ( long ) iRows );
+
+  if( ( iPoints < 2 ) || ( iWindow < 1 ) || ( !( dInterval > 0.0 ) ) )
+  {
+    return -1;
+  }
+
+  pdDistances = ( double * ) malloc( sizeof( double ) * iPoints );
+  pdFrames    = ( double * ) malloc( sizeof( double ) * iRows );
+  pdThird     = ( double * ) malloc( sizeof( double ) * 4 * iRows );
+
+  if( ( pdDistances == NULL ) || ( pdFrames == NULL ) || ( pdThird == NULL ) )
+  {
+    free( pdDistances );
+    free( pdFrames );
+    free( pdThird );
+    return -1;
+  }
+
+  if( c_path_length_window( pdPrefix, iPoints, iWindow, pdDistances ) != iPoints )
+  {
+    free( pdDistances );
+    free( pdFrames );
+    free( pdThird );
+    return -1;
+  }
+
+  dScale = 1.0 / ( dInterval * ( double ) iWindow );
+
+  for( i = 0; i < iRows; i++ )
+  {
+    double dV   = pdDistances[i] * dScale;
+    double dA   = dV * dScale;
+
+    pdV[i]      = dV;
+    pdA[i]      = dA;
+    pdP[i]      = dMass * dA * dV;
+    pdE[i]      = 0.5 * dMass * dV * dV;
+    pdFrames[i] = ( double ) i;
+  }
+
+  // the four signals share the frame axis, one spline factorization for all of them
+  iWritten = c_spline_derivatives( pdFrames, iRows, pdOut, 4, pdOut + ( 4 * ( long ) iRows ), pdOut + ( 8 * ( long ) iRows ), pdThird );
+
+  free( pdDistances );
+  free( pdFrames );
+  free( pdThird );
+
+  return ( iWritten == ( 4 * iRows ) ) ? ( iRows ) : ( -1 );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,467 @@
+/*!
+ *
+ * \file        c_kmeans.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Lloyd k-means with triangle inequality bounds (Hamerly for low, Elkan for high dimensions).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_kmeans.h"                 ///< Include own header
+
+
+/*! \fn       static double distance( const double *pdA, const double *pdB, int iDimensions ) // {{{
+ *  \brief    Euclidean distance of two iDimensions points
+ */
+static double distance( const double *pdA, const double *pdB, int iDimensions )
+{
+  int    i    = 0;
+  double dSum = 0.0;
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    double dDelta = pdA[i] - pdB[i];
+    dSum         += dDelta * dDelta;
+  }
+
+  return sqrt( dSum );
+} // }}}
+
+
+/*! \fn       static void centroid_distances( const double *pdCentroids, int iK, int iDimensions, double *pdCC, double *pdS ) // {{{
+ *  \brief    Distance matrix of the centroids (k x k) and s_j = 0.5 * min_{j' != j} d( c_j, c_j' )
+ */
+static void centroid_distances( const double *pdCentroids, int iK, int iDimensions, double *pdCC, double *pdS )
+{
+  int i = 0;
+  int j = 0;
+
+  for( i = 0; i < iK; i++ )
+  {
+    pdCC[ i * iK + i ] = 0.0;
+    pdS[i]             = HUGE_VAL;
+  }
+
+  for( i = 0; i < iK; i++ )
+  {
+    for( j = i + 1; j < iK; j++ )
+    {
+      double dD = distance( pdCentroids + ( i * iDimensions ), pdCentroids + ( j * iDimensions ), iDimensions );
+
+      pdCC[ i * iK + j ] = dD;
+      pdCC[ j * iK + i ] = dD;
+
+      if( ( 0.5 * dD ) < pdS[i] )
+      {
+        pdS[i] = 0.5 * dD;
+      }
+
+      if( ( 0.5 * dD ) < pdS[j] )
+      {
+        pdS[j] = 0.5 * dD;
+      }
+    }
+  }
+} // }}}
+
+
+/*! \fn       static double move_centroids( const double *pdData, int iPoints, int iDimensions, int iK, const int *piLabels, double *pdCentroids, double *pdSums, long *plCounts, double *pdMoved ) // {{{
+ *  \brief    Lloyd update step, every centroid becomes the mean of its points (empty clusters stay
+ *            where they are). pdMoved gets the distance each centroid moved.
+ *
+ *  \return   \sum_j |S_j|^2 / n_j of the cluster sums S_j, the sum of squared distances of all points to
+ *            their (new) centroid is \sum_i |x_i|^2 minus this value
+ */
+static double move_centroids( const double *pdData, int iPoints, int iDimensions, int iK, const int *piLabels, double *pdCentroids, double *pdSums, long *plCounts, double *pdMoved )
+{
+  int    i          = 0;
+  int    j          = 0;
+  int    c          = 0;
+  double dExplained = 0.0;
+
+  memset( pdSums, 0, sizeof( double ) * iK * iDimensions );
+  memset( plCounts, 0, sizeof( long ) * iK );
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    double       *pdSum = pdSums + ( piLabels[i] * iDimensions );
+    const double *pdX   = pdData + ( ( long ) i * iDimensions );
+
+    for( c = 0; c < iDimensions; c++ )
+    {
+      pdSum[c] += pdX[c];
+    }
+
+    plCounts[ piLabels[i] ]++;
+  }
+
+  for( j = 0; j < iK; j++ )
+  {
+    double *pdC   = pdCentroids + ( j * iDimensions );
+    double  dMove = 0.0;
+
+    if( plCounts[j] > 0 )
+    {
+      for( c = 0; c < iDimensions; c++ )
+      {
+        double dNew   = pdSums[ j * iDimensions + c ] / ( double ) plCounts[j];
+        double dDelta = dNew - pdC[c];
+
+        dMove        += dDelta * dDelta;
+        dExplained   += pdSums[ j * iDimensions + c ] * dNew;
+        pdC[c]        = dNew;
+      }
+    }
+
+    pdMoved[j] = sqrt( dMove );
+  }
+
+  return dExplained;
+} // }}}
+
+
+/*! \fn       int c_kmeans_bounded( const double *pdData, int iPoints, int iDimensions, int iK, int iMaxIterations, double dAbandon, double *pdCentroids, double *pdLabels, double *pdDistances, double *pdDistortion ) // {{{
+ *  \brief    Lloyd k-means which skips most point to centroid distances via triangle inequality
+ *            bounds. Every point keeps an upper bound u on the distance to its own centroid and
+ *
+ *              - Hamerly ( d < C_KMEANS_ELKAN_DIMENSIONS ): one lower bound l on the distance to
+ *                the second closest centroid. Nothing to do while u <= max( l, s_a ).
+ *              - Elkan: one lower bound per centroid (n x k), a centroid j is skipped while
+ *                u <= l_j or u <= 0.5 * d( c_a, c_j ).
+ *
+ *            After each update the bounds are loosened by the distance the centroids moved. The
+ *            result is the same as a plain Lloyd iteration from the same start.
+ *
+ *            The distortion (sum of squared distances) never increases from one iteration to the
+ *            next. A run is abandoned once it is above dAbandon and, at the rate of its last
+ *            improvement, would not get below it in the remaining iterations (used by restarts
+ *            which only need to beat the best run so far). This is a heuristic, Lloyd iterations
+ *            do not improve linearly and no lower bound of the final distortion is known here,
+ *            so an abandoned run could still have ended below dAbandon.
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    iK              Number of clusters k
+ *  \param    iMaxIterations  Maximum number of Lloyd iterations
+ *  \param    dAbandon        Distortion the run has to beat, HUGE_VAL (or any negative value) to never abandon
+ *  \param    pdCentroids     Start centroids (k x d) in, final centroids out
+ *  \param    pdLabels        Output, cluster index of every point ( n values ), may be NULL
+ *  \param    pdDistances     Output, distance of every point to its centroid ( n values ), may be NULL
+ *  \param    pdDistortion    Output, sum of squared distances ( 1 value ), HUGE_VAL if the run was abandoned
+ *
+ *  \return   Number of iterations until the assignment did not change anymore, -1 on invalid arguments
+ */
+int c_kmeans_bounded( const double *pdData, int iPoints, int iDimensions, int iK, int iMaxIterations, double dAbandon, double *pdCentroids, double *pdLabels, double *pdDistances, double *pdDistortion )
+{
+  int     i           = 0;
+  int     j           = 0;
+  int     iIteration  = 0;
+  int     iElkan      = ( iDimensions >= C_KMEANS_ELKAN_DIMENSIONS );
+  int     iAbandoned  = 0;
+  double  dTotal      = 0.0;
+  double  dPrevious   = HUGE_VAL;
+  int    *piLabels    = NULL;
+  long   *plCounts    = NULL;
+  double *pdUpper     = NULL;
+  double *pdLower     = NULL;
+  double *pdCC        = NULL;
+  double *pdS         = NULL;
+  double *pdMoved     = NULL;
+  double *pdSums      = NULL;
+
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) || ( iMaxIterations < 0 ) )
+  {
+    return -1;
+  }
+
+  piLabels  = ( int * )    malloc( sizeof( int ) * iPoints );
+  plCounts  = ( long * )   malloc( sizeof( long ) * iK );
+  pdUpper   = ( double * ) malloc( sizeof( double ) * iPoints );
+  pdLower   = ( double * ) malloc( sizeof( double ) * ( ( iElkan ) ? ( ( long ) iPoints * iK ) : ( iPoints ) ) );
+  pdCC      = ( double * ) malloc( sizeof( double ) * iK * iK );
+  pdS       = ( double * ) malloc( sizeof( double ) * iK );
+  pdMoved   = ( double * ) malloc( sizeof( double ) * iK );
+  pdSums    = ( double * ) malloc( sizeof( double ) * iK * iDimensions );
+
+  if( ( piLabels == NULL ) || ( plCounts == NULL ) || ( pdUpper == NULL ) || ( pdLower == NULL ) || ( pdCC == NULL ) || ( pdS == NULL ) || ( pdMoved == NULL ) || ( pdSums == NULL ) )
+  {
+    free( piLabels );
+    free( plCounts );
+    free( pdUpper );
+    free( pdLower );
+    free( pdCC );
+    free( pdS );
+    free( pdMoved );
+    free( pdSums );
+    return -1;
+  }
+
+  for( i = 0; i < ( iPoints * iDimensions ); i++ )
+  {
+    dTotal += pdData[i] * pdData[i];
+  }
+
+  // initial assignment, all distances are computed once so the bounds are exact
+  for( i = 0; i < iPoints; i++ )
+  {
+    const double *pdX     = pdData + ( ( long ) i * iDimensions );
+    double        dBest   = HUGE_VAL;
+    double        dSecond = HUGE_VAL;
+    int           iBest   = 0;
+
+    for( j = 0; j < iK; j++ )
+    {
+      double dD = distance( pdX, pdCentroids + ( j * iDimensions ), iDimensions );
+
+      if( iElkan )
+      {
+        pdLower[ ( long ) i * iK + j ] = dD;
+      }
+
+      if( dD < dBest )
+      {
+        dSecond = dBest;
+        dBest   = dD;
+        iBest   = j;
+      }
+      else if( dD < dSecond )
+      {
+        dSecond = dD;
+      }
+    }
+
+    piLabels[i] = iBest;
+    pdUpper[i]  = dBest;
+
+    if( !iElkan )
+    {
+      pdLower[i] = dSecond;
+    }
+  }
+
+  for( iIteration = 1; iIteration <= iMaxIterations; iIteration++ )
+  {
+    long   lChanged     = 0;
+    double dMaxMove     = 0.0;
+    double dSecondMove  = 0.0;
+    double dCurrent     = 0.0;
+    int    iMaxMove     = 0;
+
+    dCurrent = dTotal - move_centroids( pdData, iPoints, iDimensions, iK, piLabels, pdCentroids, pdSums, plCounts, pdMoved );
+
+    if( ( dAbandon >= 0.0 ) && ( dCurrent > dAbandon ) && ( ( ( dPrevious - dCurrent ) * ( double ) ( iMaxIterations - iIteration ) ) < ( dCurrent - dAbandon ) ) )
+    {
+      iAbandoned = 1;
+      break;
+    }
+
+    dPrevious = dCurrent;
+
+    for( j = 0; j < iK; j++ )
+    {
+      if( pdMoved[j] > dMaxMove )
+      {
+        dSecondMove = dMaxMove;
+        dMaxMove    = pdMoved[j];
+        iMaxMove    = j;
+      }
+      else if( pdMoved[j] > dSecondMove )
+      {
+        dSecondMove = pdMoved[j];
+      }
+    }
+
+    // loosen the bounds by the centroid movement
+    for( i = 0; i < iPoints; i++ )
+    {
+      pdUpper[i] += pdMoved[ piLabels[i] ];
+
+      if( iElkan )
+      {
+        double *pdL = pdLower + ( ( long ) i * iK );
+
+        for( j = 0; j < iK; j++ )
+        {
+          pdL[j] = ( pdL[j] > pdMoved[j] ) ? ( pdL[j] - pdMoved[j] ) : ( 0.0 );
+        }
+      }
+      else
+      {
+        pdLower[i] -= ( piLabels[i] == iMaxMove ) ? ( dSecondMove ) : ( dMaxMove );
+      }
+    }
+
+    centroid_distances( pdCentroids, iK, iDimensions, pdCC, pdS );
+
+    // assignment step
+    for( i = 0; i < iPoints; i++ )
+    {
+      const double *pdX = pdData + ( ( long ) i * iDimensions );
+      int           iA  = piLabels[i];
+
+      if( iElkan )
+      {
+        double *pdL     = pdLower + ( ( long ) i * iK );
+        int     iTight  = 0;
+
+        if( pdUpper[i] <= pdS[ iA ] )
+        {
+          continue;
+        }
+
+        for( j = 0; j < iK; j++ )
+        {
+          double dD = 0.0;
+
+          if( ( j == iA ) || ( pdUpper[i] <= pdL[j] ) || ( pdUpper[i] <= ( 0.5 * pdCC[ iA * iK + j ] ) ) )
+          {
+            continue;
+          }
+
+          if( !iTight )
+          {
+            pdUpper[i]  = distance( pdX, pdCentroids + ( iA * iDimensions ), iDimensions );
+            pdL[ iA ]   = pdUpper[i];
+            iTight      = 1;
+
+            if( ( pdUpper[i] <= pdL[j] ) || ( pdUpper[i] <= ( 0.5 * pdCC[ iA * iK + j ] ) ) )
+            {
+              continue;
+            }
+          }
+
+          dD      = distance( pdX, pdCentroids + ( j * iDimensions ), iDimensions );
+          pdL[j]  = dD;
+
+          if( dD < pdUpper[i] )
+          {
+            iA          = j;
+            pdUpper[i]  = dD;
+          }
+        }
+      }
+      else
+      {
+        double dBound   = ( pdS[ iA ] > pdLower[i] ) ? ( pdS[ iA ] ) : ( pdLower[i] );
+        double dBest    = HUGE_VAL;
+        double dSecond  = HUGE_VAL;
+
+        if( pdUpper[i] <= dBound )
+        {
+          continue;
+        }
+
+        pdUpper[i] = distance( pdX, pdCentroids + ( iA * iDimensions ), iDimensions );
+
+        if( pdUpper[i] <= dBound )
+        {
+          continue;
+        }
+
+        for( j = 0; j < iK; j++ )
+        {
+          double dD = ( j == piLabels[i] ) ? ( pdUpper[i] ) : ( distance( pdX, pdCentroids + ( j * iDimensions ), iDimensions ) );
+
+          if( dD < dBest )
+          {
+            dSecond = dBest;
+            dBest   = dD;
+            iA      = j;
+          }
+          else if( dD < dSecond )
+          {
+            dSecond = dD;
+          }
+        }
+
+        pdUpper[i] = dBest;
+        pdLower[i] = dSecond;
+      }
+
+      if( iA != piLabels[i] )
+      {
+        piLabels[i] = iA;
+        lChanged++;
+      }
+    }
+
+    if( lChanged == 0 )
+    {
+      break;
+    }
+  }
+
+  if( iIteration > iMaxIterations )
+  {
+    iIteration = iMaxIterations;
+  }
+
+  *pdDistortion = ( iAbandoned ) ? ( HUGE_VAL ) : ( 0.0 );
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    double dD = distance( pdData + ( ( long ) i * iDimensions ), pdCentroids + ( piLabels[i] * iDimensions ), iDimensions );
+
+    if( pdLabels != NULL )
+    {
+      pdLabels[i] = ( double ) piLabels[i];
+    }
+
+    if( pdDistances != NULL )
+    {
+      pdDistances[i] = dD;
+    }
+
+    if( !iAbandoned )
+    {
+      *pdDistortion += dD * dD;
+    }
+  }
+
+  free( piLabels );
+  free( plCounts );
+  free( pdUpper );
+  free( pdLower );
+  free( pdCC );
+  free( pdS );
+  free( pdMoved );
+  free( pdSums );
+
+  return iIteration;
+} // }}}
+
+
+/*! \fn       int c_kmeans( const double *pdData, int iPoints, int iDimensions, int iK, int iMaxIterations, double *pdCentroids, double *pdLabels, double *pdDistances ) // {{{
+ *  \brief    Lloyd k-means from the given start centroids, see c_kmeans_bounded.
+ *
+ *  \return   Number of iterations until the assignment did not change anymore, -1 on invalid arguments
+ */
+int c_kmeans( const double *pdData, int iPoints, int iDimensions, int iK, int iMaxIterations, double *pdCentroids, double *pdLabels, double *pdDistances )
+{
+  double dDistortion = 0.0;
+
+  return c_kmeans_bounded( pdData, iPoints, iDimensions, iK, iMaxIterations, -1.0, pdCentroids, pdLabels, pdDistances, &dDistortion );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,43 @@
+/*!
+ *
+ * \file        c_kmeans.h
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Lloyd k-means with triangle inequality bounds (Hamerly for low, Elkan for high dimensions).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#ifndef _C_KMEANS_H_
+#  define _C_KMEANS_H_
+
+
+///! From this dimension on Elkan's k lower bounds per point pay off over Hamerly's single one
+#  define C_KMEANS_ELKAN_DIMENSIONS 20
+
+///! Abandoning a run against dAbandon ( c_kmeans_bounded ) is a heuristic, not a proof: the last
+///! improvement is extrapolated linearly, a run can still end below dAbandon after it was dropped
+
+///! Prototypes
+int c_kmeans_bounded( const double * /* pdData */, int /* iPoints */, int /* iDimensions */, int /* iK */, int /* iMaxIterations */, double /* dAbandon */, double * /* pdCentroids */, double * /* pdLabels */, double * /* pdDistances */, double * /* pdDistortion */ );
+int c_kmeans( const double * /* pdData */, int /* iPoints */, int /* iDimensions */, int /* iK */, int /* iMaxIterations */, double * /* pdCentroids */, double * /* pdLabels */, double * /* pdDistances */ );
+
+#endif
+
+// vim:ts=2:tw=100:wm=100
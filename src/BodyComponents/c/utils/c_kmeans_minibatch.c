@@ -0,0 +1,197 @@
+/*!
+ *
+ * \file        c_kmeans_minibatch.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Mini-batch k-means (per centroid learning rates), memory scales with the batch size.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_random.h"
+#include "c_kmeans_minibatch.h"       ///< Include own header
+
+
+/*! \fn       static int nearest( const double *pdX, const double *pdCentroids, int iK, int iDimensions, double *pdDistance ) // {{{
+ *  \brief    Index of (and squared distance to) the closest centroid of a point
+ */
+static int nearest( const double *pdX, const double *pdCentroids, int iK, int iDimensions, double *pdDistance )
+{
+  int    j      = 0;
+  int    c      = 0;
+  int    iBest  = 0;
+  double dBest  = HUGE_VAL;
+
+  for( j = 0; j < iK; j++ )
+  {
+    const double *pdC = pdCentroids + ( j * iDimensions );
+    double        dD  = 0.0;
+
+    for( c = 0; ( c < iDimensions ) && ( dD < dBest ); c++ )
+    {
+      dD += ( pdX[c] - pdC[c] ) * ( pdX[c] - pdC[c] );
+    }
+
+    if( dD < dBest )
+    {
+      dBest = dD;
+      iBest = j;
+    }
+  }
+
+  *pdDistance = dBest;
+
+  return iBest;
+} // }}}
+
+
+/*! \fn       int c_kmeans_minibatch( const double *pdData, int iPoints, int iDimensions, int iK, int iBatch, int iMaxIterations, double dTolerance, int iSeed, double *pdCentroids, double *pdLabels, double *pdDistances ) // {{{
+ *  \brief    Mini-batch k-means (Sculley, "Web-Scale K-Means Clustering", 2010). Every iteration
+ *            draws iBatch points, assigns them to the current centroids and then moves each
+ *            centroid towards its points with a per centroid learning rate 1 / v_c, where v_c
+ *            counts all points the centroid has taken so far:
+ *
+ *              c <- ( 1 - 1 / v_c ) c + ( 1 / v_c ) x
+ *
+ *            The run stops once no centroid moved more than dTolerance during an iteration for
+ *            C_KMEANS_MINIBATCH_PATIENCE iterations in a row. Besides the outputs only the batch
+ *            (and k x d) is kept in memory, independent of the number of points.
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    iK              Number of clusters k
+ *  \param    iBatch          Points per mini-batch
+ *  \param    iMaxIterations  Maximum number of mini-batches
+ *  \param    dTolerance      Largest centroid movement per iteration which counts as converged
+ *  \param    iSeed           Seed of the batch sampling
+ *  \param    pdCentroids     Start centroids (k x d) in, final centroids out
+ *  \param    pdLabels        Output, cluster index of every point ( n values )
+ *  \param    pdDistances     Output, distance of every point to its centroid ( n values )
+ *
+ *  \return   Number of mini-batches used, -1 on invalid arguments
+ */
+int c_kmeans_minibatch( const double *pdData, int iPoints, int iDimensions, int iK, int iBatch, int iMaxIterations, double dTolerance, int iSeed, double *pdCentroids, double *pdLabels, double *pdDistances )
+{
+  int       i           = 0;
+  int       j           = 0;
+  int       c           = 0;
+  int       iIteration  = 0;
+  int       iQuiet      = 0;
+  uint64_t  ulState     = c_random_state( iSeed, 0 );
+  int      *piBatch     = NULL;
+  int      *piLabels    = NULL;
+  double   *pdCounts    = NULL;
+  double   *pdPrevious  = NULL;
+
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) || ( iBatch < 1 ) || ( iMaxIterations < 0 ) || ( dTolerance < 0.0 ) )
+  {
+    return -1;
+  }
+
+  piBatch     = ( int * )    malloc( sizeof( int ) * iBatch );
+  piLabels    = ( int * )    malloc( sizeof( int ) * iBatch );
+  pdCounts    = ( double * ) calloc( iK, sizeof( double ) );
+  pdPrevious  = ( double * ) malloc( sizeof( double ) * iK * iDimensions );
+
+  if( ( piBatch == NULL ) || ( piLabels == NULL ) || ( pdCounts == NULL ) || ( pdPrevious == NULL ) )
+  {
+    free( piBatch );
+    free( piLabels );
+    free( pdCounts );
+    free( pdPrevious );
+    return -1;
+  }
+
+  for( iIteration = 0; iIteration < iMaxIterations; iIteration++ )
+  {
+    double dMaxMove = 0.0;
+
+    memcpy( pdPrevious, pdCentroids, sizeof( double ) * iK * iDimensions );
+
+    // assign the whole batch to the centroids of the previous iteration first
+    for( i = 0; i < iBatch; i++ )
+    {
+      double dDistance = 0.0;
+
+      piBatch[i]  = ( int ) ( c_random_uniform( &ulState ) * iPoints );
+      piLabels[i] = nearest( pdData + ( ( long ) piBatch[i] * iDimensions ), pdCentroids, iK, iDimensions, &dDistance );
+    }
+
+    for( i = 0; i < iBatch; i++ )
+    {
+      const double *pdX   = pdData + ( ( long ) piBatch[i] * iDimensions );
+      double       *pdC   = pdCentroids + ( piLabels[i] * iDimensions );
+      double        dRate = 0.0;
+
+      pdCounts[ piLabels[i] ] += 1.0;
+      dRate                    = 1.0 / pdCounts[ piLabels[i] ];
+
+      for( c = 0; c < iDimensions; c++ )
+      {
+        pdC[c] = ( 1.0 - dRate ) * pdC[c] + dRate * pdX[c];
+      }
+    }
+
+    for( j = 0; j < iK; j++ )
+    {
+      double dMove = 0.0;
+
+      for( c = 0; c < iDimensions; c++ )
+      {
+        double dDelta = pdCentroids[ j * iDimensions + c ] - pdPrevious[ j * iDimensions + c ];
+        dMove        += dDelta * dDelta;
+      }
+
+      if( dMove > dMaxMove )
+      {
+        dMaxMove = dMove;
+      }
+    }
+
+    iQuiet = ( sqrt( dMaxMove ) <= dTolerance ) ? ( iQuiet + 1 ) : ( 0 );
+
+    if( iQuiet >= C_KMEANS_MINIBATCH_PATIENCE )
+    {
+      iIteration++;
+      break;
+    }
+  }
+
+  // final assignment of all points
+  for( i = 0; i < iPoints; i++ )
+  {
+    double dDistance = 0.0;
+
+    pdLabels[i]    = ( double ) nearest( pdData + ( ( long ) i * iDimensions ), pdCentroids, iK, iDimensions, &dDistance );
+    pdDistances[i] = sqrt( dDistance );
+  }
+
+  free( piBatch );
+  free( piLabels );
+  free( pdCounts );
+  free( pdPrevious );
+
+  return iIteration;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
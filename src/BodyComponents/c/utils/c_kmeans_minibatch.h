@@ -0,0 +1,39 @@
+/*!
+ *
+ * \file        c_kmeans_minibatch.h
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Mini-batch k-means (per centroid learning rates), memory scales with the batch size.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#ifndef _C_KMEANS_MINIBATCH_H_
+#  define _C_KMEANS_MINIBATCH_H_
+
+
+///! Consecutive iterations the centroid movement has to stay below the tolerance (batches are noisy)
+#  define C_KMEANS_MINIBATCH_PATIENCE 3
+
+///! Prototypes
+int c_kmeans_minibatch( const double * /* pdData */, int /* iPoints */, int /* iDimensions */, int /* iK */, int /* iBatch */, int /* iMaxIterations */, double /* dTolerance */, int /* iSeed */, double * /* pdCentroids */, double * /* pdLabels */, double * /* pdDistances */ );
+
+#endif
+
+// vim:ts=2:tw=100:wm=100
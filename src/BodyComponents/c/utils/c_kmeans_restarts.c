@@ -0,0 +1,342 @@
+/*!
+ *
+ * \file        c_kmeans_restarts.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Parallel k-means restarts (k-means++ seeding, deterministic per restart) on a pthread pool.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_kmeans.h"
+#include "c_random.h"
+#include "c_kmeans_restarts.h"        ///< Include own header
+
+
+/*! \struct   restart_pool
+ *  \brief    Shared state of one round of restarts
+ */
+typedef struct
+{
+  const double    *pdData;
+  int              iPoints;
+  int              iDimensions;
+  int              iK;
+  int              iMaxIterations;
+  int              iSeed;
+  int              iNext;             ///< next restart to hand out
+  int              iEnd;              ///< first restart of the next round
+  double           dBound;            ///< best distortion of the previous rounds
+  double          *pdDistortions;
+  pthread_mutex_t  tLock;
+} restart_pool;
+
+
+/*! \struct   restart_worker
+ *  \brief    Per thread scratch space and best result of one round
+ */
+typedef struct
+{
+  restart_pool    *ptPool;
+  int              iBest;
+  double           dBest;
+  double          *pdBest;            ///< k x d
+  double          *pdCentroids;       ///< k x d scratch
+} restart_worker;
+
+
+/*! \fn       int c_kmeans_seed( const double *pdData, int iPoints, int iDimensions, int iK, int iSeed, int iRestart, double *pdCentroids ) // {{{
+ *  \brief    k-means++ seeding: the first centroid is a uniformly drawn point, every further one
+ *            is drawn with probability proportional to the squared distance to the closest centroid
+ *            chosen so far. The random stream only depends on ( iSeed, iRestart ).
+ *
+ *  \param    pdData        Points, iPoints x iDimensions, row major
+ *  \param    iPoints       Number of points n
+ *  \param    iDimensions   Dimensions d of every point
+ *  \param    iK            Number of clusters k
+ *  \param    iSeed         Seed of the whole run
+ *  \param    iRestart      Index of the restart
+ *  \param    pdCentroids   Output, k x d start centroids
+ *
+ *  \return   Number of values written ( k * d ), -1 on invalid arguments
+ */
+int c_kmeans_seed( const double *pdData, int iPoints, int iDimensions, int iK, int iSeed, int iRestart, double *pdCentroids )
+{
+  int       i       = 0;
+  int       j       = 0;
+  int       c       = 0;
+  int       iPick   = 0;
+  uint64_t  ulState = c_random_state( iSeed, iRestart );
+  double   *pdD2    = NULL;
+
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) || ( iK > iPoints ) )
+  {
+    return -1;
+  }
+
+  pdD2 = ( double * ) malloc( sizeof( double ) * iPoints );
+
+  if( pdD2 == NULL )
+  {
+    return -1;
+  }
+
+  iPick = ( int ) ( c_random_uniform( &ulState ) * iPoints );
+  memcpy( pdCentroids, pdData + ( ( long ) iPick * iDimensions ), sizeof( double ) * iDimensions );
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    pdD2[i] = HUGE_VAL;
+  }
+
+  for( j = 1; j < iK; j++ )
+  {
+    const double *pdLast  = pdCentroids + ( ( j - 1 ) * iDimensions );
+    double        dSum    = 0.0;
+    double        dTarget = 0.0;
+
+    for( i = 0; i < iPoints; i++ )
+    {
+      const double *pdX = pdData + ( ( long ) i * iDimensions );
+      double        dD  = 0.0;
+
+      for( c = 0; c < iDimensions; c++ )
+      {
+        dD += ( pdX[c] - pdLast[c] ) * ( pdX[c] - pdLast[c] );
+      }
+
+      if( dD < pdD2[i] )
+      {
+        pdD2[i] = dD;
+      }
+
+      dSum += pdD2[i];
+    }
+
+    if( dSum > 0.0 )
+    {
+      dTarget = c_random_uniform( &ulState ) * dSum;
+      iPick   = iPoints - 1;
+
+      for( i = 0; i < iPoints; i++ )
+      {
+        dTarget -= pdD2[i];
+
+        if( dTarget < 0.0 )
+        {
+          iPick = i;
+          break;
+        }
+      }
+    }
+    else
+    {
+      // all points sit on the centroids already
+      iPick = ( int ) ( c_random_uniform( &ulState ) * iPoints );
+    }
+
+    memcpy( pdCentroids + ( j * iDimensions ), pdData + ( ( long ) iPick * iDimensions ), sizeof( double ) * iDimensions );
+  }
+
+  free( pdD2 );
+
+  return iK * iDimensions;
+} // }}}
+
+
+/*! \fn       static void *restart_thread( void *pvWorker ) // {{{
+ *  \brief    Takes restarts of the current round until none are left, keeps the best one
+ */
+static void *restart_thread( void *pvWorker )
+{
+  restart_worker *ptWorker  = ( restart_worker * ) pvWorker;
+  restart_pool   *ptPool    = ptWorker->ptPool;
+  int             iValues   = ptPool->iK * ptPool->iDimensions;
+
+  for( ;; )
+  {
+    int    iRestart     = 0;
+    double dDistortion  = HUGE_VAL;
+
+    pthread_mutex_lock( &( ptPool->tLock ) );
+    iRestart = ptPool->iNext;
+    ptPool->iNext++;
+    pthread_mutex_unlock( &( ptPool->tLock ) );
+
+    if( iRestart >= ptPool->iEnd )
+    {
+      break;
+    }
+
+    if( ( c_kmeans_seed( ptPool->pdData, ptPool->iPoints, ptPool->iDimensions, ptPool->iK, ptPool->iSeed, iRestart, ptWorker->pdCentroids ) == iValues ) &&
+        ( c_kmeans_bounded( ptPool->pdData, ptPool->iPoints, ptPool->iDimensions, ptPool->iK, ptPool->iMaxIterations, ptPool->dBound, ptWorker->pdCentroids, NULL, NULL, &dDistortion ) >= 0 ) )
+    {
+      ptPool->pdDistortions[ iRestart ] = dDistortion;
+    }
+    else
+    {
+      ptPool->pdDistortions[ iRestart ] = HUGE_VAL;
+      continue;
+    }
+
+    if( ( dDistortion < ptWorker->dBest ) || ( ( dDistortion == ptWorker->dBest ) && ( iRestart < ptWorker->iBest ) ) )
+    {
+      ptWorker->dBest = dDistortion;
+      ptWorker->iBest = iRestart;
+      memcpy( ptWorker->pdBest, ptWorker->pdCentroids, sizeof( double ) * iValues );
+    }
+  }
+
+  return NULL;
+} // }}}
+
+
+/*! \fn       int c_kmeans_restarts( const double *pdData, int iPoints, int iDimensions, int iK, int iRestarts, int iMaxIterations, int iThreads, int iSeed, double *pdCentroids, double *pdDistortions ) // {{{
+ *  \brief    Runs iRestarts independent k-means ( c_kmeans_seed + c_kmeans_bounded ) on iThreads
+ *            threads and keeps the centroids of the run with the lowest distortion (sum of squared
+ *            distances, ties go to the lower restart index). Restarts run in rounds of
+ *            C_KMEANS_RESTART_ROUND, a run which is not expected to beat the best of the previous
+ *            rounds is abandoned early (a heuristic, see c_kmeans_bounded). Seeds, bounds and the
+ *            pick only depend on iSeed, so the result is the same for any number of threads.
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    iK              Number of clusters k
+ *  \param    iRestarts       Number of restarts
+ *  \param    iMaxIterations  Maximum number of Lloyd iterations per restart
+ *  \param    iThreads        Number of worker threads
+ *  \param    iSeed           Seed of the whole run
+ *  \param    pdCentroids     Output, k x d centroids of the best restart
+ *  \param    pdDistortions   Output, distortion of every restart ( HUGE_VAL if abandoned )
+ *
+ *  \return   Index of the best restart, -1 on invalid arguments
+ */
+int c_kmeans_restarts( const double *pdData, int iPoints, int iDimensions, int iK, int iRestarts, int iMaxIterations, int iThreads, int iSeed, double *pdCentroids, double *pdDistortions )
+{
+  int             t           = 0;
+  int             iFailed     = 0;
+  int             iBest       = -1;
+  int             iValues     = iK * iDimensions;
+  double          dBest       = HUGE_VAL;
+  restart_pool    tPool;
+  restart_worker *ptWorkers   = NULL;
+  pthread_t      *ptThreads   = NULL;
+
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) || ( iK > iPoints ) || ( iRestarts < 1 ) || ( iMaxIterations < 0 ) )
+  {
+    return -1;
+  }
+
+  iThreads  = ( iThreads < 1 ) ? ( 1 ) : ( ( iThreads > C_KMEANS_RESTART_ROUND ) ? ( C_KMEANS_RESTART_ROUND ) : ( iThreads ) );
+
+  ptWorkers = ( restart_worker * ) calloc( iThreads, sizeof( restart_worker ) );
+  ptThreads = ( pthread_t * ) malloc( sizeof( pthread_t ) * iThreads );
+
+  for( t = 0; ( ptWorkers != NULL ) && ( t < iThreads ); t++ )
+  {
+    ptWorkers[t].ptPool       = &tPool;
+    ptWorkers[t].pdBest       = ( double * ) malloc( sizeof( double ) * iValues );
+    ptWorkers[t].pdCentroids  = ( double * ) malloc( sizeof( double ) * iValues );
+    iFailed                  |= ( ptWorkers[t].pdBest == NULL ) || ( ptWorkers[t].pdCentroids == NULL );
+  }
+
+  if( ( ptWorkers == NULL ) || ( ptThreads == NULL ) || iFailed || ( pthread_mutex_init( &( tPool.tLock ), NULL ) != 0 ) )
+  {
+    for( t = 0; ( ptWorkers != NULL ) && ( t < iThreads ); t++ )
+    {
+      free( ptWorkers[t].pdBest );
+      free( ptWorkers[t].pdCentroids );
+    }
+
+    free( ptWorkers );
+    free( ptThreads );
+    return -1;
+  }
+
+  tPool.pdData          = pdData;
+  tPool.iPoints         = iPoints;
+  tPool.iDimensions     = iDimensions;
+  tPool.iK              = iK;
+  tPool.iMaxIterations  = iMaxIterations;
+  tPool.iSeed           = iSeed;
+  tPool.pdDistortions   = pdDistortions;
+  tPool.iNext           = 0;
+
+  while( tPool.iNext < iRestarts )
+  {
+    int iStarted = 0;
+
+    tPool.iEnd    = ( ( iRestarts - tPool.iNext ) > C_KMEANS_RESTART_ROUND ) ? ( tPool.iNext + C_KMEANS_RESTART_ROUND ) : ( iRestarts );
+    tPool.dBound  = dBest;
+
+    for( t = 0; t < iThreads; t++ )
+    {
+      ptWorkers[t].dBest = HUGE_VAL;
+      ptWorkers[t].iBest = -1;
+    }
+
+    // the calling thread works too, if a thread cannot be started the others take its share
+    for( t = 1; t < iThreads; t++ )
+    {
+      if( pthread_create( &( ptThreads[ iStarted ] ), NULL, restart_thread, &( ptWorkers[t] ) ) == 0 )
+      {
+        iStarted++;
+      }
+    }
+
+    restart_thread( &( ptWorkers[0] ) );
+
+    for( t = 0; t < iStarted; t++ )
+    {
+      pthread_join( ptThreads[t], NULL );
+    }
+
+    tPool.iNext = tPool.iEnd;
+
+    for( t = 0; t < iThreads; t++ )
+    {
+      if( ( ptWorkers[t].iBest >= 0 ) && ( ( ptWorkers[t].dBest < dBest ) || ( ( ptWorkers[t].dBest == dBest ) && ( ptWorkers[t].iBest < iBest ) ) ) )
+      {
+        dBest = ptWorkers[t].dBest;
+        iBest = ptWorkers[t].iBest;
+        memcpy( pdCentroids, ptWorkers[t].pdBest, sizeof( double ) * iValues );
+      }
+    }
+  }
+
+  pthread_mutex_destroy( &( tPool.tLock ) );
+
+  for( t = 0; t < iThreads; t++ )
+  {
+    free( ptWorkers[t].pdBest );
+    free( ptWorkers[t].pdCentroids );
+  }
+
+  free( ptWorkers );
+  free( ptThreads );
+
+  return iBest;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,135 @@
+/*!
+ *
+ * \file        c_kmeans_score.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Fused assignment and scoring (labels, distances, distortions, TCSS, closest frames) of a k-means model.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "c_kmeans_score.h"       ///< Include own header
+
+
+/*! \fn       int c_kmeans_score( const double *pdData, int iPoints, int iDimensions, const double *pdCentroids, int iK, double *pdLabels, double *pdDistances, double *pdTCSS, double *pdClosestFrames, double *pdClosestDistances, double *pdTotals ) // {{{
+ *  \brief    Scores a fitted k-means model in one sweep over the points. Every point to centroid
+ *            distance is computed exactly once and feeds both directions at the same time:
+ *
+ *              per point     argmin over the centroids -> label, distance
+ *              per centroid  argmin over the points    -> closest frame, its distance
+ *
+ *            The per point minimum is accumulated right away into the distortion ( sum d ), the
+ *            squared error distortion ( sum d^2 / n ) and the within cluster sum of squares of
+ *            its cluster ( sum d^2 / n over the cluster, i.e. the same normalization as
+ *            Clustering#total_within_cluster_sum_of_squares ). Ties go to the lower centroid
+ *            index and the earlier frame.
+ *
+ *  \param    pdData              Points, iPoints x iDimensions, row major
+ *  \param    iPoints             Number of points n
+ *  \param    iDimensions         Dimensions d of every point
+ *  \param    pdCentroids         Centroids, iK x iDimensions, row major
+ *  \param    iK                  Number of clusters k
+ *  \param    pdLabels            Output, cluster index of every point ( n values )
+ *  \param    pdDistances         Output, distance of every point to its centroid ( n values )
+ *  \param    pdTCSS              Output, within cluster sum of squares of every cluster ( k values )
+ *  \param    pdClosestFrames     Output, index of the point closest to every centroid ( k values )
+ *  \param    pdClosestDistances  Output, distance of that point to the centroid ( k values )
+ *  \param    pdTotals            Output, [ distortion, squared error distortion ] ( C_KMEANS_SCORE_TOTALS values )
+ *
+ *  \return   k, -1 on invalid arguments
+ */
+int c_kmeans_score( const double *pdData, int iPoints, int iDimensions, const double *pdCentroids, int iK, double *pdLabels, double *pdDistances, double *pdTCSS, double *pdClosestFrames, double *pdClosestDistances, double *pdTotals )
+{
+  int    i            = 0;
+  int    j            = 0;
+  int    c            = 0;
+  double dDistortion  = 0.0;
+  double dSquared     = 0.0;
+
+  // Pre-condition check
+  if( ( pdData == NULL ) || ( pdCentroids == NULL ) || ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iK < 1 ) )
+  {
+    return -1;
+  }
+
+  if( ( pdLabels == NULL ) || ( pdDistances == NULL ) || ( pdTCSS == NULL ) || ( pdClosestFrames == NULL ) || ( pdClosestDistances == NULL ) || ( pdTotals == NULL ) )
+  {
+    return -1;
+  }
+
+  for( j = 0; j < iK; j++ )
+  {
+    pdTCSS[j]             = 0.0;
+    pdClosestFrames[j]    = 0.0;
+    pdClosestDistances[j] = HUGE_VAL;
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    const double *pdX     = pdData + ( ( long ) i * iDimensions );
+    int           iBest   = 0;
+    double        dBest   = HUGE_VAL;
+
+    for( j = 0; j < iK; j++ )
+    {
+      const double *pdC   = pdCentroids + ( j * iDimensions );
+      double        dD    = 0.0;
+
+      for( c = 0; c < iDimensions; c++ )
+      {
+        dD += ( pdX[c] - pdC[c] ) * ( pdX[c] - pdC[c] );
+      }
+
+      // squared distances order the same way, the root is only needed for the stored values
+      if( dD < dBest )
+      {
+        dBest = dD;
+        iBest = j;
+      }
+
+      if( dD < pdClosestDistances[j] )
+      {
+        pdClosestDistances[j] = dD;
+        pdClosestFrames[j]    = ( double ) i;
+      }
+    }
+
+    pdLabels[i]     = ( double ) iBest;
+    pdDistances[i]  = sqrt( dBest );
+
+    pdTCSS[ iBest ] += dBest;
+    dDistortion     += pdDistances[i];
+    dSquared        += dBest;
+  }
+
+  for( j = 0; j < iK; j++ )
+  {
+    pdTCSS[j]             /= ( double ) iPoints;
+    pdClosestDistances[j]  = sqrt( pdClosestDistances[j] );
+  }
+
+  pdTotals[0] = dDistortion;
+  pdTotals[1] = dSquared / ( double ) iPoints;
+
+  return iK;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,272 @@
+/*!
+ *
+ * \file        c_kmeans_search.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Parallel k range search (elbow curve), warm started by splitting the worst cluster.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_kmeans.h"
+#include "c_kmeans_restarts.h"
+#include "c_kmeans_search.h"          ///< Include own header
+
+
+/*! \struct   search_pool
+ *  \brief    Shared state of a k range search
+ */
+typedef struct
+{
+  const double    *pdData;
+  int              iPoints;
+  int              iDimensions;
+  int              iFrom;
+  int              iTo;
+  int              iMaxIterations;
+  int              iSeed;
+  int              iNext;             ///< first k of the next chain to hand out
+  int              iFailed;
+  double          *pdCurve;
+  double          *pdTCSS;
+  double          *pdLabels;
+  pthread_mutex_t  tLock;
+} search_pool;
+
+
+/*! \fn       static int search_chain( search_pool *ptPool, int iFirst, int iLast, double *pdCentroids, double *pdLabels, double *pdDistances, double *pdSSE ) // {{{
+ *  \brief    k-means for k = iFirst..iLast, iFirst k-means++ seeded, every further k starts from
+ *            the previous centroids plus the point farthest from the centroid of the cluster with
+ *            the largest sum of squared distances. The curve and TCSS rows are written in the same
+ *            pass over the assignment.
+ *
+ *  \return   0 on success, -1 on failure
+ */
+static int search_chain( search_pool *ptPool, int iFirst, int iLast, double *pdCentroids, double *pdLabels, double *pdDistances, double *pdSSE )
+{
+  int    i       = 0;
+  int    k       = 0;
+  int    iD      = ptPool->iDimensions;
+  int    iN      = ptPool->iPoints;
+
+  if( c_kmeans_seed( ptPool->pdData, iN, iD, iFirst, ptPool->iSeed, iFirst, pdCentroids ) != ( iFirst * iD ) )
+  {
+    return -1;
+  }
+
+  for( k = iFirst; k <= iLast; k++ )
+  {
+    int     iRow        = k - ptPool->iFrom;
+    long    lOffset     = ( ( long ) ( k - 1 ) * k - ( long ) ( ptPool->iFrom - 1 ) * ptPool->iFrom ) / 2;
+    double  dDistortion = 0.0;
+    double  dSquared    = 0.0;
+    double  dUnused     = 0.0;
+    int     iWorst      = 0;
+    int     iFarthest   = -1;
+
+    if( k > iFirst )
+    {
+      // split the worst cluster, its farthest point becomes the new centroid
+      for( i = 1; i < ( k - 1 ); i++ )
+      {
+        if( pdSSE[i] > pdSSE[ iWorst ] )
+        {
+          iWorst = i;
+        }
+      }
+
+      for( i = 0; i < iN; i++ )
+      {
+        if( ( ( int ) pdLabels[i] == iWorst ) && ( ( iFarthest < 0 ) || ( pdDistances[i] > pdDistances[ iFarthest ] ) ) )
+        {
+          iFarthest = i;
+        }
+      }
+
+      // only happens if the worst cluster is empty (all of them are exact then), any point will do
+      if( iFarthest < 0 )
+      {
+        iFarthest = 0;
+      }
+
+      memcpy( pdCentroids + ( ( k - 1 ) * iD ), ptPool->pdData + ( ( long ) iFarthest * iD ), sizeof( double ) * iD );
+    }
+
+    if( c_kmeans_bounded( ptPool->pdData, iN, iD, k, ptPool->iMaxIterations, -1.0, pdCentroids, pdLabels, pdDistances, &dUnused ) < 0 )
+    {
+      return -1;
+    }
+
+    for( i = 0; i < k; i++ )
+    {
+      pdSSE[i] = 0.0;
+    }
+
+    for( i = 0; i < iN; i++ )
+    {
+      dDistortion                   += pdDistances[i];
+      pdSSE[ ( int ) pdLabels[i] ]  += pdDistances[i] * pdDistances[i];
+    }
+
+    for( i = 0; i < k; i++ )
+    {
+      dSquared                         += pdSSE[i];
+      ptPool->pdTCSS[ lOffset + i ]     = pdSSE[i] / ( double ) iN;
+    }
+
+    ptPool->pdCurve[ 2 * iRow ]         = dDistortion;
+    ptPool->pdCurve[ 2 * iRow + 1 ]     = dSquared / ( double ) iN;
+
+    if( k == ptPool->iTo )
+    {
+      memcpy( ptPool->pdLabels, pdLabels, sizeof( double ) * iN );
+    }
+  }
+
+  return 0;
+} // }}}
+
+
+/*! \fn       static void *search_thread( void *pvPool ) // {{{
+ *  \brief    Takes chains of the k range until none are left
+ */
+static void *search_thread( void *pvPool )
+{
+  search_pool *ptPool       = ( search_pool * ) pvPool;
+  double      *pdCentroids  = ( double * ) malloc( sizeof( double ) * ptPool->iTo * ptPool->iDimensions );
+  double      *pdLabels     = ( double * ) malloc( sizeof( double ) * ptPool->iPoints );
+  double      *pdDistances  = ( double * ) malloc( sizeof( double ) * ptPool->iPoints );
+  double      *pdSSE        = ( double * ) malloc( sizeof( double ) * ptPool->iTo );
+  int          iFailed      = ( pdCentroids == NULL ) || ( pdLabels == NULL ) || ( pdDistances == NULL ) || ( pdSSE == NULL );
+
+  for( ;; )
+  {
+    int iFirst = 0;
+    int iLast  = 0;
+
+    pthread_mutex_lock( &( ptPool->tLock ) );
+    iFirst          = ptPool->iNext;
+    ptPool->iNext  += C_KMEANS_SEARCH_CHAIN;
+    ptPool->iFailed = ptPool->iFailed || iFailed;
+    pthread_mutex_unlock( &( ptPool->tLock ) );
+
+    if( iFailed || ( iFirst > ptPool->iTo ) )
+    {
+      break;
+    }
+
+    iLast   = ( ( iFirst + C_KMEANS_SEARCH_CHAIN - 1 ) > ptPool->iTo ) ? ( ptPool->iTo ) : ( iFirst + C_KMEANS_SEARCH_CHAIN - 1 );
+    iFailed = ( search_chain( ptPool, iFirst, iLast, pdCentroids, pdLabels, pdDistances, pdSSE ) != 0 );
+  }
+
+  pthread_mutex_lock( &( ptPool->tLock ) );
+  ptPool->iFailed = ptPool->iFailed || iFailed;
+  pthread_mutex_unlock( &( ptPool->tLock ) );
+
+  free( pdCentroids );
+  free( pdLabels );
+  free( pdDistances );
+  free( pdSSE );
+
+  return NULL;
+} // }}}
+
+
+/*! \fn       int c_kmeans_search( const double *pdData, int iPoints, int iDimensions, int iFrom, int iTo, int iMaxIterations, int iThreads, int iSeed, double *pdCurve, double *pdTCSS, double *pdLabels ) // {{{
+ *  \brief    Runs k-means for every k in [ iFrom, iTo ] (elbow curve). The range is cut into chains of
+ *            C_KMEANS_SEARCH_CHAIN consecutive k which run in parallel on iThreads threads, within a
+ *            chain k + 1 is warm started from k by splitting the worst cluster.
+ *
+ *  \param    pdData          Points, iPoints x iDimensions, row major
+ *  \param    iPoints         Number of points n
+ *  \param    iDimensions     Dimensions d of every point
+ *  \param    iFrom           Smallest k ( >= 1 )
+ *  \param    iTo             Largest k ( <= n )
+ *  \param    iMaxIterations  Maximum number of Lloyd iterations per k
+ *  \param    iThreads        Number of worker threads
+ *  \param    iSeed           Seed of the k-means++ start of every chain
+ *  \param    pdCurve         Output, per k: distortion ( sum of distances ), squared error distortion ( sum of squared distances / n )
+ *  \param    pdTCSS          Output, per k the k within cluster sums of squares / n, one k after the other
+ *  \param    pdLabels        Output, cluster index of every point for k = iTo ( n values )
+ *
+ *  \return   Number of k evaluated, -1 on invalid arguments
+ */
+int c_kmeans_search( const double *pdData, int iPoints, int iDimensions, int iFrom, int iTo, int iMaxIterations, int iThreads, int iSeed, double *pdCurve, double *pdTCSS, double *pdLabels )
+{
+  int          t         = 0;
+  int          iStarted  = 0;
+  int          iChains   = 0;
+  search_pool  tPool;
+  pthread_t   *ptThreads = NULL;
+
+  if( ( iPoints < 1 ) || ( iDimensions < 1 ) || ( iFrom < 1 ) || ( iTo < iFrom ) || ( iTo > iPoints ) || ( iMaxIterations < 0 ) )
+  {
+    return -1;
+  }
+
+  iChains   = ( iTo - iFrom ) / C_KMEANS_SEARCH_CHAIN + 1;
+  iThreads  = ( iThreads < 1 ) ? ( 1 ) : ( ( iThreads > iChains ) ? ( iChains ) : ( iThreads ) );
+  ptThreads = ( pthread_t * ) malloc( sizeof( pthread_t ) * iThreads );
+
+  if( ( ptThreads == NULL ) || ( pthread_mutex_init( &( tPool.tLock ), NULL ) != 0 ) )
+  {
+    free( ptThreads );
+    return -1;
+  }
+
+  tPool.pdData          = pdData;
+  tPool.iPoints         = iPoints;
+  tPool.iDimensions     = iDimensions;
+  tPool.iFrom           = iFrom;
+  tPool.iTo             = iTo;
+  tPool.iMaxIterations  = iMaxIterations;
+  tPool.iSeed           = iSeed;
+  tPool.iNext           = iFrom;
+  tPool.iFailed         = 0;
+  tPool.pdCurve         = pdCurve;
+  tPool.pdTCSS          = pdTCSS;
+  tPool.pdLabels        = pdLabels;
+
+  // the calling thread works too, if a thread cannot be started the others take its share
+  for( t = 1; t < iThreads; t++ )
+  {
+    if( pthread_create( &( ptThreads[ iStarted ] ), NULL, search_thread, &tPool ) == 0 )
+    {
+      iStarted++;
+    }
+  }
+
+  search_thread( &tPool );
+
+  for( t = 0; t < iStarted; t++ )
+  {
+    pthread_join( ptThreads[t], NULL );
+  }
+
+  pthread_mutex_destroy( &( tPool.tLock ) );
+  free( ptThreads );
+
+  return ( tPool.iFailed ) ? ( -1 ) : ( iTo - iFrom + 1 );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
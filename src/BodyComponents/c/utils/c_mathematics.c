@@ -29,13 +29,299 @@
 #include <math.h>
 #include "c_mathematics.h"            ///< Include own header
 
-  /* ! \fn      // {{{
-  * *  \brief   
-  */
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#  define C_MATHEMATICS_AVX_DISPATCH                  ///< AVX path compiled in, selected at runtime
+#  include <immintrin.h>
+#elif defined( __SSE2__ )
+#  include <emmintrin.h>
+#endif
+
+
+/*! \fn       double c_eucledian_distance( double x1, double y1, double z1, double x2, double y2, double z2 ) // {{{
+ *  \brief    Eucledian distance of the two points P1 and P2 (scalar version).
+ */
 double c_eucledian_distance( double x1, double y1, double z1, double x2, double y2, double z2 )
 {
-  // Math.sqrt( ((x2-x1)**2) + ((y2-y1)**2) + ((z2-z1)**2) ) 
-  return sqrt( pow( (x2-x1), 2) + pow( (y2-y1), 2) + pow( (z2-z1), 2 ) );
+  // Math.sqrt( ((x2-x1)**2) + ((y2-y1)**2) + ((z2-z1)**2) )
+  double dX = x2 - x1;
+  double dY = y2 - y1;
+  double dZ = z2 - z1;
+
+  return sqrt( ( dX * dX ) + ( dY * dY ) + ( dZ * dZ ) );
+} // }}}
+
+
+#if defined( C_MATHEMATICS_AVX_DISPATCH )
+
+/*! \fn       static int has_avx( void ) // {{{
+ *  \brief    Checks once whether the CPU we are running on supports AVX. The extension is built for
+ *            the portable baseline (extconf.rb), so the AVX code must not run without this check.
+ *
+ *  \return   1 if AVX is available, 0 otherwise
+ */
+static int has_avx( void )
+{
+  static int iAvx = -1;
+
+  if( iAvx < 0 )
+  {
+    __builtin_cpu_init();
+    iAvx = ( __builtin_cpu_supports( "avx" ) ) ? 1 : 0;
+  }
+
+  return iAvx;
+} // }}}
+
+
+/*! \fn       static int distances_soa_avx( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdOut ) // {{{
+ *  \brief    AVX part of distances_soa, four lanes per step.
+ *
+ *  \return   Number of points done, the caller finishes the remainder
+ */
+__attribute__(( target( "avx" ) ))
+static int distances_soa_avx( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdOut )
+{
+  int i = 0;
+
+  for( ; ( i + 4 ) <= iPoints; i += 4 )
+  {
+    __m256d vX = _mm256_sub_pd( _mm256_loadu_pd( pdX2 + i ), _mm256_loadu_pd( pdX1 + i ) );
+    __m256d vY = _mm256_sub_pd( _mm256_loadu_pd( pdY2 + i ), _mm256_loadu_pd( pdY1 + i ) );
+    __m256d vZ = _mm256_sub_pd( _mm256_loadu_pd( pdZ2 + i ), _mm256_loadu_pd( pdZ1 + i ) );
+    __m256d vS = _mm256_mul_pd( vX, vX );
+
+    vS = _mm256_add_pd( vS, _mm256_mul_pd( vY, vY ) );
+    vS = _mm256_add_pd( vS, _mm256_mul_pd( vZ, vZ ) );
+
+    _mm256_storeu_pd( pdOut + i, _mm256_sqrt_pd( vS ) );
+  }
+
+  return i;
+} // }}}
+
+
+/*! \fn       static int distances_to_point_avx( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double dX, double dY, double dZ, double *pdOut ) // {{{
+ *  \brief    AVX part of distances_to_point, four lanes per step.
+ *
+ *  \return   Number of points done, the caller finishes the remainder
+ */
+__attribute__(( target( "avx" ) ))
+static int distances_to_point_avx( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double dX, double dY, double dZ, double *pdOut )
+{
+  int i = 0;
+
+  __m256d vCX = _mm256_set1_pd( dX );
+  __m256d vCY = _mm256_set1_pd( dY );
+  __m256d vCZ = _mm256_set1_pd( dZ );
+
+  for( ; ( i + 4 ) <= iPoints; i += 4 )
+  {
+    __m256d vX = _mm256_sub_pd( _mm256_loadu_pd( pdX + i ), vCX );
+    __m256d vY = _mm256_sub_pd( _mm256_loadu_pd( pdY + i ), vCY );
+    __m256d vZ = _mm256_sub_pd( _mm256_loadu_pd( pdZ + i ), vCZ );
+    __m256d vS = _mm256_mul_pd( vX, vX );
+
+    vS = _mm256_add_pd( vS, _mm256_mul_pd( vY, vY ) );
+    vS = _mm256_add_pd( vS, _mm256_mul_pd( vZ, vZ ) );
+
+    _mm256_storeu_pd( pdOut + i, _mm256_sqrt_pd( vS ) );
+  }
+
+  return i;
+} // }}}
+
+#endif // of C_MATHEMATICS_AVX_DISPATCH
+
+
+/*! \fn       static void distances_soa( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdOut ) // {{{
+ *  \brief    pdOut[i] = | P1_i - P2_i | over structure-of-arrays buffers. Four (AVX, if the CPU has it)
+ *            or two (SSE2) lanes per step, the remainder is done by the scalar loop.
+ */
+static void distances_soa( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdOut )
+{
+  int i = 0;
+
+#if defined( C_MATHEMATICS_AVX_DISPATCH )
+  if( has_avx() )
+  {
+    i = distances_soa_avx( pdX1, pdY1, pdZ1, pdX2, pdY2, pdZ2, iPoints, pdOut );
+  }
+#endif
+
+#if defined( __SSE2__ )
+  for( ; ( i + 2 ) <= iPoints; i += 2 )
+  {
+    __m128d vX = _mm_sub_pd( _mm_loadu_pd( pdX2 + i ), _mm_loadu_pd( pdX1 + i ) );
+    __m128d vY = _mm_sub_pd( _mm_loadu_pd( pdY2 + i ), _mm_loadu_pd( pdY1 + i ) );
+    __m128d vZ = _mm_sub_pd( _mm_loadu_pd( pdZ2 + i ), _mm_loadu_pd( pdZ1 + i ) );
+    __m128d vS = _mm_add_pd( _mm_add_pd( _mm_mul_pd( vX, vX ), _mm_mul_pd( vY, vY ) ), _mm_mul_pd( vZ, vZ ) );
+
+    _mm_storeu_pd( pdOut + i, _mm_sqrt_pd( vS ) );
+  }
+#endif
+
+  for( ; i < iPoints; i++ )
+  {
+    double dX = pdX2[i] - pdX1[i];
+    double dY = pdY2[i] - pdY1[i];
+    double dZ = pdZ2[i] - pdZ1[i];
+
+    pdOut[i]  = sqrt( ( dX * dX ) + ( dY * dY ) + ( dZ * dZ ) );
+  }
+} // }}}
+
+
+/*! \fn       static void distances_to_point( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double dX, double dY, double dZ, double *pdOut ) // {{{
+ *  \brief    pdOut[i] = | P_i - C | for one fixed point C (broadcast into all lanes).
+ */
+static void distances_to_point( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double dX, double dY, double dZ, double *pdOut )
+{
+  int i = 0;
+
+#if defined( C_MATHEMATICS_AVX_DISPATCH )
+  if( has_avx() )
+  {
+    i = distances_to_point_avx( pdX, pdY, pdZ, iPoints, dX, dY, dZ, pdOut );
+  }
+#endif
+
+#if defined( __SSE2__ )
+  __m128d vCX = _mm_set1_pd( dX );
+  __m128d vCY = _mm_set1_pd( dY );
+  __m128d vCZ = _mm_set1_pd( dZ );
+
+  for( ; ( i + 2 ) <= iPoints; i += 2 )
+  {
+    __m128d vX = _mm_sub_pd( _mm_loadu_pd( pdX + i ), vCX );
+    __m128d vY = _mm_sub_pd( _mm_loadu_pd( pdY + i ), vCY );
+    __m128d vZ = _mm_sub_pd( _mm_loadu_pd( pdZ + i ), vCZ );
+    __m128d vS = _mm_add_pd( _mm_add_pd( _mm_mul_pd( vX, vX ), _mm_mul_pd( vY, vY ) ), _mm_mul_pd( vZ, vZ ) );
+
+    _mm_storeu_pd( pdOut + i, _mm_sqrt_pd( vS ) );
+  }
+#endif
+
+  for( ; i < iPoints; i++ )
+  {
+    double dDX = pdX[i] - dX;
+    double dDY = pdY[i] - dY;
+    double dDZ = pdZ[i] - dZ;
+
+    pdOut[i]   = sqrt( ( dDX * dDX ) + ( dDY * dDY ) + ( dDZ * dDZ ) );
+  }
+} // }}}
+
+
+/*! \fn       int c_eucledian_distances_consecutive( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double *pdDistances ) // {{{
+ *  \brief    Distances between consecutive points of a trajectory, | P_i+1 - P_i |.
+ *
+ *  \param    pdX, pdY, pdZ   Coordinates of the trajectory (structure of arrays), n values each
+ *  \param    iPoints         Number of points n
+ *  \param    pdDistances     Output, n-1 values
+ *
+ *  \return   Number of values written (n-1), -1 if there are no points
+ */
+int c_eucledian_distances_consecutive( const double *pdX, const double *pdY, const double *pdZ, int iPoints, double *pdDistances )
+{
+  if( iPoints < 1 )
+  {
+    return -1;
+  }
+
+  distances_soa( pdX, pdY, pdZ, pdX + 1, pdY + 1, pdZ + 1, iPoints - 1, pdDistances );
+
+  return ( iPoints - 1 );
+} // }}}
+
+
+/*! \fn       int c_eucledian_distances_pairwise( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdDistances ) // {{{
+ *  \brief    Point to point distances between two arrays of the same length, | P2_i - P1_i |.
+ *
+ *  \param    pdX1, pdY1, pdZ1  First set of points (structure of arrays), n values each
+ *  \param    pdX2, pdY2, pdZ2  Second set of points (structure of arrays), n values each
+ *  \param    iPoints           Number of points n
+ *  \param    pdDistances       Output, n values
+ *
+ *  \return   Number of values written (n), -1 if there are no points
+ */
+int c_eucledian_distances_pairwise( const double *pdX1, const double *pdY1, const double *pdZ1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints, double *pdDistances )
+{
+  if( iPoints < 1 )
+  {
+    return -1;
+  }
+
+  distances_soa( pdX1, pdY1, pdZ1, pdX2, pdY2, pdZ2, iPoints, pdDistances );
+
+  return iPoints;
+} // }}}
+
+
+/*! \fn       int c_eucledian_distances_to_centroids( const double *pdX, const double *pdY, const double *pdZ, int iPoints, const double *pdCX, const double *pdCY, const double *pdCZ, int iCentroids, double *pdDistances ) // {{{
+ *  \brief    Distance matrix of all points to all centroids. The matrix is stored centroid major,
+ *            pdDistances[ j * n + i ] is the distance of point i to centroid j, so every row is
+ *            one contiguous vector pass over the points.
+ *
+ *  \param    pdX, pdY, pdZ     Points (structure of arrays), n values each
+ *  \param    iPoints           Number of points n
+ *  \param    pdCX, pdCY, pdCZ  Centroids (structure of arrays), k values each
+ *  \param    iCentroids        Number of centroids k
+ *  \param    pdDistances       Output, k * n values
+ *
+ *  \return   Number of values written (k * n), -1 on invalid arguments
+ */
+int c_eucledian_distances_to_centroids( const double *pdX, const double *pdY, const double *pdZ, int iPoints, const double *pdCX, const double *pdCY, const double *pdCZ, int iCentroids, double *pdDistances )
+{
+  int j = 0;
+
+  if( ( iPoints < 1 ) || ( iCentroids < 1 ) )
+  {
+    return -1;
+  }
+
+  for( j = 0; j < iCentroids; j++ )
+  {
+    distances_to_point( pdX, pdY, pdZ, iPoints, pdCX[j], pdCY[j], pdCZ[j], pdDistances + ( ( long ) j * iPoints ) );
+  }
+
+  return ( iCentroids * iPoints );
+} // }}}
+
+
+/*! \fn       double c_eucledian_distances_sum( const double *pdX1, const double *pdY1, const double *pdZ1, int iPoints1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints2, double *pdScratch ) // {{{
+ *  \brief    Sum of the distances of all points of set one to all points of set two
+ *            (Clustering#cluster_distances) without building the full n1 x n2 matrix.
+ *
+ *  \param    pdX1, pdY1, pdZ1  First set of points (structure of arrays), n1 values each
+ *  \param    iPoints1          Number of points n1
+ *  \param    pdX2, pdY2, pdZ2  Second set of points (structure of arrays), n2 values each
+ *  \param    iPoints2          Number of points n2
+ *  \param    pdScratch         Work buffer, n2 values
+ *
+ *  \return   Summed distance, -1.0 on invalid arguments
+ */
+double c_eucledian_distances_sum( const double *pdX1, const double *pdY1, const double *pdZ1, int iPoints1, const double *pdX2, const double *pdY2, const double *pdZ2, int iPoints2, double *pdScratch )
+{
+  int    i    = 0;
+  int    j    = 0;
+  double dSum = 0.0;
+
+  if( ( iPoints1 < 0 ) || ( iPoints2 < 0 ) )
+  {
+    return -1.0;
+  }
+
+  for( i = 0; i < iPoints1; i++ )
+  {
+    distances_to_point( pdX2, pdY2, pdZ2, iPoints2, pdX1[i], pdY1[i], pdZ1[i], pdScratch );
+
+    for( j = 0; j < iPoints2; j++ )
+    {
+      dSum += pdScratch[j];
+    }
+  }
+
+  return dSum;
 } // }}}
 
 
@@ -33,6 +33,10 @@
 
 ///! Prototypes
 double c_eucledian_distance( double /* x1 */, double /* y1 */, double /* z1 */, double /* x2 */, double /* y2 */, double /* z2 */ );
+int    c_eucledian_distances_consecutive( const double * /* pdX */, const double * /* pdY */, const double * /* pdZ */, int /* iPoints */, double * /* pdDistances */ );
+int    c_eucledian_distances_pairwise( const double * /* pdX1 */, const double * /* pdY1 */, const double * /* pdZ1 */, const double * /* pdX2 */, const double * /* pdY2 */, const double * /* pdZ2 */, int /* iPoints */, double * /* pdDistances */ );
+int    c_eucledian_distances_to_centroids( const double * /* pdX */, const double * /* pdY */, const double * /* pdZ */, int /* iPoints */, const double * /* pdCX */, const double * /* pdCY */, const double * /* pdCZ */, int /* iCentroids */, double * /* pdDistances */ );
+double c_eucledian_distances_sum( const double * /* pdX1 */, const double * /* pdY1 */, const double * /* pdZ1 */, int /* iPoints1 */, const double * /* pdX2 */, const double * /* pdY2 */, const double * /* pdZ2 */, int /* iPoints2 */, double * /* pdScratch */ );
 
 #endif
 
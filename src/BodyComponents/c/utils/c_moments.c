@@ -0,0 +1,198 @@
+/*!
+ *
+ * \file        c_moments.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Prefix moment index, mean and covariance of any frame window in O(d^2).
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include "c_moments.h"                ///< Include own header
+
+
+/*! \fn       static int moment_block( int iDimensions ) // {{{
+ *  \brief    Doubles per prefix entry, sum of x (d) and the upper triangle of sum of x*x^T.
+ */
+static int moment_block( int iDimensions )
+{
+  return ( iDimensions + ( ( iDimensions * ( iDimensions + 1 ) ) / 2 ) );
+} // }}}
+
+
+/*! \fn       long c_moment_index_size( int iRows, int iDimensions ) // {{{
+ *  \brief    Number of doubles a moment index of iRows observations of iDimensions dimensions needs.
+ *
+ *            Layout: [ d, n, shift( d ), ( n + 1 ) x [ sum x ( d ), sum x * x^T ( upper triangle ) ] ]
+ */
+long c_moment_index_size( int iRows, int iDimensions )
+{
+  if( ( iRows < 1 ) || ( iDimensions < 1 ) )
+  {
+    return -1;
+  }
+
+  return ( 2 + iDimensions + ( ( long ) ( iRows + 1 ) * moment_block( iDimensions ) ) );
+} // }}}
+
+
+/*! \fn       int c_moment_index( const double *pdData, int iRows, int iDimensions, double *pdIndex ) // {{{
+ *  \brief    Builds the cumulative sums of x and of the outer products x * x^T once. The
+ *            observations are shifted by the first row before summing, which keeps the
+ *            difference of two prefix entries well conditioned for data far away from the origin.
+ *
+ *  \param    pdData        Observations, iRows rows of iDimensions values (row major)
+ *  \param    iRows         Number of observations n
+ *  \param    iDimensions   Number of dimensions d
+ *  \param    pdIndex       Output, c_moment_index_size( n, d ) values
+ *
+ *  \return   Number of observations indexed (n), -1 on invalid arguments
+ */
+int c_moment_index( const double *pdData, int iRows, int iDimensions, double *pdIndex )
+{
+  int     r       = 0;
+  int     i       = 0;
+  int     j       = 0;
+  int     iBlock  = moment_block( iDimensions );
+  double *pdShift = pdIndex + 2;
+  double *pdPrev  = pdIndex + 2 + iDimensions;
+  double *pdX     = NULL;
+
+  if( c_moment_index_size( iRows, iDimensions ) < 0 )
+  {
+    return -1;
+  }
+
+  pdX = ( double * ) malloc( sizeof( double ) * iDimensions );
+
+  if( pdX == NULL )
+  {
+    return -1;
+  }
+
+  pdIndex[0] = ( double ) iDimensions;
+  pdIndex[1] = ( double ) iRows;
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    pdShift[i] = pdData[i];
+  }
+
+  for( i = 0; i < iBlock; i++ )
+  {
+    pdPrev[i] = 0.0;
+  }
+
+  for( r = 0; r < iRows; r++ )
+  {
+    const double *pdRow   = pdData + ( ( long ) r * iDimensions );
+    double       *pdNext  = pdPrev + iBlock;
+    int           k       = iDimensions;
+
+    for( i = 0; i < iDimensions; i++ )
+    {
+      pdX[i]    = pdRow[i] - pdShift[i];
+      pdNext[i] = pdPrev[i] + pdX[i];
+    }
+
+    for( i = 0; i < iDimensions; i++ )
+    {
+      for( j = i; j < iDimensions; j++ )
+      {
+        pdNext[k] = pdPrev[k] + ( pdX[i] * pdX[j] );
+        k++;
+      }
+    }
+
+    pdPrev = pdNext;
+  }
+
+  free( pdX );
+
+  return iRows;
+} // }}}
+
+
+/*! \fn       int c_moment_window( const double *pdIndex, int iFrom, int iTo, double *pdMean, double *pdCovariance ) // {{{
+ *  \brief    Mean and sample covariance of the frames iFrom..iTo (inclusive) from two prefix
+ *            entries, independent of the window length
+ *
+ *              S1   = P1[ to + 1 ] - P1[ from ]            m = to - from + 1
+ *              S2   = P2[ to + 1 ] - P2[ from ]
+ *              mean = shift + S1 / m
+ *              cov  = ( S2 - S1 * S1^T / m ) / ( m - 1 )
+ *
+ *  \param    pdIndex       Output of c_moment_index
+ *  \param    iFrom         First frame of the window
+ *  \param    iTo           Last frame of the window
+ *  \param    pdMean        Output, d values
+ *  \param    pdCovariance  Output, d x d values (row major), zero for single frame windows
+ *
+ *  \return   Number of frames in the window, -1 on invalid arguments
+ */
+int c_moment_window( const double *pdIndex, int iFrom, int iTo, double *pdMean, double *pdCovariance )
+{
+  int           i           = 0;
+  int           j           = 0;
+  int           k           = 0;
+  int           iDimensions = ( int ) pdIndex[0];
+  int           iRows       = ( int ) pdIndex[1];
+  int           iBlock      = moment_block( iDimensions );
+  const double *pdShift     = pdIndex + 2;
+  const double *pdA         = NULL;
+  const double *pdB         = NULL;
+  double        dM          = 0.0;
+
+  if( ( iDimensions < 1 ) || ( iFrom < 0 ) || ( iTo >= iRows ) || ( iFrom > iTo ) )
+  {
+    return -1;
+  }
+
+  pdA = pdIndex + 2 + iDimensions + ( ( long ) iFrom * iBlock );
+  pdB = pdIndex + 2 + iDimensions + ( ( long ) ( iTo + 1 ) * iBlock );
+  dM  = ( double ) ( iTo - iFrom + 1 );
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    pdMean[i] = pdShift[i] + ( ( pdB[i] - pdA[i] ) / dM );
+  }
+
+  k = iDimensions;
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    double dS1i = pdB[i] - pdA[i];
+
+    for( j = i; j < iDimensions; j++ )
+    {
+      double dS1j = pdB[j] - pdA[j];
+      double dCov = ( dM > 1.0 ) ? ( ( ( pdB[k] - pdA[k] ) - ( ( dS1i * dS1j ) / dM ) ) / ( dM - 1.0 ) ) : ( 0.0 );
+
+      pdCovariance[ ( i * iDimensions ) + j ] = dCov;
+      pdCovariance[ ( j * iDimensions ) + i ] = dCov;
+      k++;
+    }
+  }
+
+  return ( iTo - iFrom + 1 );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
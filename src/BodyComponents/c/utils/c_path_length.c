@@ -0,0 +1,122 @@
+/*!
+ *
+ * \file        c_path_length.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Cumulative arc length (prefix sum) index over a 3D trajectory.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+
+#include <math.h>
+#include "c_path_length.h"            ///< Include own header
+
+
+/*! \fn       int c_path_length_index( const double *pdX, int iPoints, double *pdPrefix ) // {{{
+ *  \brief    Builds the cumulative arc length of the polyline pdX once. pdPrefix[k] is the summed
+ *            length of the segments 0..k-1, so the length of the segments [a, b) is
+ *            pdPrefix[b] - pdPrefix[a].
+ *
+ *  \param    pdX         Trajectory of iPoints rows, interleaved [ x0, y0, z0, x1, y1, z1, ... ]
+ *  \param    iPoints     Number of points n
+ *  \param    pdPrefix    Output, n values
+ *
+ *  \return   Number of values written (n), -1 if there are no points
+ */
+int c_path_length_index( const double *pdX, int iPoints, double *pdPrefix )
+{
+  int    i    = 0;
+  double dSum = 0.0;
+
+  if( iPoints < 1 )
+  {
+    return -1;
+  }
+
+  pdPrefix[0] = 0.0;
+
+  for( i = 1; i < iPoints; i++ )
+  {
+    const double *pdP = pdX + ( 3 * ( i - 1 ) );
+    double        dX  = pdP[3] - pdP[0];
+    double        dY  = pdP[4] - pdP[1];
+    double        dZ  = pdP[5] - pdP[2];
+
+    dSum         += sqrt( ( dX * dX ) + ( dY * dY ) + ( dZ * dZ ) );
+    pdPrefix[i]   = dSum;
+  }
+
+  return iPoints;
+} // }}}
+
+
+/*! \fn       int c_path_length_window( const double *pdPrefix, int iPoints, int iWindow, double *pdDistances ) // {{{
+ *  \brief    Summed segment lengths in a window of iWindow points before and after each frame
+ *            (Mathematics#eucledian_distance_window), answered as the difference of two prefix values.
+ *
+ *            Frame i sums the segments [i-w, i+w). At the beginning of the trajectory (i-w < 0)
+ *            only [i, i+w) is used, at the end (i+w > n-1) only [i-w, i). Windows are clamped to
+ *            the trajectory if it is shorter than the window.
+ *
+ *  \param    pdPrefix      Output of c_path_length_index, n values
+ *  \param    iPoints       Number of points n
+ *  \param    iWindow       Number of points w before and after each frame
+ *  \param    pdDistances   Output, n values
+ *
+ *  \return   Number of values written (n), -1 on invalid arguments
+ */
+int c_path_length_window( const double *pdPrefix, int iPoints, int iWindow, double *pdDistances )
+{
+  int i = 0;
+
+  if( ( iPoints < 1 ) || ( iWindow < 0 ) )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < iPoints; i++ )
+  {
+    int iFrom = i - iWindow;
+    int iTo   = i + iWindow;
+
+    if( iFrom < 0 )
+    {
+      // beginning of the frames - just include the following points
+      iFrom = i;
+    }
+    else if( iTo > ( iPoints - 1 ) )
+    {
+      // end of the frames - just include the previous points
+      iTo   = i;
+    }
+
+    if( iTo > ( iPoints - 1 ) )
+    {
+      iTo   = iPoints - 1;
+    }
+
+    pdDistances[i] = ( iTo > iFrom ) ? ( pdPrefix[ iTo ] - pdPrefix[ iFrom ] ) : ( 0.0 );
+  }
+
+  return iPoints;
+} // }}}
+
+
+// vim:ts=2:tw=100:wm=100
@@ -0,0 +1,61 @@
+/*!
+ *
+ * \file        c_random.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Small deterministic random number stream (SplitMix64) shared by the native kernels.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include "c_random.h"                 ///< Include own header
+
+
+/*! \fn       uint64_t c_random_state( int iSeed, int iStream ) // {{{
+ *  \brief    Start state of the stream iStream (e.g. a restart index) of a run seeded with iSeed
+ */
+uint64_t c_random_state( int iSeed, int iStream )
+{
+  return ( ( uint64_t ) ( uint32_t ) iSeed << 32 ) ^ ( uint64_t ) ( uint32_t ) iStream;
+} // }}}
+
+
+/*! \fn       uint64_t c_random_next( uint64_t *pulState ) // {{{
+ *  \brief    SplitMix64 generator, small and good enough for seeding and sampling
+ */
+uint64_t c_random_next( uint64_t *pulState )
+{
+  uint64_t ulZ = ( *pulState += UINT64_C( 0x9E3779B97F4A7C15 ) );
+
+  ulZ = ( ulZ ^ ( ulZ >> 30 ) ) * UINT64_C( 0xBF58476D1CE4E5B9 );
+  ulZ = ( ulZ ^ ( ulZ >> 27 ) ) * UINT64_C( 0x94D049BB133111EB );
+
+  return ulZ ^ ( ulZ >> 31 );
+} // }}}
+
+
+/*! \fn       double c_random_uniform( uint64_t *pulState ) // {{{
+ *  \brief    Uniform double in [0, 1)
+ */
+double c_random_uniform( uint64_t *pulState )
+{
+  return ( double ) ( c_random_next( pulState ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
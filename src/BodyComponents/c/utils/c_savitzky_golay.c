@@ -0,0 +1,264 @@
+/*!
+ *
+ * \file        c_savitzky_golay.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Savitzky-Golay smoothing as a fixed FIR pass over many channels at once.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "c_savitzky_golay.h"         ///< Include own header
+
+
+/*! \fn       int c_savitzky_golay_coefficients( int iWindow, int iOrder, double *pdCoefficients ) // {{{
+ *  \brief    Precomputes the Savitzky-Golay convolution coefficients of a window of N = 2m+1 points
+ *            and a polynomial of the order k once.
+ *
+ *            With the Vandermonde matrix A ( N x ( k + 1 ), A[i][j] = ( ( i - m ) / m )^j ) the
+ *            least squares fit evaluated at the window points is H = A ( A^T A )^-1 A^T. Row p of
+ *            H holds the taps which give the smoothed value at window position p. The center row
+ *            m is the usual symmetric filter, the other rows are used for the first and last m
+ *            points of a signal so that no frames are lost at the borders.
+ *
+ *  \param    iWindow         Number of points N of the window, odd
+ *  \param    iOrder          Order k of the polynomial ( k < N, k <= C_SAVITZKY_GOLAY_MAX_ORDER )
+ *  \param    pdCoefficients  Output, N x N values (row major)
+ *
+ *  \return   Number of values written (N * N), -1 on invalid arguments (also N * N beyond an int),
+ *            a singular system or no memory
+ */
+int c_savitzky_golay_coefficients( int iWindow, int iOrder, double *pdCoefficients )
+{
+  int    i      = 0;
+  int    j      = 0;
+  int    a      = 0;
+  int    b      = 0;
+  int    N      = iWindow;
+  int    K      = iOrder + 1;
+  int    m      = iWindow / 2;
+  double dScale = ( m > 0 ) ? ( ( double ) m ) : ( 1.0 );
+  double *pdA   = NULL;                                                   // Vandermonde matrix, N x K
+  double adM[ C_SAVITZKY_GOLAY_MAX_ORDER + 1 ][ 2 * ( C_SAVITZKY_GOLAY_MAX_ORDER + 1 ) ]; // [ A^T A | I ] -> [ I | ( A^T A )^-1 ]
+  double adRow[ C_SAVITZKY_GOLAY_MAX_ORDER + 1 ];
+
+  if( ( N < 1 ) || ( ( N % 2 ) == 0 ) || ( iOrder < 0 ) || ( iOrder > C_SAVITZKY_GOLAY_MAX_ORDER ) || ( K > N ) || ( ( ( long ) N * N ) > INT_MAX ) )
+  {
+    return -1;
+  }
+
+  // N is the window of the caller, which has no upper bound
+  pdA = ( double * ) malloc( sizeof( double ) * ( size_t ) N * ( size_t ) K );
+
+  if( pdA == NULL )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < N; i++ )
+  {
+    double dX = ( ( double ) ( i - m ) ) / dScale;
+    double dP = 1.0;
+
+    for( j = 0; j < K; j++ )
+    {
+      pdA[ ( i * K ) + j ]  = dP;
+      dP                   *= dX;
+    }
+  }
+
+  for( a = 0; a < K; a++ )
+  {
+    for( b = 0; b < K; b++ )
+    {
+      double dSum = 0.0;
+
+      for( i = 0; i < N; i++ )
+      {
+        dSum += pdA[ ( i * K ) + a ] * pdA[ ( i * K ) + b ];
+      }
+
+      adM[a][b]       = dSum;
+      adM[a][ K + b ] = ( a == b ) ? ( 1.0 ) : ( 0.0 );
+    }
+  }
+
+  // Gauss-Jordan elimination with partial pivoting
+  for( a = 0; a < K; a++ )
+  {
+    int    iPivot = a;
+    double dPivot = 0.0;
+
+    for( i = a + 1; i < K; i++ )
+    {
+      if( fabs( adM[i][a] ) > fabs( adM[ iPivot ][a] ) )
+      {
+        iPivot = i;
+      }
+    }
+
+    if( fabs( adM[ iPivot ][a] ) < 1e-300 )
+    {
+      free( pdA );
+      return -1;
+    }
+
+    if( iPivot != a )
+    {
+      for( j = 0; j < ( 2 * K ); j++ )
+      {
+        double dTemp      = adM[a][j];
+        adM[a][j]         = adM[ iPivot ][j];
+        adM[ iPivot ][j]  = dTemp;
+      }
+    }
+
+    dPivot = adM[a][a];
+
+    for( j = 0; j < ( 2 * K ); j++ )
+    {
+      adM[a][j] /= dPivot;
+    }
+
+    for( i = 0; i < K; i++ )
+    {
+      double dFactor = adM[i][a];
+
+      if( ( i == a ) || ( dFactor == 0.0 ) )
+      {
+        continue;
+      }
+
+      for( j = 0; j < ( 2 * K ); j++ )
+      {
+        adM[i][j] -= dFactor * adM[a][j];
+      }
+    }
+  }
+
+  // H = A * ( A^T A )^-1 * A^T
+  for( i = 0; i < N; i++ )
+  {
+    for( b = 0; b < K; b++ )
+    {
+      double dSum = 0.0;
+
+      for( a = 0; a < K; a++ )
+      {
+        dSum += pdA[ ( i * K ) + a ] * adM[a][ K + b ];
+      }
+
+      adRow[b] = dSum;
+    }
+
+    for( j = 0; j < N; j++ )
+    {
+      double dSum = 0.0;
+
+      for( b = 0; b < K; b++ )
+      {
+        dSum += adRow[b] * pdA[ ( j * K ) + b ];
+      }
+
+      pdCoefficients[ ( ( long ) i * N ) + j ] = dSum;
+    }
+  }
+
+  free( pdA );
+
+  return ( N * N );
+} // }}}
+
+
+/*! \fn       int c_savitzky_golay_filter( const double *pdCoefficients, int iWindow, const double *pdIn, int iRows, int iColumns, double *pdOut ) // {{{
+ *  \brief    Smooths iColumns channels (e.g. x, y, z of all segments side by side) in one pass. Each
+ *            output row is a weighted sum of N input rows, the inner loop runs over the contiguous
+ *            channels so the compiler can vectorize it.
+ *
+ *  \param    pdCoefficients  Output of c_savitzky_golay_coefficients, N x N values
+ *  \param    iWindow         Number of points N of the window, odd
+ *  \param    pdIn            Signal, iRows frames of iColumns channels (row major)
+ *  \param    iRows           Number of frames n ( n >= N )
+ *  \param    iColumns        Number of channels
+ *  \param    pdOut           Output, iRows x iColumns values, must not overlap pdIn
+ *
+ *  \return   Number of frames written (n), -1 on invalid arguments
+ */
+int c_savitzky_golay_filter( const double *pdCoefficients, int iWindow, const double *pdIn, int iRows, int iColumns, double *pdOut )
+{
+  int r = 0;
+  int k = 0;
+  int c = 0;
+  int N = iWindow;
+  int m = iWindow / 2;
+
+  if( ( N < 1 ) || ( ( N % 2 ) == 0 ) || ( iRows < N ) || ( iColumns < 1 ) )
+  {
+    return -1;
+  }
+
+  for( r = 0; r < iRows; r++ )
+  {
+    const double *pdTaps  = NULL;
+    const double *pdFirst = NULL;
+    double       *pdY     = pdOut + ( ( long ) r * iColumns );
+
+    if( r < m )
+    {
+      // beginning, fit of the first N frames evaluated at position r
+      pdTaps  = pdCoefficients + ( r * N );
+      pdFirst = pdIn;
+    }
+    else if( r >= ( iRows - m ) )
+    {
+      // end, fit of the last N frames evaluated at position r - ( n - N )
+      pdTaps  = pdCoefficients + ( ( r - ( iRows - N ) ) * N );
+      pdFirst = pdIn + ( ( long ) ( iRows - N ) * iColumns );
+    }
+    else
+    {
+      pdTaps  = pdCoefficients + ( m * N );
+      pdFirst = pdIn + ( ( long ) ( r - m ) * iColumns );
+    }
+
+    for( c = 0; c < iColumns; c++ )
+    {
+      pdY[c] = 0.0;
+    }
+
+    for( k = 0; k < N; k++ )
+    {
+      const double *pdX = pdFirst + ( ( long ) k * iColumns );
+      const double  dH  = pdTaps[k];
+
+      for( c = 0; c < iColumns; c++ )
+      {
+        pdY[c] += dH * pdX[c];
+      }
+    }
+  }
+
+  return iRows;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
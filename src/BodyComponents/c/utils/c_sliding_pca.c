@@ -0,0 +1,252 @@
+/*!
+ *
+ * \file        c_sliding_pca.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Sliding window PCA, local eigen spectra and coordinates for every frame.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stdlib.h>
+#include "c_eigen.h"
+#include "c_sliding_pca.h"            ///< Include own header
+
+
+/*! \fn       static void window_update( const double *pdX, const double *pdShift, int iDimensions, double dSign, double *pdS1, double *pdS2 ) // {{{
+ *  \brief    Rank one update (dSign = 1.0) or downdate (dSign = -1.0) of the window sums with one frame.
+ */
+static void window_update( const double *pdX, const double *pdShift, int iDimensions, double dSign, double *pdS1, double *pdS2 )
+{
+  int i = 0;
+  int j = 0;
+
+  for( i = 0; i < iDimensions; i++ )
+  {
+    double dXi = pdX[i] - pdShift[i];
+
+    pdS1[i] += dSign * dXi;
+
+    for( j = i; j < iDimensions; j++ )
+    {
+      pdS2[ ( i * iDimensions ) + j ] += dSign * dXi * ( pdX[j] - pdShift[j] );
+    }
+  }
+} // }}}
+
+
+/*! \fn       int c_sliding_pca( const double *pdData, int iRows, int iDimensions, int iWindow, int iComponents, double *pdSpectra, double *pdProjected ) // {{{
+ *  \brief    PCA over a sliding window of frames [i-w, i+w] (clamped to the recording) for every
+ *            frame i.
+ *
+ *            The window sums of x and x*x^T are updated incrementally when a frame enters or
+ *            leaves the window, so the covariance of each window costs O(d^2). The eigen basis is
+ *            carried over from the previous frame: the new covariance is rotated into the old
+ *            basis ( B = V^T C V ), which is almost diagonal, so the Jacobi solver needs only one
+ *            or two sweeps and the axes keep their orientation from frame to frame ( V = V * W ).
+ *
+ *  \param    pdData        Frames, iRows rows of iDimensions values (row major)
+ *  \param    iRows         Number of frames n
+ *  \param    iDimensions   Number of dimensions d, at most C_EIGEN_MAX_DIMENSIONS
+ *  \param    iWindow       Number of frames w before and after each frame
+ *  \param    iComponents   Number of local principal components k to project on ( 1 <= k <= d )
+ *  \param    pdSpectra     Output, n rows of d local eigen values (descending)
+ *  \param    pdProjected   Output, n rows of k coordinates of frame i in the basis of its window
+ *
+ *  \return   Number of frames written (n), -1 on invalid arguments or if an eigen problem failed
+ */
+int c_sliding_pca( const double *pdData, int iRows, int iDimensions, int iWindow, int iComponents, double *pdSpectra, double *pdProjected )
+{
+  int           d         = iDimensions;
+  int           i         = 0;
+  int           j         = 0;
+  int           l         = 0;
+  int           r         = 0;
+  int           iFrom     = 0;
+  int           iTo       = -1;
+  int           iResult   = 0;
+  const double *pdShift   = pdData;
+  double       *pdWork    = NULL;
+  double       *pdS1, *pdS2, *pdCov, *pdV, *pdB, *pdW, *pdT, *pdMean;
+
+  if( ( iRows < 1 ) || ( d < 1 ) || ( d > C_EIGEN_MAX_DIMENSIONS ) || ( iWindow < 0 ) || ( iComponents < 1 ) || ( iComponents > d ) )
+  {
+    return -1;
+  }
+
+  pdWork = ( double * ) calloc( ( size_t ) ( ( 2 * d ) + ( 6 * d * d ) ), sizeof( double ) );
+
+  if( pdWork == NULL )
+  {
+    return -1;
+  }
+
+  pdS1    = pdWork;
+  pdMean  = pdS1  + d;
+  pdS2    = pdMean + d;
+  pdCov   = pdS2  + ( d * d );
+  pdV     = pdCov + ( d * d );
+  pdB     = pdV   + ( d * d );
+  pdW     = pdB   + ( d * d );
+  pdT     = pdW   + ( d * d );
+
+  for( i = 0; i < d; i++ )
+  {
+    pdV[ ( i * d ) + i ] = 1.0;
+  }
+
+  for( r = 0; r < iRows; r++ )
+  {
+    int    iNewFrom = ( ( r - iWindow ) < 0 ) ? ( 0 ) : ( r - iWindow );
+    int    iNewTo   = ( ( r + iWindow ) > ( iRows - 1 ) ) ? ( iRows - 1 ) : ( r + iWindow );
+    double dM       = 0.0;
+
+    if( ( r % C_SLIDING_PCA_RESYNC ) == 0 )
+    {
+      // rebuild the window sums from scratch
+      for( i = 0; i < d; i++ )
+      {
+        pdS1[i] = 0.0;
+      }
+
+      for( i = 0; i < ( d * d ); i++ )
+      {
+        pdS2[i] = 0.0;
+      }
+
+      for( l = iNewFrom; l <= iNewTo; l++ )
+      {
+        window_update( pdData + ( ( long ) l * d ), pdShift, d, 1.0, pdS1, pdS2 );
+      }
+    }
+    else
+    {
+      // frames leaving and entering the window
+      for( l = iFrom; l < iNewFrom; l++ )
+      {
+        window_update( pdData + ( ( long ) l * d ), pdShift, d, -1.0, pdS1, pdS2 );
+      }
+
+      for( l = iTo + 1; l <= iNewTo; l++ )
+      {
+        window_update( pdData + ( ( long ) l * d ), pdShift, d, 1.0, pdS1, pdS2 );
+      }
+    }
+
+    iFrom = iNewFrom;
+    iTo   = iNewTo;
+    dM    = ( double ) ( iTo - iFrom + 1 );
+
+    // covariance of the window
+    for( i = 0; i < d; i++ )
+    {
+      pdMean[i] = pdS1[i] / dM;
+    }
+
+    for( i = 0; i < d; i++ )
+    {
+      for( j = i; j < d; j++ )
+      {
+        double dCov = ( dM > 1.0 ) ? ( ( pdS2[ ( i * d ) + j ] - ( pdS1[i] * pdMean[j] ) ) / ( dM - 1.0 ) ) : ( 0.0 );
+
+        pdCov[ ( i * d ) + j ] = dCov;
+        pdCov[ ( j * d ) + i ] = dCov;
+      }
+    }
+
+    // B = V^T * C * V  (T = C * V first)
+    for( i = 0; i < d; i++ )
+    {
+      for( j = 0; j < d; j++ )
+      {
+        double dSum = 0.0;
+
+        for( l = 0; l < d; l++ )
+        {
+          dSum += pdCov[ ( i * d ) + l ] * pdV[ ( l * d ) + j ];
+        }
+
+        pdT[ ( i * d ) + j ] = dSum;
+      }
+    }
+
+    for( i = 0; i < d; i++ )
+    {
+      for( j = 0; j < d; j++ )
+      {
+        double dSum = 0.0;
+
+        for( l = 0; l < d; l++ )
+        {
+          dSum += pdV[ ( l * d ) + i ] * pdT[ ( l * d ) + j ];
+        }
+
+        pdB[ ( i * d ) + j ] = dSum;
+      }
+    }
+
+    if( c_eigen_symmetric( pdB, d, pdSpectra + ( ( long ) r * d ), pdW ) < 0 )
+    {
+      iResult = -1;
+      break;
+    }
+
+    // V = V * W
+    for( i = 0; i < d; i++ )
+    {
+      for( j = 0; j < d; j++ )
+      {
+        double dSum = 0.0;
+
+        for( l = 0; l < d; l++ )
+        {
+          dSum += pdV[ ( i * d ) + l ] * pdW[ ( l * d ) + j ];
+        }
+
+        pdT[ ( i * d ) + j ] = dSum;
+      }
+    }
+
+    for( i = 0; i < ( d * d ); i++ )
+    {
+      pdV[i] = pdT[i];
+    }
+
+    // coordinates of frame r relative to the window mean in the local basis
+    for( j = 0; j < iComponents; j++ )
+    {
+      double dSum = 0.0;
+
+      for( i = 0; i < d; i++ )
+      {
+        dSum += ( pdData[ ( ( long ) r * d ) + i ] - pdShift[i] - pdMean[i] ) * pdV[ ( i * d ) + j ];
+      }
+
+      pdProjected[ ( ( long ) r * iComponents ) + j ] = dSum;
+    }
+
+    iResult++;
+  }
+
+  free( pdWork );
+
+  return iResult;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100
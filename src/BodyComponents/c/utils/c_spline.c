@@ -0,0 +1,164 @@
+/*!
+ *
+ * \file        c_spline.c
+ * \author      Bjoern Rennhak <bjoern@rennhak.com>
+ * \brief       Natural cubic spline, fitted once, analytic derivatives at the knots for many signals.
+ * \note        {
+ *                Copyright (c) 2010-2011, Bjoern Rennhak
+ *                All rights reserved, see COPYRIGHT file for more details.
+ *
+ *                o C code version used here is the ANSI C99 standard
+ *                o Code style used here is a modified Allman version
+ *                o Variable naming convention used here is a variation of the hungarian notation where appropriate
+ *                o Explicit shortform coding which the compiler also accepts has been avoided for the sake of clarity and unambiguity
+ *                o Documentation tool here used is DoxyGen ( http://www.doxygen.org ) which is licenced under GPLv2
+ *                    - Documenting style used here is the QT Style
+ *                    - http://www.stack.nl/~dimitri/doxygen/docblocks.html
+ *                    - http://www.stack.nl/~dimitri/doxygen/commands.html
+ *                o A changelog can be found in the CHANGELOG file if appropriate
+ *                o Formatting is optimized for the VIM Text editor
+ *                    - configuration is done automatically by reading the details at the end of each file
+ *                    - tabs are converted to whitespaces
+ *                    - special folding is provided by explicit formatting tags
+ *                o Usage of Exuberant CTags, CScope, Lint and Valgrind is supported and encouraged
+ * }
+ *
+ */
+#include <stdlib.h>
+#include "c_spline.h"                 ///< Include own header
+
+
+/*! \fn       int c_spline_derivatives( const double *pdX, int iFrames, const double *pdY, int iSignals, double *pdD1, double *pdD2, double *pdD3 ) // {{{
+ *  \brief    Fits a natural cubic spline (same as GSL "cspline") through each signal and returns
+ *            its first, second and third derivative at every knot.
+ *
+ *            The second derivatives M_i solve the tridiagonal system
+ *
+ *              h_{i-1} M_{i-1} + 2 ( h_{i-1} + h_i ) M_i + h_i M_{i+1} = 6 ( d_i - d_{i-1} ),  M_0 = M_{n-1} = 0
+ *
+ *            with h_i = x_{i+1} - x_i and d_i = ( y_{i+1} - y_i ) / h_i. The matrix only depends on
+ *            the frame axis, so it is factorized once and reused for all signals. Then
+ *
+ *              S'(x_i)   = d_i - h_i ( 2 M_i + M_{i+1} ) / 6           ( last knot: d_{n-2} + h ( M_{n-2} + 2 M_{n-1} ) / 6 )
+ *              S''(x_i)  = M_i
+ *              S'''(x_i) = ( M_{i+1} - M_i ) / h_i                       ( last knot: from the last interval )
+ *
+ *  \param    pdX         Frame axis, iFrames strictly increasing values
+ *  \param    iFrames     Number of frames n
+ *  \param    pdY         Signals, iSignals x iFrames, one signal after the other
+ *  \param    iSignals    Number of signals
+ *  \param    pdD1        Output, first derivatives, same layout as pdY
+ *  \param    pdD2        Output, second derivatives, same layout as pdY
+ *  \param    pdD3        Output, third derivatives, same layout as pdY
+ *
+ *  \return   Number of values written to each output ( iSignals * iFrames ), -1 on invalid arguments
+ */
+int c_spline_derivatives( const double *pdX, int iFrames, const double *pdY, int iSignals, double *pdD1, double *pdD2, double *pdD3 )
+{
+  int     i       = 0;
+  int     s       = 0;
+  int     n       = iFrames;
+  double *pdH     = NULL;
+  double *pdUpper = NULL;
+  double *pdPivot = NULL;
+
+  if( ( iFrames < 1 ) || ( iSignals < 1 ) )
+  {
+    return -1;
+  }
+
+  for( i = 0; i < ( n - 1 ); i++ )
+  {
+    if( !( pdX[ i + 1 ] > pdX[i] ) )
+    {
+      return -1;
+    }
+  }
+
+  if( n == 1 )
+  {
+    for( s = 0; s < iSignals; s++ )
+    {
+      pdD1[s] = 0.0;
+      pdD2[s] = 0.0;
+      pdD3[s] = 0.0;
+    }
+
+    return iSignals;
+  }
+
+  pdH     = ( double * ) malloc( sizeof( double ) * n );
+  pdUpper = ( double * ) malloc( sizeof( double ) * n );
+  pdPivot = ( double * ) malloc( sizeof( double ) * n );
+
+  if( ( pdH == NULL ) || ( pdUpper == NULL ) || ( pdPivot == NULL ) )
+  {
+    free( pdH );
+    free( pdUpper );
+    free( pdPivot );
+    return -1;
+  }
+
+  for( i = 0; i < ( n - 1 ); i++ )
+  {
+    pdH[i] = pdX[ i + 1 ] - pdX[i];
+  }
+
+  // Thomas algorithm, forward elimination of the (shared) matrix for the interior knots 1..n-2
+  for( i = 1; i < ( n - 1 ); i++ )
+  {
+    double dLower = ( i > 1 ) ? ( pdH[ i - 1 ] ) : ( 0.0 );
+
+    pdPivot[i] = 2.0 * ( pdH[ i - 1 ] + pdH[i] ) - dLower * ( ( i > 1 ) ? ( pdUpper[ i - 1 ] ) : ( 0.0 ) );
+    pdUpper[i] = pdH[i] / pdPivot[i];
+  }
+
+  for( s = 0; s < iSignals; s++ )
+  {
+    const double *pdS   = pdY  + ( ( long ) s * n );
+    double       *pdM   = pdD2 + ( ( long ) s * n );
+    double       *pdV   = pdD1 + ( ( long ) s * n );
+    double       *pdJ   = pdD3 + ( ( long ) s * n );
+
+    // forward substitution of the right hand side, M_i holds the intermediate values
+    pdM[0]       = 0.0;
+    pdM[ n - 1 ] = 0.0;
+
+    for( i = 1; i < ( n - 1 ); i++ )
+    {
+      double dRhs = 6.0 * ( ( pdS[ i + 1 ] - pdS[i] ) / pdH[i] - ( pdS[i] - pdS[ i - 1 ] ) / pdH[ i - 1 ] );
+
+      if( i > 1 )
+      {
+        dRhs -= pdH[ i - 1 ] * pdM[ i - 1 ];
+      }
+
+      pdM[i] = dRhs / pdPivot[i];
+    }
+
+    // back substitution
+    for( i = ( n - 3 ); i >= 1; i-- )
+    {
+      pdM[i] -= pdUpper[i] * pdM[ i + 1 ];
+    }
+
+    for( i = 0; i < ( n - 1 ); i++ )
+    {
+      double dSlope = ( pdS[ i + 1 ] - pdS[i] ) / pdH[i];
+
+      pdV[i] = dSlope - pdH[i] * ( 2.0 * pdM[i] + pdM[ i + 1 ] ) / 6.0;
+      pdJ[i] = ( pdM[ i + 1 ] - pdM[i] ) / pdH[i];
+    }
+
+    pdV[ n - 1 ] = ( pdS[ n - 1 ] - pdS[ n - 2 ] ) / pdH[ n - 2 ] + pdH[ n - 2 ] * ( pdM[ n - 2 ] + 2.0 * pdM[ n - 1 ] ) / 6.0;
+    pdJ[ n - 1 ] = pdJ[ n - 2 ];
+  }
+
+  free( pdH );
+  free( pdUpper );
+  free( pdPivot );
+
+  return n * iSignals;
+} // }}}
+
+// vim:ts=2:tw=100:wm=100